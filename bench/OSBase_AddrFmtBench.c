@@ -0,0 +1,277 @@
+/**
+ * @file
+ * OSBase_AddrFmtBench.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Address formatting benchmark.
+ * Checks that the OSBase_AddrFmt output is byte-identical to inet_ntop and
+ * snprintf, then measures both. Not built by default:
+ *   make osbase_addrfmt_bench && ./osbase_addrfmt_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "OSBase_AddrFmt.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COMMON
+////////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_ADDRS    4096    /**< Addresses per family. */
+#define BENCH_MAC_LEN  6       /**< Ethernet address length. */
+#define BENCH_ITERS    1000000 /**< Default conversions per measure. */
+
+/**
+ * Random generator state (the run is reproducible).
+ */
+static unsigned int benchSeed = 1;
+
+/**
+ * Used to avoid the conversions to be optimized out.
+ */
+static volatile int benchSink = 0;
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a random byte.
+ * @return random byte.
+ */
+static unsigned char benchRand()
+{
+    benchSeed = benchSeed * 1103515245 + 12345;
+    return (unsigned char)(benchSeed >> 16);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to fill an IPv6 address the way they show up in routing tables:
+ * words are zero (runs to compress), small or random, and some addresses
+ * are IPv4 compatible or mapped.
+ * @param addr [out] address.
+ */
+static void benchRandIPv6(unsigned char *addr)
+{
+    int i = 0; // Current word.
+
+    for(i=0 ; i<8 ; i++) {
+        switch(benchRand() % 4) {
+        case 0:
+        case 1:
+            addr[2*i] = addr[2*i+1] = 0;
+            break;
+        case 2:
+            addr[2*i] = 0;
+            addr[2*i+1] = benchRand();
+            break;
+        default:
+            addr[2*i] = benchRand();
+            addr[2*i+1] = benchRand();
+        }
+    }
+    if(benchRand() % 16 == 0) {
+        memset(addr, 0, 10);
+        addr[10] = addr[11] = (benchRand() & 1) ? 0xFF : 0;
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get the current time.
+ * @return time in nanoseconds.
+ */
+static double benchNow()
+{
+    struct timespec ts; // Current time.
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Reference L2 address conversion (the snprintf loop nlAddr_n2a used).
+ * @param addr [in] address.
+ * @param alen [in] address length.
+ * @param buf [out] converted address.
+ * @param blen [in] converted address maximum length.
+ */
+static void benchMACRef(const unsigned char *addr, int alen,
+                        char *buf, int blen)
+{
+    int i = 0; // Current byte.
+    int l = 0; // Current length.
+
+    buf[0] = '\0';
+    for(i=0 ; i<alen && l<blen ; i++) {
+        l += snprintf(buf + l, blen - l, (i == 0) ? "%02x" : ":%02x",
+                      addr[i]);
+    }
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CHECK
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+/**
+ * Used to compare the conversions against libc.
+ * @param v4 [in] IPv4 addresses.
+ * @param v6 [in] IPv6 addresses.
+ * @param mac [in] L2 addresses.
+ * @return number of mismatches.
+ */
+static int benchCheck(unsigned char (*v4)[4], unsigned char (*v6)[16],
+                      unsigned char (*mac)[BENCH_MAC_LEN])
+{
+    char ref[NL_FMT_IPV6_MAXLEN]; // libc output.
+    char out[NL_FMT_IPV6_MAXLEN]; // OSBase_AddrFmt output.
+    int  bad = 0;                 // Mismatches.
+    int  i   = 0;                 // Current address.
+    int  b   = 0;                 // Current buffer length.
+
+    for(i=0 ; i<BENCH_ADDRS ; i++) {
+        inet_ntop(AF_INET, v4[i], ref, sizeof(ref));
+        nlFmtIPv4(v4[i], out);
+        if(strcmp(ref, out) != 0) {
+            printf("IPv4 mismatch: %s != %s\n", out, ref);
+            bad++;
+        }
+
+        inet_ntop(AF_INET6, v6[i], ref, sizeof(ref));
+        nlFmtIPv6(v6[i], out);
+        if(strcmp(ref, out) != 0) {
+            printf("IPv6 mismatch: %s != %s\n", out, ref);
+            bad++;
+        }
+
+        // Every buffer length, to check the truncation.
+        for(b=1 ; b<=3*BENCH_MAC_LEN+1 ; b++) {
+            benchMACRef(mac[i], BENCH_MAC_LEN, ref, b);
+            nlFmtMAC(mac[i], BENCH_MAC_LEN, out, b);
+            if(strcmp(ref, out) != 0) {
+                printf("MAC mismatch (blen %d): %s != %s\n", b, out, ref);
+                bad++;
+            }
+        }
+    }
+    return bad;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MAIN
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    static unsigned char v4[BENCH_ADDRS][4];             // IPv4 addresses.
+    static unsigned char v6[BENCH_ADDRS][16];            // IPv6 addresses.
+    static unsigned char mac[BENCH_ADDRS][BENCH_MAC_LEN]; // L2 addresses.
+    char                 buf[NL_FMT_IPV6_MAXLEN];        // Output.
+    long                 iters = BENCH_ITERS;            // Conversions.
+    long                 n     = 0;                      // Current one.
+    int                  i     = 0;                      // Current byte.
+    double               t0    = 0;                      // Start time.
+    double               tRef  = 0;                      // libc time.
+    double               tFmt  = 0;                      // OSBase time.
+
+    if(argc > 1) {
+        iters = atol(argv[1]);
+    }
+
+    for(n=0 ; n<BENCH_ADDRS ; n++) {
+        for(i=0 ; i<4 ; i++) {
+            v4[n][i] = benchRand();
+        }
+        benchRandIPv6(v6[n]);
+        for(i=0 ; i<BENCH_MAC_LEN ; i++) {
+            mac[n][i] = benchRand();
+        }
+    }
+
+    if(benchCheck(v4, v6, mac) != 0) {
+        return 1;
+    }
+    printf("Output identical to libc for %d addresses per family.\n",
+           BENCH_ADDRS);
+    printf("%-6s %14s %14s %8s\n", "", "libc ns/op", "nlFmt ns/op",
+           "speedup");
+
+    // IPv4.
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        inet_ntop(AF_INET, v4[n % BENCH_ADDRS], buf, sizeof(buf));
+        benchSink += buf[0];
+    }
+    tRef = benchNow() - t0;
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchSink += nlFmtIPv4(v4[n % BENCH_ADDRS], buf);
+    }
+    tFmt = benchNow() - t0;
+    printf("%-6s %14.1f %14.1f %7.1fx\n", "IPv4", tRef / iters,
+           tFmt / iters, tRef / tFmt);
+
+    // IPv6.
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        inet_ntop(AF_INET6, v6[n % BENCH_ADDRS], buf, sizeof(buf));
+        benchSink += buf[0];
+    }
+    tRef = benchNow() - t0;
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchSink += nlFmtIPv6(v6[n % BENCH_ADDRS], buf);
+    }
+    tFmt = benchNow() - t0;
+    printf("%-6s %14.1f %14.1f %7.1fx\n", "IPv6", tRef / iters,
+           tFmt / iters, tRef / tFmt);
+
+    // MAC.
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchMACRef(mac[n % BENCH_ADDRS], BENCH_MAC_LEN, buf, 32);
+        benchSink += buf[0];
+    }
+    tRef = benchNow() - t0;
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchSink += nlFmtMAC(mac[n % BENCH_ADDRS], BENCH_MAC_LEN, buf, 32);
+    }
+    tFmt = benchNow() - t0;
+    printf("%-6s %14.1f %14.1f %7.1fx\n", "MAC", tRef / iters,
+           tFmt / iters, tRef / tFmt);
+
+    return 0;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
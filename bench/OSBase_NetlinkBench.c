@@ -0,0 +1,318 @@
+/**
+ * @file
+ * OSBase_NetlinkBench.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Netlink request multiplexer benchmark.
+ * Checks that the replies of requests pipelined on one socket with
+ * nlSubmit are routed by sequence number: single link requests (more
+ * than NL_MAX_INFLIGHT, one of them failing) are sent while a link dump
+ * runs and a route dump waits for it, and they are waited for out of
+ * order. Then it measures pipelined link requests against nlTalk.
+ * Not built by default:
+ *   make osbase_netlink_bench && ./osbase_netlink_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include "OSBase_Netlink.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COMMON
+////////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_REQS  (2 * NL_MAX_INFLIGHT + 3) /**< Pipelined link requests
+                                                 per check round. */
+#define BENCH_ITERS 2000 /**< Default rounds per measure. */
+#define BENCH_NOIF  0x7FFFFFF0 /**< Index of no interface. */
+
+/**
+ * Pipelined request and what its replies must be.
+ */
+struct benchReq {
+    struct {
+        struct nlmsghdr h;        // Netlink message header.
+        union {
+            struct ifinfomsg i;   // Link message.
+            struct rtmsg     r;   // Route message.
+        } m;
+    }                 req;        /**< Request message. */
+    struct nlRequest  r;          /**< Request handler. */
+    unsigned short    type;       /**< Type of the expected replies. */
+    int               index;      /**< Expected interface index (0=any). */
+    unsigned int      replies;    /**< Replies received. */
+    unsigned int      bad;        /**< Replies of another request. */
+};
+
+/**
+ * Used to avoid the requests to be optimized out.
+ */
+static volatile unsigned int benchSink = 0;
+
+//------------------------------------------------------------------------------
+/**
+ * Reply callback: every reply must carry the sequence number of the
+ * request it is delivered to and describe what that request asked for.
+ * @param h [in] received message header.
+ * @param arg [in] request (struct benchReq).
+ * @return NL_OK
+ */
+static int benchHandler(const struct nlmsghdr *h, void *arg)
+{
+    struct benchReq  *q = (struct benchReq*)arg;             // Request.
+    struct ifinfomsg *i = (struct ifinfomsg*)NLMSG_DATA(h);  // Link.
+
+    q->replies++;
+    if((h->nlmsg_seq != q->r.seq) || (h->nlmsg_type != q->type) ||
+       ((q->index != 0) && (i->ifi_index != q->index))) {
+        q->bad++;
+    }
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to fill a single link request (RTM_GETLINK by index).
+ * @param q [out] request.
+ * @param index [in] interface index.
+ */
+static void benchLinkReq(struct benchReq *q, int index)
+{
+    memset(q, 0, sizeof(*q));
+    q->req.h.nlmsg_len   = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    q->req.h.nlmsg_type  = RTM_GETLINK;
+    q->req.h.nlmsg_flags = NLM_F_REQUEST;
+    q->req.m.i.ifi_index = index;
+    q->type              = RTM_NEWLINK;
+    q->index             = index;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to fill a dump request of every link or every route.
+ * @param q [out] request.
+ * @param type [in] RTM_GETLINK | RTM_GETROUTE.
+ */
+static void benchDumpReq(struct benchReq *q, unsigned short type)
+{
+    memset(q, 0, sizeof(*q));
+    q->req.h.nlmsg_len   = NLMSG_LENGTH((type == RTM_GETLINK) ?
+                                        sizeof(struct ifinfomsg) :
+                                        sizeof(struct rtmsg));
+    q->req.h.nlmsg_type  = type;
+    q->req.h.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    q->type              = (type == RTM_GETLINK) ? RTM_NEWLINK : RTM_NEWROUTE;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get the current time.
+ * @return time in nanoseconds.
+ */
+static double benchNow()
+{
+    struct timespec ts; // Current time.
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CHECK
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+/**
+ * Used to check the multiplexer. The link dump is sent first, the route
+ * dump is queued behind it and the single requests go out meanwhile
+ * (the last one names no interface and must fail alone). Everything is
+ * waited for in reverse order.
+ * @param ctx [in] request context.
+ * @param idx [in] interface indexes.
+ * @param nIdx [in] number of interface indexes.
+ * @param nLinks [in] links of a dump done alone.
+ * @param nRoutes [in] routes of a dump done alone.
+ * @return number of mismatches.
+ */
+static int benchCheck(struct nlContext *ctx, const int *idx, int nIdx,
+                      unsigned int nLinks, unsigned int nRoutes)
+{
+    static struct benchReq q[BENCH_REQS + 2]; // Dumps and link requests.
+    int                    bad = 0;           // Mismatches.
+    int                    rc  = NL_OK;       // Wait result.
+    int                    i   = 0;           // Current request.
+
+    benchDumpReq(&q[0], RTM_GETLINK);
+    benchDumpReq(&q[1], RTM_GETROUTE);
+    for(i=0 ; i<BENCH_REQS ; i++) {
+        benchLinkReq(&q[i + 2], (i == BENCH_REQS - 1) ? BENCH_NOIF :
+                     idx[i % nIdx]);
+    }
+    for(i=0 ; i<BENCH_REQS + 2 ; i++) {
+        if(nlSubmit(ctx, &q[i].r, &q[i].req.h, benchHandler,
+                    &q[i]) != NL_OK) {
+            printf("Request %d not sent.\n", i);
+            return 1;
+        }
+        if((i == 1) && (q[1].r.seq != 0)) {
+            printf("Second dump sent while the first one runs.\n");
+            bad++;
+        }
+    }
+
+    for(i=BENCH_REQS + 1 ; i>=0 ; i--) {
+        rc = nlWait(ctx, &q[i].r);
+        if(q[i].bad != 0) {
+            printf("Request %d got %u replies of others.\n", i, q[i].bad);
+            bad++;
+        }
+        if(i == BENCH_REQS + 1) {
+            if((rc != NL_FAIL) || (q[i].r.err != ENODEV) ||
+               (q[i].replies != 0)) {
+                printf("Request of no interface did not fail alone.\n");
+                bad++;
+            }
+        } else if(rc != NL_OK) {
+            printf("Request %d failed.\n", i);
+            bad++;
+        } else if(((i == 0) && (q[i].replies != nLinks)) ||
+                  ((i == 1) && (q[i].replies != nRoutes)) ||
+                  ((i >= 2) && (q[i].replies != 1))) {
+            printf("Request %d got %u replies.\n", i, q[i].replies);
+            bad++;
+        }
+    }
+    return bad;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MAIN
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    static struct benchReq q[NL_MAX_INFLIGHT]; // Link requests.
+    static int             idx[NL_MAX_INFLIGHT]; // Interface indexes.
+    struct nlArena         arena;              // Links list.
+    struct nlContext       ctx;                // Netlink request context.
+    struct nlLinkInfo      nlLinkInfo;         // Filter.
+    struct nlLinkInfoList *list   = NULL;      // Links list.
+    struct nlLinkInfoList *curr   = NULL;      // Current link.
+    struct benchReq        d;                  // Dump done alone.
+    unsigned int           nLinks = 0;         // Links of a dump.
+    long                   iters  = BENCH_ITERS; // Rounds.
+    long                   n      = 0;         // Current one.
+    int                    nIdx   = 0;         // Interface indexes.
+    int                    i      = 0;         // Current request.
+    int                    bad    = 0;         // Mismatches.
+    double                 t0     = 0;         // Start time.
+    double                 tRef   = 0;         // nlTalk time.
+    double                 tNew   = 0;         // nlSubmit time.
+
+    if(argc > 1) {
+        iters = atol(argv[1]);
+    }
+
+    // Interfaces.
+    nlArenaInit(&arena);
+    nlCtxInit(&ctx);
+    ctx.arena   = &arena;
+    ctx.noStats = 1;
+    if((nlCreateDefaultLinkInfo(&nlLinkInfo) != NL_OK) ||
+       (nlGetLinks(&ctx, &list, &nlLinkInfo) != NL_OK)) {
+        printf("Could not get the links.\n");
+        bad = 1;
+        goto out;
+    }
+    for(curr = list ; curr != NULL ; curr = curr->next) {
+        if(nIdx < NL_MAX_INFLIGHT) {
+            idx[nIdx++] = curr->sptr->index;
+        }
+        nLinks++;
+    }
+    if(nIdx == 0) {
+        printf("No links.\n");
+        bad = 1;
+        goto out;
+    }
+
+    // Check (the dumps done alone tell how many replies to expect).
+    benchDumpReq(&d, RTM_GETROUTE);
+    if(nlTalk(&ctx, &d.req.h, benchHandler, &d) != NL_OK) {
+        printf("Could not dump the routes.\n");
+        bad = 1;
+        goto out;
+    }
+    bad = benchCheck(&ctx, idx, nIdx, nLinks, d.replies);
+    if(bad != 0) {
+        goto out;
+    }
+    printf("Replies routed by sequence number for %d pipelined link "
+           "requests and 2 dumps.\n", BENCH_REQS);
+    printf("%-10s %14s %14s %8s\n", "", "nlTalk ns/op", "nlSubmit ns/op",
+           "speedup");
+
+    // One request at a time.
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        for(i=0 ; i<nIdx ; i++) {
+            benchLinkReq(&q[i], idx[i]);
+            benchSink += nlTalk(&ctx, &q[i].req.h, benchHandler, &q[i]);
+        }
+    }
+    tRef = benchNow() - t0;
+
+    // Every interface requested before the first reply is read.
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        for(i=0 ; i<nIdx ; i++) {
+            benchLinkReq(&q[i], idx[i]);
+            benchSink += nlSubmit(&ctx, &q[i].r, &q[i].req.h, benchHandler,
+                                  &q[i]);
+        }
+        for(i=0 ; i<nIdx ; i++) {
+            benchSink += nlWait(&ctx, &q[i].r);
+        }
+    }
+    tNew = benchNow() - t0;
+    printf("%-10s %14.1f %14.1f %7.1fx\n", "GETLINK",
+           tRef / (iters * nIdx), tNew / (iters * nIdx), tRef / tNew);
+
+ out:
+    nlCtxRelease(&ctx);
+    nlArenaRelease(&arena);
+    return (bad != 0);
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,336 @@
+/**
+ * @file
+ * OSBase_ParseBench.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Text parsing benchmark.
+ * Checks that OSBase_Parse accepts the same address literals as inet_pton,
+ * that nhParseInstanceId fills the same filter as the sscanf parse it
+ * replaces and that compact InstanceIDs round-trip, then measures them.
+ * Not built by default:
+ *   make osbase_parse_bench && ./osbase_parse_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "OSBase_Parse.h"
+#include "OSBase_NextHopIPRoute.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COMMON
+////////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_ADDRS 4096    /**< Literals per set. */
+#define BENCH_ITERS 1000000 /**< Default parses per measure. */
+
+/**
+ * InstanceID sscanf format the parser replaces.
+ */
+#define BENCH_IID_SCANF "%[^|]|%[^|]|%d|%d|%d|%d|%[^|]"
+
+/**
+ * Random generator state (the run is reproducible).
+ */
+static unsigned int benchSeed = 1;
+
+/**
+ * Used to avoid the parses to be optimized out.
+ */
+static volatile int benchSink = 0;
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a random number.
+ * @return random number (15 bits).
+ */
+static unsigned int benchRand()
+{
+    benchSeed = benchSeed * 1103515245 + 12345;
+    return (benchSeed >> 16) & 0x7FFF;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a random address literal: IPv4 or IPv6 (zero runs, IPv4
+ * tails) as inet_ntop writes them, or random text.
+ * @param buf [out] literal (NL_ADDRESS_MAXLEN bytes).
+ */
+static void benchRandAddr(char *buf)
+{
+    static const char chars[] = "0123456789abcdefABCDEF:.";
+    unsigned char     addr[16];  // Address.
+    int               i = 0;     // Current byte.
+    int               n = 0;     // Random text length.
+
+    for(i=0 ; i<16 ; i++) {
+        addr[i] = (benchRand() % 3) ? 0 : benchRand();
+    }
+    switch(benchRand() % 4) {
+    case 0:
+        inet_ntop(AF_INET, addr, buf, NL_ADDRESS_MAXLEN);
+        break;
+    case 1:
+    case 2:
+        inet_ntop(AF_INET6, addr, buf, NL_ADDRESS_MAXLEN);
+        break;
+    default:
+        n = benchRand() % 24;
+        for(i=0 ; i<n ; i++) {
+            buf[i] = chars[benchRand() % (sizeof(chars) - 1)];
+        }
+        buf[n] = '\0';
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Reference address parse (what nlGenRouteFilter and getAddrType did).
+ * @param s [in] literal.
+ * @param addr [out] address.
+ * @return AF_INET | AF_INET6 | AF_UNSPEC=invalid
+ */
+static int benchAddrRef(const char *s, unsigned char *addr)
+{
+    if(inet_pton(AF_INET, s, addr) == 1) {
+        return AF_INET;
+    }
+    if(inet_pton(AF_INET6, s, addr) == 1) {
+        return AF_INET6;
+    }
+    return AF_UNSPEC;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Reference InstanceID parse.
+ * @param iid [in] InstanceID.
+ * @param info [out] route filter.
+ */
+static void benchIIdRef(const char *iid, struct nlRouteInfo *info)
+{
+    char hostName[MAXHOSTNAMELEN]; // Not used.
+
+    sscanf(iid, BENCH_IID_SCANF, hostName, info->dstAddr, &(info->dstLen),
+           &(info->table), &(info->outputIf), &(info->scope), info->gw);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to check a compact InstanceID: the key must round-trip and the
+ * filter must hold the key fields.
+ * @param nHop [in] route.
+ * @param iid [out] compact InstanceID (NH_IID_LEN+1 bytes).
+ * @return 0=valid | 1=mismatch
+ */
+static int benchCompactCheck(const struct nextHopIP *nHop, char *iid)
+{
+    unsigned char      key[NH_IID_KEY_LEN]; // Route key.
+    unsigned char      dec[NH_IID_KEY_LEN]; // Decoded key.
+    unsigned char      addr[16];            // Filter address.
+    struct nlRouteInfo out;                 // OSBase_Parse filter.
+
+    if(nhNextHopKey(nHop, key) != NH_OK) {
+        return 1;
+    }
+    nhEncodeInstanceId(key, iid);
+    nlCreateDefaultRtInfo(&out);
+    if((strlen(iid) != NH_IID_LEN) || strchr(iid, '|') ||
+       (nhDecodeInstanceId(iid, dec) != NH_OK) ||
+       memcmp(key, dec, NH_IID_KEY_LEN) ||
+       (nhParseInstanceId(iid, &out) != NH_OK)) {
+        return 1;
+    }
+    if((out.family != key[0]) || (out.dstLen != key[1]) ||
+       (out.table != nHop->routeTable) ||
+       (out.outputIf != nHop->routeOutputIf) ||
+       (out.priority != nHop->routeMetric)) {
+        return 1;
+    }
+    if((out.dstAddr[0] != '\0') &&
+       ((nlParseAddr(out.dstAddr, strlen(out.dstAddr), addr) != key[0]) ||
+        memcmp(addr, key + 16, 16))) {
+        return 1;
+    }
+    if((out.gw[0] != '\0') &&
+       ((nlParseAddr(out.gw, strlen(out.gw), addr) != key[0]) ||
+        memcmp(addr, key + 32, 16))) {
+        return 1;
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get the current time.
+ * @return time in nanoseconds.
+ */
+static double benchNow()
+{
+    struct timespec ts; // Current time.
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MAIN
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    static char        addrs[BENCH_ADDRS][NL_ADDRESS_MAXLEN]; // Literals.
+    static char        iids[BENCH_ADDRS][64];                 // InstanceIDs.
+    static char        ciids[BENCH_ADDRS][NH_IID_LEN+1];      // Compact ones.
+    struct nextHopIP   nHop;                   // Route of a compact one.
+    struct nlRouteInfo ref;                    // Reference filter.
+    struct nlRouteInfo out;                    // OSBase_Parse filter.
+    unsigned char      a[16];                  // Reference address.
+    unsigned char      b[16];                  // OSBase_Parse address.
+    long               iters = BENCH_ITERS;    // Parses.
+    long               n     = 0;              // Current one.
+    int                fa    = 0;              // Reference family.
+    int                fb    = 0;              // OSBase_Parse family.
+    int                bad   = 0;              // Mismatches.
+    double             t0    = 0;              // Start time.
+    double             tRef  = 0;              // libc time.
+    double             tNew  = 0;              // OSBase time.
+
+    if(argc > 1) {
+        iters = atol(argv[1]);
+    }
+
+    // Check.
+    for(n=0 ; n<BENCH_ADDRS ; n++) {
+        benchRandAddr(addrs[n]);
+        fa = benchAddrRef(addrs[n], a);
+        fb = nlParseAddr(addrs[n], strlen(addrs[n]), b);
+        if((fa != fb) ||
+           ((fa != AF_UNSPEC) && memcmp(a, b, (fa == AF_INET) ? 4 : 16))) {
+            printf("Address mismatch: %s\n", addrs[n]);
+            bad++;
+        }
+
+        // InstanceIDs of valid routes (the sscanf parse stops at an empty
+        // destination, so every one has a destination).
+        if(fa == AF_UNSPEC) {
+            snprintf(addrs[n], NL_ADDRESS_MAXLEN, "10.%u.%u.0",
+                     benchRand() % 256, benchRand() % 256);
+        }
+        snprintf(iids[n], sizeof(iids[n]), INSTANCEID_FORMAT, "host",
+                 addrs[n], (int)(benchRand() % 129), 254,
+                 (int)(benchRand() % 16), 0, (benchRand() % 2) ? "" :
+                 (strchr(addrs[n], ':') ? "fe80::1" : "192.168.0.1"));
+        nlCreateDefaultRtInfo(&ref);
+        nlCreateDefaultRtInfo(&out);
+        benchIIdRef(iids[n], &ref);
+        if((nhParseInstanceId(iids[n], &out) != NH_OK) ||
+           strcmp(ref.dstAddr, out.dstAddr) || strcmp(ref.gw, out.gw) ||
+           (ref.dstLen != out.dstLen) || (ref.table != out.table) ||
+           (ref.outputIf != out.outputIf) || (ref.scope != out.scope)) {
+            printf("InstanceID mismatch: %s\n", iids[n]);
+            bad++;
+        }
+
+        // Same route as compact InstanceID (valid prefix length, random
+        // metric).
+        memset(&nHop, 0, sizeof(nHop));
+        strcpy(nHop.dstAddress, ref.dstAddr);
+        strcpy(nHop.routeGateway, ref.gw);
+        if(strchr(ref.dstAddr, ':')) {
+            nHop.addressType  = NH_AT_IPV6;
+            nHop.prefixLength = ref.dstLen;
+        } else {
+            nHop.addressType = NH_AT_IPV4;
+            snprintf(nHop.dstMask, sizeof(nHop.dstMask), "%d",
+                     ref.dstLen % 33);
+        }
+        nHop.routeTable    = ref.table;
+        nHop.routeOutputIf = ref.outputIf;
+        nHop.routeMetric   = benchRand();
+        if(benchCompactCheck(&nHop, ciids[n]) != 0) {
+            printf("Compact InstanceID mismatch: %s\n", iids[n]);
+            bad++;
+        }
+    }
+    if(bad != 0) {
+        return 1;
+    }
+    printf("Same results as libc for %d literals and InstanceIDs.\n",
+           BENCH_ADDRS);
+    printf("Compact InstanceIDs round-trip.\n");
+    printf("%-10s %14s %14s %8s\n", "", "libc ns/op", "nlParse ns/op",
+           "speedup");
+
+    // Address literals.
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchSink += benchAddrRef(addrs[n % BENCH_ADDRS], a);
+    }
+    tRef = benchNow() - t0;
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchSink += nlParseAddr(addrs[n % BENCH_ADDRS],
+                                 strlen(addrs[n % BENCH_ADDRS]), b);
+    }
+    tNew = benchNow() - t0;
+    printf("%-10s %14.1f %14.1f %7.1fx\n", "Address", tRef / iters,
+           tNew / iters, tRef / tNew);
+
+    // InstanceIDs (the sscanf parse is followed by the address parses of
+    // the filter; nhParseInstanceId validates them itself).
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchIIdRef(iids[n % BENCH_ADDRS], &ref);
+        benchSink += benchAddrRef(ref.dstAddr, a);
+    }
+    tRef = benchNow() - t0;
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchSink += nhParseInstanceId(iids[n % BENCH_ADDRS], &out);
+    }
+    tNew = benchNow() - t0;
+    printf("%-10s %14.1f %14.1f %7.1fx\n", "InstanceID", tRef / iters,
+           tNew / iters, tRef / tNew);
+
+    // Compact InstanceIDs (against the legacy sscanf parse of the same
+    // routes).
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        benchSink += nhParseInstanceId(ciids[n % BENCH_ADDRS], &out);
+    }
+    tNew = benchNow() - t0;
+    printf("%-10s %14.1f %14.1f %7.1fx\n", "Compact", tRef / iters,
+           tNew / iters, tRef / tNew);
+
+    return 0;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
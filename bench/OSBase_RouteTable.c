@@ -0,0 +1,560 @@
+/**
+ * @file
+ * OSBase_RouteTable.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Columnar route snapshot (experiment, bench/ only).
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+// NL_RTT_NO_AVX2 and NL_RTT_NO_SSE2 force the narrower kernels.
+#if defined(__AVX2__) && !defined(NL_RTT_NO_AVX2)
+#include <immintrin.h>
+#define NL_RTT_AVX2
+#elif defined(__SSE2__) && !defined(NL_RTT_NO_SSE2)
+#include <emmintrin.h>
+#define NL_RTT_SSE2
+#endif
+
+#include "OSBase_Common.h"
+#include "OSBase_RouteTable.h"
+#include "OSBase_Parse.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SCAN KERNELS
+////////////////////////////////////////////////////////////////////////////////
+// Every kernel clears the mask byte (0xFF=candidate, 0x00=rejected) of the
+// rows that fail its predicate. The columns and the mask are padded to a
+// multiple of NL_RTT_ROW_ALIGN rows, so the loops have no tail.
+
+//------------------------------------------------------------------------------
+/**
+ * Rows where col == val.
+ * @param col [in] 8 bits column.
+ * @param val [in] value.
+ * @param m [in/out] rows mask.
+ * @param size [in] padded number of rows.
+ */
+static void nlRttEq8(const unsigned char *col, unsigned char val,
+                     unsigned char *m, unsigned int size)
+{
+    unsigned int i = 0; // Current row.
+
+#if defined(NL_RTT_AVX2)
+    const __m256i v = _mm256_set1_epi8((char)val);
+    for( ; i < size ; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(col + i));
+        __m256i r = _mm256_loadu_si256((const __m256i*)(m + i));
+        r = _mm256_and_si256(r, _mm256_cmpeq_epi8(c, v));
+        _mm256_storeu_si256((__m256i*)(m + i), r);
+    }
+#elif defined(NL_RTT_SSE2)
+    const __m128i v = _mm_set1_epi8((char)val);
+    for( ; i < size ; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(col + i));
+        __m128i r = _mm_loadu_si128((const __m128i*)(m + i));
+        r = _mm_and_si128(r, _mm_cmpeq_epi8(c, v));
+        _mm_storeu_si128((__m128i*)(m + i), r);
+    }
+#else
+    for( ; i < size ; i++) {
+        m[i] &= (col[i] == val) ? 0xFF : 0x00;
+    }
+#endif
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Rows where col >= val (unsigned).
+ * @param col [in] 8 bits column.
+ * @param val [in] value.
+ * @param m [in/out] rows mask.
+ * @param size [in] padded number of rows.
+ */
+static void nlRttGe8(const unsigned char *col, unsigned char val,
+                     unsigned char *m, unsigned int size)
+{
+    unsigned int i = 0; // Current row.
+
+    // max(col, val) == col <=> col >= val.
+#if defined(NL_RTT_AVX2)
+    const __m256i v = _mm256_set1_epi8((char)val);
+    for( ; i < size ; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(col + i));
+        __m256i r = _mm256_loadu_si256((const __m256i*)(m + i));
+        r = _mm256_and_si256(r, _mm256_cmpeq_epi8(_mm256_max_epu8(c, v), c));
+        _mm256_storeu_si256((__m256i*)(m + i), r);
+    }
+#elif defined(NL_RTT_SSE2)
+    const __m128i v = _mm_set1_epi8((char)val);
+    for( ; i < size ; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(col + i));
+        __m128i r = _mm_loadu_si128((const __m128i*)(m + i));
+        r = _mm_and_si128(r, _mm_cmpeq_epi8(_mm_max_epu8(c, v), c));
+        _mm_storeu_si128((__m128i*)(m + i), r);
+    }
+#else
+    for( ; i < size ; i++) {
+        m[i] &= (col[i] >= val) ? 0xFF : 0x00;
+    }
+#endif
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Rows where col == val.
+ * @param col [in] 32 bits column.
+ * @param val [in] value.
+ * @param m [in/out] rows mask.
+ * @param size [in] padded number of rows.
+ */
+static void nlRttEq32(const uint32_t *col, uint32_t val,
+                      unsigned char *m, unsigned int size)
+{
+    unsigned int i = 0; // Current row.
+
+    // The 32 bits compare results (0 or -1) are narrowed to bytes with
+    // signed saturation, which keeps 0 and -1.
+#if defined(NL_RTT_AVX2)
+    const __m256i v    = _mm256_set1_epi32((int)val);
+    const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for( ; i < size ; i += 32) {
+        __m256i a = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((const __m256i*)(col + i)), v);
+        __m256i b = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((const __m256i*)(col + i + 8)), v);
+        __m256i c = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((const __m256i*)(col + i + 16)), v);
+        __m256i d = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((const __m256i*)(col + i + 24)), v);
+        // The packs work inside each 128 bits lane, the permutation puts
+        // the rows back in order.
+        __m256i p = _mm256_packs_epi16(_mm256_packs_epi32(a, b),
+                                       _mm256_packs_epi32(c, d));
+        __m256i r = _mm256_loadu_si256((const __m256i*)(m + i));
+        p = _mm256_permutevar8x32_epi32(p, perm);
+        _mm256_storeu_si256((__m256i*)(m + i), _mm256_and_si256(r, p));
+    }
+#elif defined(NL_RTT_SSE2)
+    const __m128i v = _mm_set1_epi32((int)val);
+    for( ; i < size ; i += 16) {
+        __m128i a = _mm_cmpeq_epi32(
+            _mm_loadu_si128((const __m128i*)(col + i)), v);
+        __m128i b = _mm_cmpeq_epi32(
+            _mm_loadu_si128((const __m128i*)(col + i + 4)), v);
+        __m128i c = _mm_cmpeq_epi32(
+            _mm_loadu_si128((const __m128i*)(col + i + 8)), v);
+        __m128i d = _mm_cmpeq_epi32(
+            _mm_loadu_si128((const __m128i*)(col + i + 12)), v);
+        __m128i p = _mm_packs_epi16(_mm_packs_epi32(a, b),
+                                    _mm_packs_epi32(c, d));
+        __m128i r = _mm_loadu_si128((const __m128i*)(m + i));
+        _mm_storeu_si128((__m128i*)(m + i), _mm_and_si128(r, p));
+    }
+#else
+    for( ; i < size ; i++) {
+        m[i] &= (col[i] == val) ? 0xFF : 0x00;
+    }
+#endif
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Rows where (addr & mask) == prefix.
+ * @param col [in] 16 bytes addresses column.
+ * @param prefix [in] prefix (host bits cleared).
+ * @param mask [in] prefix mask.
+ * @param m [in/out] rows mask.
+ * @param size [in] padded number of rows.
+ */
+static void nlRttPrefix(const unsigned char (*col)[16],
+                        const unsigned char *prefix,
+                        const unsigned char *mask,
+                        unsigned char *m, unsigned int size)
+{
+    unsigned int i = 0; // Current row.
+
+#if defined(NL_RTT_AVX2)
+    // Two rows per vector.
+    const __m256i p = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*)prefix));
+    const __m256i k = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*)mask));
+    for( ; i < size ; i += 2) {
+        __m256i  a    = _mm256_loadu_si256((const __m256i*)col[i]);
+        uint32_t bits = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_and_si256(a, k), p));
+        if((bits & 0x0000FFFF) != 0x0000FFFF) {
+            m[i] = 0x00;
+        }
+        if((bits & 0xFFFF0000) != 0xFFFF0000) {
+            m[i+1] = 0x00;
+        }
+    }
+#elif defined(NL_RTT_SSE2)
+    const __m128i p = _mm_loadu_si128((const __m128i*)prefix);
+    const __m128i k = _mm_loadu_si128((const __m128i*)mask);
+    for( ; i < size ; i++) {
+        __m128i a = _mm_loadu_si128((const __m128i*)col[i]);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(a, k), p)) !=
+           0xFFFF) {
+            m[i] = 0x00;
+        }
+    }
+#else
+    unsigned int j = 0; // Current byte.
+
+    for( ; i < size ; i++) {
+        for(j = 0 ; j < 16 ; j++) {
+            if((col[i][j] & mask[j]) != prefix[j]) {
+                m[i] = 0x00;
+                break;
+            }
+        }
+    }
+#endif
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Writes the indexes of the selected rows.
+ * @param m [in] rows mask.
+ * @param size [in] padded number of rows.
+ * @param sel [out] selected rows (NULL to only count them).
+ * @return number of selected rows.
+ */
+static unsigned int nlRttCompact(const unsigned char *m, unsigned int size,
+                                 unsigned int *sel)
+{
+    unsigned int i = 0; // Current row.
+    unsigned int n = 0; // Selected rows.
+
+#if defined(NL_RTT_AVX2) || defined(NL_RTT_SSE2)
+    // Whole blocks of rejected rows are skipped.
+    for( ; i < size ; i += 16) {
+        unsigned int bits = (unsigned int)_mm_movemask_epi8(
+            _mm_loadu_si128((const __m128i*)(m + i)));
+        if(sel == NULL) {
+            n += __builtin_popcount(bits);
+            continue;
+        }
+        while(bits != 0) {
+            sel[n++] = i + __builtin_ctz(bits);
+            bits &= bits - 1;
+        }
+    }
+#else
+    for( ; i < size ; i++) {
+        if(m[i] != 0x00) {
+            if(sel != NULL) {
+                sel[n] = i;
+            }
+            n++;
+        }
+    }
+#endif
+
+    return n;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Builds the mask of the rows that match a filter.
+ * @param arena [in] request arena.
+ * @param tbl [in] route table.
+ * @param flt [in] filter.
+ * @return rows mask | NULL=fail
+ */
+static unsigned char* nlRttMask(struct nlArena *arena,
+                                const struct nlRouteTable *tbl,
+                                const struct nlRouteTableFilter *flt)
+{
+    unsigned char *m = NULL;  // Rows mask.
+    unsigned char  mask[16];  // Prefix mask.
+    unsigned int   i  = 0;    // Current byte.
+
+    m = nlArenaAlloc(arena, tbl->size);
+    if(m == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for \'m\'."));
+        return NULL;
+    }
+    // The padding rows stay rejected.
+    memset(m, 0xFF, tbl->count);
+
+    // Cheaper predicates first, the prefix test is the last one.
+    if(flt->flags & NL_RTT_F_FAMILY) {
+        nlRttEq8(tbl->family, flt->family, m, tbl->size);
+    }
+    if(flt->flags & NL_RTT_F_PROTOCOL) {
+        nlRttEq8(tbl->protocol, flt->protocol, m, tbl->size);
+    }
+    if(flt->flags & NL_RTT_F_SCOPE) {
+        nlRttEq8(tbl->scope, flt->scope, m, tbl->size);
+    }
+    if(flt->flags & NL_RTT_F_TABLE) {
+        nlRttEq32(tbl->table, flt->table, m, tbl->size);
+    }
+    if(flt->flags & NL_RTT_F_OIF) {
+        nlRttEq32(tbl->outputIf, flt->outputIf, m, tbl->size);
+    }
+    if(flt->flags & NL_RTT_F_PREFIX) {
+        // A route is within the prefix when it is at least as long and
+        // its destination starts with the prefix bits.
+        nlRttGe8(tbl->dstLen, flt->prefixLen, m, tbl->size);
+        memset(mask, 0, sizeof(mask));
+        for(i = 0 ; i < flt->prefixLen / 8 ; i++) {
+            mask[i] = 0xFF;
+        }
+        if(flt->prefixLen % 8) {
+            mask[i] = (unsigned char)(0xFF << (8 - (flt->prefixLen % 8)));
+        }
+        nlRttPrefix((const unsigned char (*)[16])tbl->dst, flt->prefix, mask,
+                    m, tbl->size);
+    }
+
+    return m;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ROUTE TABLE
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+int nlRouteTableBuild(struct nlArena *arena,
+                      struct nlRouteList *nlRtList,
+                      struct nlRouteTable *tbl)
+{
+    _OSBASE_TRACE(3, ("--- nlRouteTableBuild() called"));
+
+    struct nlRouteList *curr  = NULL;  // Current list entry.
+    struct nlRoute     *route = NULL;  // Current route.
+    unsigned int        i     = 0;     // Current row.
+    int                 rc    = NL_OK; // Result handler.
+
+    // Check received parameters.
+    if((arena == NULL) || (tbl == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+    memset(tbl, 0, sizeof(*tbl));
+
+    // Count routes.
+    for(curr = nlRtList ; curr != NULL ; curr = curr->next) {
+        if(curr->sptr != NULL) {
+            tbl->count++;
+        }
+    }
+    if(tbl->count == 0) {
+        goto out;
+    }
+    tbl->size = (tbl->count + NL_RTT_ROW_ALIGN - 1) &
+        ~(NL_RTT_ROW_ALIGN - 1);
+
+    // Alloc columns (zeroed, so are the padding rows).
+    tbl->family   = nlArenaAlloc(arena, tbl->size);
+    tbl->dstLen   = nlArenaAlloc(arena, tbl->size);
+    tbl->protocol = nlArenaAlloc(arena, tbl->size);
+    tbl->scope    = nlArenaAlloc(arena, tbl->size);
+    tbl->table    = nlArenaAlloc(arena, tbl->size * sizeof(*tbl->table));
+    tbl->outputIf = nlArenaAlloc(arena, tbl->size * sizeof(*tbl->outputIf));
+    tbl->dst      = nlArenaAlloc(arena, tbl->size * sizeof(*tbl->dst));
+    tbl->gw       = nlArenaAlloc(arena, tbl->size * sizeof(*tbl->gw));
+    tbl->route    = nlArenaAlloc(arena, tbl->size * sizeof(*tbl->route));
+    if((tbl->family == NULL) || (tbl->dstLen == NULL) ||
+       (tbl->protocol == NULL) || (tbl->scope == NULL) ||
+       (tbl->table == NULL) || (tbl->outputIf == NULL) ||
+       (tbl->dst == NULL) || (tbl->gw == NULL) || (tbl->route == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc route table columns."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Fill rows.
+    for(curr = nlRtList ; curr != NULL ; curr = curr->next) {
+        route = curr->sptr;
+        if(route == NULL) {
+            continue;
+        }
+        tbl->family[i]   = route->family;
+        tbl->dstLen[i]   = route->dstLen;
+        tbl->protocol[i] = route->protocol;
+        tbl->scope[i]    = route->scope;
+        tbl->table[i]    = route->table;
+        tbl->outputIf[i] = route->outputIf;
+        tbl->route[i]    = route;
+        // Addresses the route has not got (the destination of the default
+        // route) are zeroed in the record too.
+        memcpy(tbl->dst[i], route->dstAddr, sizeof(tbl->dst[i]));
+        memcpy(tbl->gw[i], route->gw, sizeof(tbl->gw[i]));
+        i++;
+    }
+
+ out:
+    if((rc != NL_OK) && (tbl != NULL)) {
+        memset(tbl, 0, sizeof(*tbl));
+    }
+
+    _OSBASE_TRACE(3, ("--- nlRouteTableBuild() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlRouteTableSetPrefix(struct nlRouteTableFilter *flt,
+                          const char *addr, int len)
+{
+    _OSBASE_TRACE(3, ("--- nlRouteTableSetPrefix() called"));
+
+    int          family = AF_UNSPEC; // Prefix family.
+    unsigned int i      = 0;         // Current byte.
+    int          rc     = NL_OK;     // Result handler.
+
+    // Check received parameters.
+    if((flt == NULL) || (addr == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Parse prefix.
+    memset(flt->prefix, 0, sizeof(flt->prefix));
+    family = nlParseAddr(addr, strlen(addr), flt->prefix);
+    if((family == AF_UNSPEC) || (len < 0) ||
+       (len > ((family == AF_INET) ? 32 : 128))) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid prefix %s/%d.", addr, len));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Clear host bits.
+    for(i = len / 8 ; i < sizeof(flt->prefix) ; i++) {
+        if((i == (unsigned int)(len / 8)) && (len % 8)) {
+            flt->prefix[i] &= (unsigned char)(0xFF << (8 - (len % 8)));
+        } else {
+            flt->prefix[i] = 0;
+        }
+    }
+
+    flt->family    = (unsigned char)family;
+    flt->prefixLen = (unsigned char)len;
+    flt->flags    |= NL_RTT_F_FAMILY | NL_RTT_F_PREFIX;
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlRouteTableSetPrefix() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlRouteTableSelect(struct nlArena *arena,
+                       const struct nlRouteTable *tbl,
+                       const struct nlRouteTableFilter *flt,
+                       unsigned int **sel, unsigned int *n)
+{
+    _OSBASE_TRACE(3, ("--- nlRouteTableSelect() called"));
+
+    unsigned char *m  = NULL;  // Rows mask.
+    int            rc = NL_OK; // Result handler.
+
+    // Check received parameters.
+    if((arena == NULL) || (tbl == NULL) || (flt == NULL) ||
+       (sel == NULL) || (n == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+    *sel = NULL;
+    *n   = 0;
+    if(tbl->count == 0) {
+        goto out;
+    }
+
+    // Filter.
+    m = nlRttMask(arena, tbl, flt);
+    if(m == NULL) {
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Selection vector.
+    *sel = nlArenaAlloc(arena, tbl->count * sizeof(**sel));
+    if(*sel == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for \'sel\'."));
+        rc = NL_FAIL;
+        goto out;
+    }
+    *n = nlRttCompact(m, tbl->size, *sel);
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlRouteTableSelect() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlRouteTableCount(struct nlArena *arena,
+                      const struct nlRouteTable *tbl,
+                      const struct nlRouteTableFilter *flt,
+                      unsigned int *n)
+{
+    _OSBASE_TRACE(3, ("--- nlRouteTableCount() called"));
+
+    unsigned char *m  = NULL;  // Rows mask.
+    int            rc = NL_OK; // Result handler.
+
+    // Check received parameters.
+    if((arena == NULL) || (tbl == NULL) || (flt == NULL) || (n == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+    *n = 0;
+    if(tbl->count == 0) {
+        goto out;
+    }
+
+    // Filter.
+    m = nlRttMask(arena, tbl, flt);
+    if(m == NULL) {
+        rc = NL_FAIL;
+        goto out;
+    }
+    *n = nlRttCompact(m, tbl->size, NULL);
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlRouteTableCount() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,145 @@
+#ifndef _OSBASE_ROUTETABLE_H_
+#define _OSBASE_ROUTETABLE_H_
+
+/**
+ * @file
+ * OSBase_RouteTable.h
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Columnar route snapshot.
+ * A nlRouteList is copied into parallel arrays (one per field) so filters
+ * are evaluated over contiguous memory. The scan kernels use AVX2 or SSE2
+ * when the compiler targets them (-mavx2, x86_64 default) and plain C
+ * otherwise (or when NL_RTT_NO_AVX2 / NL_RTT_NO_SSE2 are defined).
+ * Experiment: it lives under bench/ and is not used by the providers,
+ * osbase_routetable_bench checks and measures the three kernel sets.
+ */
+
+#include <stdint.h>
+
+#include "OSBase_Netlink.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+    ////////////////////////////////////////////////////////////////////////////
+    // ROUTE TABLE
+    ////////////////////////////////////////////////////////////////////////////
+
+#define NL_RTT_ROW_ALIGN 32 /**< Columns are padded to a multiple of this
+                               number of rows (one AVX2 vector of bytes). */
+
+#define NL_RTT_F_FAMILY   0x01 /**< Filter by family. */
+#define NL_RTT_F_PROTOCOL 0x02 /**< Filter by route origin. */
+#define NL_RTT_F_SCOPE    0x04 /**< Filter by scope. */
+#define NL_RTT_F_TABLE    0x08 /**< Filter by routing table. */
+#define NL_RTT_F_OIF      0x10 /**< Filter by output interface. */
+#define NL_RTT_F_PREFIX   0x20 /**< Destination within a prefix. */
+
+    /**
+     * Route snapshot stored by columns. Row i of every array describes
+     * the route route[i]. Rows from count up to the padded length are
+     * zeroed and never selected.
+     */
+    struct nlRouteTable {
+        unsigned int         count;     /**< Number of routes. */
+        unsigned int         size;      /**< Padded number of rows. */
+        unsigned char       *family;    /**< AF_INET | AF_INET6. */
+        unsigned char       *dstLen;    /**< Destination prefix length. */
+        unsigned char       *protocol;  /**< Route origin. */
+        unsigned char       *scope;     /**< Distance to the destination. */
+        uint32_t            *table;     /**< Routing table. */
+        uint32_t            *outputIf;  /**< Output interface index. */
+        unsigned char      (*dst)[16];  /**< Destination address (network
+                                           byte order, IPv4 in the first
+                                           4 bytes). */
+        unsigned char      (*gw)[16];   /**< Gateway address (zeroed when
+                                           the route has none). */
+        struct nlRoute     **route;     /**< Source route of every row. */
+    };
+
+    /**
+     * Predicates applied by nlRouteTableSelect. Only the fields whose
+     * NL_RTT_F_* flag is set are compared.
+     */
+    struct nlRouteTableFilter {
+        unsigned int  flags;      /**< NL_RTT_F_* predicates in use. */
+        unsigned char family;     /**< Route family. */
+        unsigned char protocol;   /**< Route origin. */
+        unsigned char scope;      /**< Distance to the destination. */
+        uint32_t      table;      /**< Routing table. */
+        uint32_t      outputIf;   /**< Output interface index. */
+        unsigned char prefix[16]; /**< Prefix the destination must be
+                                     within (host bits cleared). */
+        unsigned char prefixLen;  /**< Prefix length. */
+    };
+
+    /**
+     * Used to build a snapshot of a routes list. The columns are
+     * allocated from the arena and point to the list entries, so the
+     * snapshot lives as long as the list.
+     * @param arena [in] request arena.
+     * @param nlRtList [in] routes list.
+     * @param tbl [out] route table.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlRouteTableBuild(struct nlArena *arena,
+                          struct nlRouteList *nlRtList,
+                          struct nlRouteTable *tbl);
+
+    /**
+     * Used to set the "destination within prefix" predicate of a filter.
+     * It also sets the family predicate.
+     * @param flt [out] filter.
+     * @param addr [in] prefix address (presentation format).
+     * @param len [in] prefix length.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlRouteTableSetPrefix(struct nlRouteTableFilter *flt,
+                              const char *addr, int len);
+
+    /**
+     * Used to get the rows that match a filter.
+     * @param arena [in] request arena (holds the selection).
+     * @param tbl [in] route table.
+     * @param flt [in] filter.
+     * @param sel [out] indexes of the matching rows, in row order.
+     * @param n [out] number of matching rows.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlRouteTableSelect(struct nlArena *arena,
+                           const struct nlRouteTable *tbl,
+                           const struct nlRouteTableFilter *flt,
+                           unsigned int **sel, unsigned int *n);
+
+    /**
+     * Used to count the rows that match a filter.
+     * @param arena [in] request arena (scratch memory).
+     * @param tbl [in] route table.
+     * @param flt [in] filter.
+     * @param n [out] number of matching rows.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlRouteTableCount(struct nlArena *arena,
+                          const struct nlRouteTable *tbl,
+                          const struct nlRouteTableFilter *flt,
+                          unsigned int *n);
+
+    ////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //_OSBASE_ROUTETABLE_H_
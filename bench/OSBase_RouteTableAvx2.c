@@ -0,0 +1,30 @@
+/**
+ * @file
+ * OSBase_RouteTableAvx2.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description AVX2 kernels of the columnar route snapshot.
+ * Builds OSBase_RouteTable.c with its functions renamed, so
+ * osbase_routetable_bench links the three kernel sets side by side.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#pragma GCC target("avx2")
+#endif
+
+#define nlRouteTableBuild     nlRouteTableBuildAvx2
+#define nlRouteTableSetPrefix nlRouteTableSetPrefixAvx2
+#define nlRouteTableSelect    nlRouteTableSelectAvx2
+#define nlRouteTableCount     nlRouteTableCountAvx2
+
+#include "OSBase_RouteTable.c"
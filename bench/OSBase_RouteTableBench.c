@@ -0,0 +1,358 @@
+/**
+ * @file
+ * OSBase_RouteTableBench.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Route snapshot benchmark.
+ * Checks that the AVX2, SSE2 and plain C kernels of OSBase_RouteTable
+ * select the same routes as a walk of the routes list, then measures
+ * them. The AVX2 kernels are skipped when the CPU has not got AVX2.
+ * Not built by default:
+ *   make osbase_routetable_bench && ./osbase_routetable_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "OSBase_RouteTable.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// COMMON
+////////////////////////////////////////////////////////////////////////////////
+
+#define BENCH_ROUTES  4099   /**< Routes (not a multiple of the padding). */
+#define BENCH_FILTERS 1024   /**< Filters per set. */
+#define BENCH_ITERS   100000 /**< Default scans per measure. */
+
+/**
+ * Kernel set entry points (bench/OSBase_RouteTable{Avx2,Sse2,Scalar}.c).
+ */
+#define BENCH_KERNELS(isa)                                              \
+    int nlRouteTableSelect##isa(struct nlArena *arena,                  \
+                                const struct nlRouteTable *tbl,         \
+                                const struct nlRouteTableFilter *flt,   \
+                                unsigned int **sel, unsigned int *n);   \
+    int nlRouteTableCount##isa(struct nlArena *arena,                   \
+                               const struct nlRouteTable *tbl,          \
+                               const struct nlRouteTableFilter *flt,    \
+                               unsigned int *n);
+BENCH_KERNELS(Avx2)
+BENCH_KERNELS(Sse2)
+BENCH_KERNELS(Scalar)
+int nlRouteTableBuildScalar(struct nlArena *arena,
+                            struct nlRouteList *nlRtList,
+                            struct nlRouteTable *tbl);
+int nlRouteTableSetPrefixScalar(struct nlRouteTableFilter *flt,
+                                const char *addr, int len);
+
+/**
+ * Kernel set.
+ */
+struct benchKernels {
+    const char *name;  /**< Instruction set. */
+    int       (*select)(struct nlArena*, const struct nlRouteTable*,
+                        const struct nlRouteTableFilter*,
+                        unsigned int**, unsigned int*); /**< Select. */
+    int       (*count)(struct nlArena*, const struct nlRouteTable*,
+                       const struct nlRouteTableFilter*,
+                       unsigned int*); /**< Count. */
+};
+
+/**
+ * Random generator state (the run is reproducible).
+ */
+static unsigned int benchSeed = 1;
+
+/**
+ * Used to avoid the scans to be optimized out.
+ */
+static volatile unsigned int benchSink = 0;
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a random number.
+ * @return random number (15 bits).
+ */
+static unsigned int benchRand()
+{
+    benchSeed = benchSeed * 1103515245 + 12345;
+    return (benchSeed >> 16) & 0x7FFF;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a random route. Few values per field, so the filters match
+ * some of the routes; the tables and interfaces go beyond 8 bits.
+ * @param route [out] route.
+ */
+static void benchRandRoute(struct nlRoute *route)
+{
+    static const unsigned char bytes[] = { 0, 1, 10, 192, 168, 254 };
+    static const unsigned char protos[] = { 2, 3, 4, 186 };
+    static const unsigned char scopes[] = { 0, 253, 254 };
+    static const uint32_t      tables[] = { 254, 255, 100, 0x10000FE };
+    int                        i = 0; // Current byte.
+
+    memset(route, 0, sizeof(*route));
+    route->family   = (benchRand() % 2) ? AF_INET : AF_INET6;
+    route->dstLen   = benchRand() % ((route->family == AF_INET) ? 33 : 129);
+    route->protocol = protos[benchRand() % sizeof(protos)];
+    route->scope    = scopes[benchRand() % sizeof(scopes)];
+    route->table    = tables[benchRand() % 4];
+    route->outputIf = (benchRand() % 8) ? (benchRand() % 4 + 1) : 0x10001;
+    for(i=0 ; i<((route->family == AF_INET) ? 4 : 16) ; i++) {
+        route->dstAddr[i] = bytes[benchRand() % sizeof(bytes)];
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a random filter: random predicates, the prefix taken from
+ * a route of the list (so it matches at least one).
+ * @param flt [out] filter.
+ * @param route [in] route the prefix is taken from.
+ */
+static void benchRandFilter(struct nlRouteTableFilter *flt,
+                            const struct nlRoute *route)
+{
+    char addr[NL_ADDRESS_MAXLEN]; // Prefix literal.
+
+    memset(flt, 0, sizeof(*flt));
+    flt->flags    = benchRand() & (NL_RTT_F_FAMILY | NL_RTT_F_PROTOCOL |
+                                   NL_RTT_F_SCOPE | NL_RTT_F_TABLE |
+                                   NL_RTT_F_OIF);
+    flt->family   = route->family;
+    flt->protocol = route->protocol;
+    flt->scope    = (benchRand() % 2) ? route->scope : 0;
+    flt->table    = route->table;
+    flt->outputIf = route->outputIf;
+    if(benchRand() % 2) {
+        inet_ntop(route->family, route->dstAddr, addr, sizeof(addr));
+        nlRouteTableSetPrefixScalar(flt, addr,
+                                    benchRand() % (route->dstLen + 1));
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Reference filter (a walk of the routes list).
+ * @param route [in] route.
+ * @param flt [in] filter.
+ * @return 1=match | 0=no match
+ */
+static int benchMatchRef(const struct nlRoute *route,
+                         const struct nlRouteTableFilter *flt)
+{
+    unsigned int i = 0; // Current bit.
+
+    if(((flt->flags & NL_RTT_F_FAMILY) && (route->family != flt->family)) ||
+       ((flt->flags & NL_RTT_F_PROTOCOL) &&
+        (route->protocol != flt->protocol)) ||
+       ((flt->flags & NL_RTT_F_SCOPE) && (route->scope != flt->scope)) ||
+       ((flt->flags & NL_RTT_F_TABLE) && (route->table != flt->table)) ||
+       ((flt->flags & NL_RTT_F_OIF) && (route->outputIf != flt->outputIf))) {
+        return 0;
+    }
+    if(flt->flags & NL_RTT_F_PREFIX) {
+        if(route->dstLen < flt->prefixLen) {
+            return 0;
+        }
+        for(i=0 ; i<flt->prefixLen ; i++) {
+            if(((route->dstAddr[i / 8] ^ flt->prefix[i / 8]) >>
+                (7 - (i % 8))) & 1) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get the current time.
+ * @return time in nanoseconds.
+ */
+static double benchNow()
+{
+    struct timespec ts; // Current time.
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CHECK
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+/**
+ * Used to check a kernel set against the reference filter.
+ * @param k [in] kernel set.
+ * @param tbl [in] route table.
+ * @param flts [in] filters.
+ * @return number of mismatching filters.
+ */
+static int benchCheck(const struct benchKernels *k,
+                      const struct nlRouteTable *tbl,
+                      const struct nlRouteTableFilter *flts)
+{
+    struct nlArena  arena;      // Selections.
+    unsigned int   *sel = NULL; // Selected rows.
+    unsigned int    n   = 0;    // Selected rows number.
+    unsigned int    c   = 0;    // Counted rows.
+    unsigned int    i   = 0;    // Current row.
+    unsigned int    j   = 0;    // Current selected row.
+    int             f   = 0;    // Current filter.
+    int             bad = 0;    // Mismatches.
+
+    for(f=0 ; f<BENCH_FILTERS ; f++) {
+        nlArenaInit(&arena);
+        if((k->select(&arena, tbl, &flts[f], &sel, &n) != NL_OK) ||
+           (k->count(&arena, tbl, &flts[f], &c) != NL_OK) || (c != n)) {
+            printf("%s: filter %d failed.\n", k->name, f);
+            bad++;
+            nlArenaRelease(&arena);
+            continue;
+        }
+        for(i=0, j=0 ; i<tbl->count ; i++) {
+            if(!benchMatchRef(tbl->route[i], &flts[f])) {
+                continue;
+            }
+            if((j >= n) || (sel[j] != i)) {
+                break;
+            }
+            j++;
+        }
+        if((i != tbl->count) || (j != n)) {
+            printf("%s: filter %d selects other routes.\n", k->name, f);
+            bad++;
+        }
+        nlArenaRelease(&arena);
+    }
+    return bad;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// MAIN
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    static struct nlRoute            routes[BENCH_ROUTES];  // Routes.
+    static struct nlRouteList        list[BENCH_ROUTES];    // Routes list.
+    static struct nlRouteTableFilter flts[BENCH_FILTERS];   // Filters.
+    static const struct benchKernels ks[] = {
+        { "Scalar", nlRouteTableSelectScalar, nlRouteTableCountScalar },
+        { "SSE2",   nlRouteTableSelectSse2,   nlRouteTableCountSse2 },
+        { "AVX2",   nlRouteTableSelectAvx2,   nlRouteTableCountAvx2 }
+    };
+    struct nlArena      arena;                  // Route table.
+    struct nlArena      scratch;                // Masks.
+    struct nlRouteTable tbl;                    // Route table.
+    struct nlRouteList *curr  = NULL;           // Current list entry.
+    unsigned int        c     = 0;              // Counted rows.
+    int                 nks   = 3;              // Kernel sets to run.
+    long                iters = BENCH_ITERS;    // Scans.
+    long                n     = 0;              // Current one.
+    int                 i     = 0;              // Current route | set.
+    int                 bad   = 0;              // Mismatches.
+    double              t0    = 0;              // Start time.
+    double              tRef  = 0;              // List walk time.
+    double              tNew  = 0;              // Route table time.
+
+    if(argc > 1) {
+        iters = atol(argv[1]);
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    if(!__builtin_cpu_supports("avx2")) {
+        printf("No AVX2, its kernels are not run.\n");
+        nks = 2;
+    }
+#endif
+
+    // Routes and filters.
+    for(i=0 ; i<BENCH_ROUTES ; i++) {
+        benchRandRoute(&routes[i]);
+        list[i].sptr = &routes[i];
+        list[i].next = (i + 1 < BENCH_ROUTES) ? &list[i + 1] : NULL;
+    }
+    for(i=0 ; i<BENCH_FILTERS ; i++) {
+        benchRandFilter(&flts[i], &routes[benchRand() % BENCH_ROUTES]);
+    }
+    nlArenaInit(&arena);
+    if(nlRouteTableBuildScalar(&arena, list, &tbl) != NL_OK) {
+        printf("Could not build the route table.\n");
+        return 1;
+    }
+
+    // Check.
+    for(i=0 ; i<nks ; i++) {
+        bad += benchCheck(&ks[i], &tbl, flts);
+    }
+    if(bad != 0) {
+        return 1;
+    }
+    printf("Same routes as the list walk for %d filters over %d routes.\n",
+           BENCH_FILTERS, BENCH_ROUTES);
+    printf("%-10s %14s %14s %8s\n", "", "list ns/op", "table ns/op",
+           "speedup");
+
+    // List walk.
+    t0 = benchNow();
+    for(n=0 ; n<iters ; n++) {
+        for(curr = list ; curr != NULL ; curr = curr->next) {
+            benchSink += benchMatchRef(curr->sptr, &flts[n % BENCH_FILTERS]);
+        }
+    }
+    tRef = benchNow() - t0;
+
+    // Route table counts (the mask comes from a request arena, as in a
+    // provider call).
+    for(i=0 ; i<nks ; i++) {
+        t0 = benchNow();
+        for(n=0 ; n<iters ; n++) {
+            nlArenaInit(&scratch);
+            ks[i].count(&scratch, &tbl, &flts[n % BENCH_FILTERS], &c);
+            benchSink += c;
+            nlArenaRelease(&scratch);
+        }
+        tNew = benchNow() - t0;
+        printf("%-10s %14.1f %14.1f %7.1fx\n", ks[i].name, tRef / iters,
+               tNew / iters, tRef / tNew);
+    }
+
+    nlArenaRelease(&arena);
+    return 0;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,29 @@
+/**
+ * @file
+ * OSBase_RouteTableScalar.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Plain C kernels of the columnar route snapshot.
+ * Builds OSBase_RouteTable.c with its functions renamed, so
+ * osbase_routetable_bench links the three kernel sets side by side.
+ */
+
+#define NL_RTT_NO_AVX2
+#define NL_RTT_NO_SSE2
+
+#define nlRouteTableBuild     nlRouteTableBuildScalar
+#define nlRouteTableSetPrefix nlRouteTableSetPrefixScalar
+#define nlRouteTableSelect    nlRouteTableSelectScalar
+#define nlRouteTableCount     nlRouteTableCountScalar
+
+#include "OSBase_RouteTable.c"
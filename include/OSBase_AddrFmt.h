@@ -0,0 +1,88 @@
+#ifndef _OSBASE_ADDRFMT_H_
+#define _OSBASE_ADDRFMT_H_
+
+/**
+ * @file
+ * OSBase_AddrFmt.h
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Address formatting.
+ * Converts IPv4, IPv6 and L2 addresses from network format to presentation
+ * format. The output is byte-identical to inet_ntop (glibc) and to the
+ * "%02x:" snprintf loop it replaces. IPv6 uses SSE2 for the hex digits and
+ * the zero words when the compiler targets it (x86_64 default) and plain C
+ * otherwise. It does not depend on the CIM layer.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+    ////////////////////////////////////////////////////////////////////////////
+    // ADDRESS FORMATTING
+    ////////////////////////////////////////////////////////////////////////////
+
+#define NL_FMT_IPV4_MAXLEN 16 /**< "255.255.255.255" plus NUL
+                                 (INET_ADDRSTRLEN). */
+#define NL_FMT_IPV6_MAXLEN 46 /**< Longest IPv6 text plus NUL
+                                 (INET6_ADDRSTRLEN). */
+
+    /**
+     * Used to convert an IPv4 address to dotted-quad format.
+     * @param addr [in] address (4 bytes, network byte order).
+     * @param buf [out] converted address (NL_FMT_IPV4_MAXLEN bytes).
+     * @return length of the converted address.
+     */
+    int nlFmtIPv4(const unsigned char *addr, char *buf);
+
+    /**
+     * Used to convert an IPv6 address to presentation format. The longest
+     * run (first one on ties) of two or more zero words is compressed and
+     * IPv4 compatible/mapped addresses end in dotted-quad format, as
+     * inet_ntop does.
+     * @param addr [in] address (16 bytes, network byte order).
+     * @param buf [out] converted address (NL_FMT_IPV6_MAXLEN bytes).
+     * @return length of the converted address.
+     */
+    int nlFmtIPv6(const unsigned char *addr, char *buf);
+
+    /**
+     * Used to convert an address of any family, with the inet_ntop
+     * contract: nothing is written when it does not fit.
+     * @param family [in] AF_INET | AF_INET6.
+     * @param addr [in] address (network byte order).
+     * @param buf [out] converted address.
+     * @param blen [in] converted address maximum length.
+     * @return length of the converted address | -1=fail (unknown family
+     *         or buffer too small)
+     */
+    int nlFmtAddr(int family, const unsigned char *addr, char *buf, int blen);
+
+    /**
+     * Used to convert a L2 address to "xx:xx:..." format. As snprintf,
+     * the output is truncated to blen-1 characters and always terminated.
+     * @param addr [in] address.
+     * @param alen [in] address length.
+     * @param buf [out] converted address.
+     * @param blen [in] converted address maximum length (> 0).
+     * @return length of the converted address.
+     */
+    int nlFmtMAC(const unsigned char *addr, int alen, char *buf, int blen);
+
+    ////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //_OSBASE_ADDRFMT_H_
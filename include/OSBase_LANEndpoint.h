@@ -58,6 +58,47 @@ extern "C" {
     "its associated interface device is connected to a LAN, "           \
     "may send and receive data frames."
 
+    /**
+     * Requested properties (CIM property list). The keys (Name,
+     * CreationClassName, SystemCreationClassName and SystemName) are
+     * always filled.
+     */
+#define LEP_P_ALIAS_ADDRESSES       0x00000001 /**< AliasAddresses. */
+#define LEP_P_AVAIL_REQ_STATES      0x00000002 /**< AvailableRequestedStates. */
+#define LEP_P_CAPTION               0x00000004 /**< Caption. */
+#define LEP_P_COMMUNICATION_STATUS  0x00000008 /**< CommunicationStatus. */
+#define LEP_P_DESCRIPTION           0x00000010 /**< Description. */
+#define LEP_P_DETAILED_STATUS       0x00000020 /**< DetailedStatus. */
+#define LEP_P_ELEMENT_NAME          0x00000040 /**< ElementName. */
+#define LEP_P_ENABLED_DEFAULT       0x00000080 /**< EnabledDefault. */
+#define LEP_P_ENABLED_STATE         0x00000100 /**< EnabledState. */
+#define LEP_P_GROUP_ADDRESSES       0x00000200 /**< GroupAddresses. */
+#define LEP_P_HEALTH_STATE          0x00000400 /**< HealthState. */
+#define LEP_P_INSTANCE_ID           0x00000800 /**< InstanceID. */
+#define LEP_P_LAN_ID                0x00001000 /**< LANID. */
+#define LEP_P_MAC_ADDRESS           0x00002000 /**< MACAddress. */
+#define LEP_P_MAX_DATA_SIZE         0x00004000 /**< MaxDataSize. */
+#define LEP_P_NAME_FORMAT           0x00008000 /**< NameFormat. */
+#define LEP_P_OPERATING_STATUS      0x00010000 /**< OperatingStatus. */
+#define LEP_P_OPERATIONAL_STATUS    0x00020000 /**< OperationalStatus. */
+#define LEP_P_OTHER_ENABLED_STATE   0x00040000 /**< OtherEnabledState. */
+#define LEP_P_OTHER_TYPE_DESC       0x00080000 /**< OtherTypeDescription. */
+#define LEP_P_PRIMARY_STATUS        0x00100000 /**< PrimaryStatus. */
+#define LEP_P_PROTOCOL_IF_TYPE      0x00200000 /**< ProtocolIFType. */
+#define LEP_P_REQUESTED_STATE       0x00400000 /**< RequestedState. */
+#define LEP_P_STATUS_DESCRIPTIONS   0x00800000 /**< StatusDescriptions. */
+#define LEP_P_TRANSITIONING_STATE   0x01000000 /**< TransitioningToState. */
+#define LEP_P_NONE                  0x00000000 /**< Only the keys. */
+#define LEP_P_ALL                   0xFFFFFFFF /**< Every property. */
+
+    /**
+     * Properties computed from the link operational state.
+     */
+#define LEP_P_STATUS (LEP_P_COMMUNICATION_STATUS | LEP_P_DETAILED_STATUS | \
+                      LEP_P_ENABLED_STATE | LEP_P_HEALTH_STATE |           \
+                      LEP_P_OPERATING_STATUS | LEP_P_OPERATIONAL_STATUS |  \
+                      LEP_P_PRIMARY_STATUS)
+
     /**
      * CIM - EnabledState.
      */
@@ -321,81 +362,73 @@ extern "C" {
     };
 
     /**
-     * This structure stores the LANEndpoint's properties.
+     * CIM - LANEndpoint LANID.
+     */
+#define LANENDPOINT_LAN_ID "NULL"
+
+    /**
+     * Number of CIM - AvailableRequestedStates.
+     */
+#define LEP_AVAIL_REQ_STATES_MAX 9
+
+    /**
+     * CIM - AvailableRequestedStates (same for every LANEndpoint).
+     * @todo implement CIM_EnabledLogicalElementCapabilities.
+     */
+    extern const unsigned short lepAvailReqStates[LEP_AVAIL_REQ_STATES_MAX];
+
+    /**
+     * This structure stores the per link data of a LANEndpoint. The
+     * properties that are the same for every link (Caption, Description,
+     * CreationClassName, ...) are not stored, they are supplied when the
+     * CIM instance is built, and so are the ones rendered from this data
+     * (MACAddress, ElementName, InstanceID and NameFormat).
      * @todo How can obtain installation date form a device?
      *       char installDate[64];
      * @todo How can obtain device last change.
      *       char timeOfLastStateChange[64];
      */
     struct LANEndpoint {
-        char aliasAddresses[32];             /**< Other unicast addresses that
-                                                may be used to communicate with
+        const char *name;                    /**< Identifies this
+                                                ProtocolEndpoint (ifname,
+                                                interned in the request
+                                                arena). */
+        const char *systemName;              /**< The Name of the scoping
+                                                System (shared by every
+                                                LANEndpoint of a request). */
+        int index;                           /**< Interface index. */
+        unsigned int maxDataSize;            /**< The largest information field
+                                                that may be sent or received by
                                                 the LANEndpoint. */
-        unsigned short availReqStates[9];    /**< The possible values for the
-                                                RequestedState parameter of the
-                                                method RequestStateChange. */
-        char caption[64];                    /**< Short textual description of
-                                                the object. */
+        unsigned short type;                 /**< Link type (ARPHRD_*). */
+        unsigned short addressLen;           /**< L2 address length. */
+        unsigned char address[32];           /**< The principal unicast address
+                                                used in communication with the
+                                                LANEndpoint (network
+                                                representation). */
         unsigned short communicationStatus;  /**< The ability of the
                                                 instrumentation to communicate
                                                 with the underlying
                                                 ManagedElement. */
-        char creationClassName[256];         /**< The name of the class or the
-                                                subclass used in the creation of
-                                                an instance. */
-        char description[256];               /**< Textual description of the
-                                                object. */
         unsigned short detailedStatus;       /**< Compliments PrimaryStatus with
                                                 additional status detail. */
-        char elementName[64];                /**< A user-friendly name for the
-                                                object. */
         unsigned short enabledDefault;       /**< Administrator's default
                                                 configuration for the Enabled
                                                 State. */
         unsigned short enabledState;         /**< Indicates the enabled and
                                                 disabled states of an
                                                 element. */
-        char groupAddresses[32];             /**< Multicast addresses to which
-                                                the LANEndpoint listens. */
         unsigned short healthState;          /**< Current health of the
                                                 element. */
-        char instanceID[64];                 /**< Opaquely and uniquely identify
-                                                an instance of this class. */
-        char lanID[64];                      /**< Identifier for the LAN Segment
-                                                to which the Endpoint is
-                                                connected. */
-        char macAddress[32];                 /**< The principal unicast address
-                                                used in communication with the
-                                                LANEndpoint. */
-        unsigned int maxDataSize;            /**< The largest information field
-                                                that may be sent or received by
-                                                the LANEndpoint. */
-        char name[256];                      /**< Identifies this
-                                                ProtocolEndpoint. */
-        char nameFormat[256];                /**< The naming heuristic that is
-                                                selected to ensure that the
-                                                value of the Name property is
-                                                unique. */
         unsigned short operatingStatus;      /**< Current status value for the
                                                 operational condition of the
                                                 element. */
         unsigned short operationalStatus;    /**< Current statuses of the
                                                 element. */
-        char otherEnabledState[64];          /**< A string that describes the
-                                                enabled or disabled state of
-                                                the element. */
-        char otherTypeDescription[64];       /**< Type of ProtocolEndpoint. */
         unsigned short primaryStatus;        /**< High level status value. */
         unsigned short protocolIFType;       /**< IANA ifType MIB. */
         unsigned short requestedState;       /**< The last requested or desired
                                                 state for the element. */
-        char statusDescriptions[256];        /**< Strings describing the various
-                                                OperationalStatus array
-                                                values. */
-        char systemCreationClassName[256];   /**< The CreationClassName of the
-                                                scoping System. */
-        char systemName[256];                /**< The Name of the scoping
-                                                System. */
         unsigned short transitioningToState; /**< The target state to which the
                                                 instance is transitioning. */
     };
@@ -413,29 +446,41 @@ extern "C" {
     /**
      * This functions is used to get a list of LANEndpoints
      * based on nlLinkInfo filter.
+     * @param arena [in] request arena the list is allocated from.
      * @param lanEPList [out] LANEndpoint struct to be filled.
      * @param nlLinkInfo [in] link filter info.
+     * @param props [in] requested properties (LEP_P_*).
      * @return LEP_OK=succesful | LEP_FAIL=fail
      */
-    int getLANEndpoints(struct LANEndpointList **lanEPList,
-                        const struct nlLinkInfo *nlLinkInfo);
+    int getLANEndpoints(struct nlArena *arena,
+                        struct LANEndpointList **lanEPList,
+                        const struct nlLinkInfo *nlLinkInfo,
+                        unsigned int props);
 
     /**
      * This functions is used to get whole LANEndpoints
      * available in the system.
+     * @param arena [in] request arena the list is allocated from.
      * @param lanEPList [out] LANEndpoint struct to be filled.
+     * @param props [in] requested properties (LEP_P_*).
      * @return LEP_OK=succesful | LEP_FAIL=fail
      */
-    int getALLLANEndpoint(struct LANEndpointList **lanEPList);
+    int getALLLANEndpoints(struct nlArena *arena,
+                           struct LANEndpointList **lanEPList,
+                           unsigned int props);
 
     /**
-     * This functions is used to get a route base on specified InstanceID.
+     * This functions is used to get a LANEndpoint base on its ifname. The
+     * link is looked up by name instead of dumping every link.
+     * @param arena [in] request arena the list is allocated from.
      * @param lanEPList [out] LANEndpoint struct to be filled.
      * @param linkName [in] link ifname.
+     * @param props [in] requested properties (LEP_P_*).
      * @return LEP_OK=succesful | LEP_FAIL=fail
      */
-    int getLANEndpoint(struct LANEndpointList **lanEPList,
-                       const char *linkName);
+    int getLANEndpoint(struct nlArena *arena,
+                       struct LANEndpointList **lanEPList,
+                       const char *linkName, unsigned int props);
 
     /**
      * Used to set device status.
@@ -464,28 +509,37 @@ extern "C" {
 
     /**
      * Converts a nlLinkInfoList structure to LANEndpointList strucutre.
+     * @param arena [in] request arena the list is allocated from.
      * @param nlLinkInfoList [in] list to be converted.
      * @param lanEPList [out] converted list.
+     * @param props [in] requested properties (LEP_P_*).
      * @return LEP_OK=succesful | LEP_FAIL=fail
      */
-    int nlListTOLanEPList(struct nlLinkInfoList **nlLinkInfoList,
-                          struct LANEndpointList **lanEPList);
+    int nlListTOLanEPList(struct nlArena *arena,
+                          struct nlLinkInfoList **nlLinkInfoList,
+                          struct LANEndpointList **lanEPList,
+                          unsigned int props);
 
     /**
-     * Converts a nlLinkInfo structure to LANEndpoint structure.
+     * Converts a nlLinkInfo structure to LANEndpoint structure. Only the
+     * data of the requested properties and the keys is filled.
+     * @param arena [in] request arena (interned strings of nlLinkInfo).
      * @param nlLinkInfo [in] structure to be converted.
      * @param lanEP [out] converted structure.
+     * @param systemName [in] host name (referenced, not copied).
+     * @param props [in] requested properties (LEP_P_*).
      * @return LEP_OK=succesful | LEP_FAIL=fail
      */
-    int nlInfoTOLanEP(struct nlLinkInfo *nlLinkInfo,
-                      struct LANEndpoint *lanEP);
+    int nlInfoTOLanEP(const struct nlArena *arena,
+                      struct nlLinkInfo *nlLinkInfo,
+                      struct LANEndpoint *lanEP, const char *systemName,
+                      unsigned int props);
 
     /**
-     * This function is used to clean a LANEndpoint list.
-     * @param lptr [in] list to be cleaned.
-     * @return LEP_OK=succesful | LEP_FAIL=fail
+     * This function is used to release the resources kept between requests
+     * (netlink sockets). Called from the provider cleanup.
      */
-    int freeLANEndpointList(struct LANEndpointList *lptr);
+    void cleanupLANEndpoints();
 
     ////////////////////////////////////////////////////////////////////////////
 
@@ -19,8 +19,12 @@
  * @description Netlink support lib.
  */
 
+#include <stdint.h>
+#include <sys/types.h>
 #include <sys/socket.h>
+#include <time.h>
 #include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 #include <linux/netdevice.h>
 #include <linux/if_arp.h>
 
@@ -37,11 +41,35 @@ extern "C" {
 #define NL_SKIP 2 /**< Indicates that the operation has fail, but it was skipped
                      due to their optional condition. */
 
-#define NL_SOCK_SND_BUFF_LEN 32768 /**< Netlink socket send buffer length. */
-#define NL_SOCK_RCV_BUFF_LEN 32768 /**< Netlink socket receive buffer length. */
+#define NL_SOCK_SND_BUFF_LEN 32768   /**< Netlink socket send buffer length. */
+#define NL_SOCK_RCV_BUFF_LEN 1048576 /**< Netlink socket receive buffer length
+                                        (forced when privileged, else capped
+                                        by net.core.rmem_max). */
+
+#define NL_RCV_BUFF_LEN 32768   /**< Initial length of the buffer where
+                                   datagrams are read. */
+#define NL_RCV_BUFF_MAX 1048576 /**< The read buffer grows up to this length
+                                   for larger datagrams. */
+
+#define NL_SOCK_POOL_SIZE    4  /**< Number of sockets kept by the pool. */
+#define NL_SOCK_IDLE_TIMEOUT 60 /**< Seconds after which an unused pooled
+                                   socket is closed (checked by the next
+                                   nlSockPoolGet, there is no timer). */
+
+#define NL_MAX_INFLIGHT 16 /**< Requests waiting for replies on one socket. */
 
 #define NL_ADDRESS_MAXLEN 64 /**< Address string maximum length. */
 
+#define NL_DUMP_RETRIES     4 /**< Times an interrupted dump is restarted. */
+#define NL_DUMP_BACKOFF_MS  1 /**< Wait before the first restart of a dump
+                                 (doubled on every restart). */
+
+#define NL_ARENA_CHUNK_LEN 32768 /**< Length of an arena chunk (larger
+                                    allocations get a chunk of their own). */
+#define NL_ARENA_ALIGN     16    /**< Alignment of arena allocations. */
+#define NL_STR_TAB_SLOTS   64    /**< Initial slots of the interned strings
+                                    table (doubled when half full). */
+
     /**
      * Get the size of an array.
      */
@@ -58,25 +86,149 @@ extern "C" {
 #define NLMSG_TAIL(nmsg)                                                \
     ((struct rtattr*) (((void*) (nmsg)) + NLMSG_ALIGN((nmsg)->nlmsg_len)))
 
+    struct nlContext;
+    struct nlUring;
+    struct nlArenaChunk;
+    struct nlStrTab;
+
+    /**
+     * Callback used to deliver every reply message that belongs to a
+     * request. NLMSG_DONE and NLMSG_ERROR are handled by the dispatcher
+     * itself. The message points into the receive buffer and is only valid
+     * during the call.
+     * @param h [in] received message header.
+     * @param arg [in] user data passed to nlSubmit/nlTalk.
+     * @return NL_OK=succesful | NL_FAIL=fail (the request is aborted)
+     */
+    typedef int (*nlMsgHandler)(const struct nlmsghdr *h, void *arg);
+
+    /**
+     * Callback used to drop what a handler collected during a dump that is
+     * going to be restarted.
+     * @param arg [in] user data passed to nlTalkDump.
+     */
+    typedef void (*nlDumpReset)(void *arg);
+
+    /**
+     * Request in flight. Replies are routed to it by sequence number.
+     */
+    struct nlRequest {
+        struct nlmsghdr  *msg;     /**< Request message (kept by the caller
+                                      until the request is done). */
+        nlMsgHandler      handler; /**< Reply callback (may be NULL). */
+        void             *arg;     /**< User data passed to handler. */
+        unsigned int      seq;     /**< Sequence number (0=not sent yet). */
+        unsigned int      isDump;  /**< Terminated by NLMSG_DONE. */
+        unsigned int      done;    /**< Request finished. */
+        int               rc;      /**< NL_OK | NL_FAIL. */
+        int               err;     /**< errno reported by the kernel. */
+        unsigned int      intr;    /**< Dump interrupted by a change
+                                      (NLM_F_DUMP_INTR), its replies may
+                                      miss or repeat entries. */
+        struct nlRequest *next;    /**< Next dump waiting for the socket. */
+    };
+
+    /**
+     * Netlink library counters (process wide).
+     */
+    struct nlStats {
+        unsigned long dumps;             /**< Dumps requested with
+                                            nlTalkDump. */
+        unsigned long dumpsIntr;         /**< Dump attempts interrupted by
+                                            a change. */
+        unsigned long dumpRetries;       /**< Dump restarts. */
+        unsigned long dumpsInconsistent; /**< Dumps still interrupted when
+                                            the retries ran out. */
+    };
+
+    /**
+     * Request scoped bump allocator. Everything a request builds (netlink
+     * lists and the lists converted from them) is carved from chunks that
+     * are freed together by nlArenaRelease at the end of the request.
+     * An arena is not shared between threads.
+     */
+    struct nlArena {
+        struct nlArenaChunk *head; /**< Current chunk (NULL until the first
+                                      allocation). */
+        size_t               size; /**< Bytes taken from the system. */
+        struct nlStrTab     *strs; /**< Interned strings (NULL until the
+                                      first one, see nlStrIntern). */
+    };
+
+    /**
+     * Handle of a string interned in an arena. Equal strings of an arena
+     * share a handle, so they are compared as integers and stored once.
+     * A handle is only meaningful with the arena it came from.
+     */
+    typedef unsigned int nlStrId;
+
+#define NL_STR_EMPTY   0            /**< Handle of "" (in every arena). */
+#define NL_STR_INVALID ((nlStrId)-1) /**< Not interned | fail. */
+
     /**
      * Netlink socket handler.
      */
     struct nlSockHandle {
-        int                fd;    /**< File descriptor for the new socket. */
-        struct sockaddr_nl local; /**< Netlink client in user-space. */
+        int                fd;        /**< File descriptor for the new
+                                         socket. */
+        struct sockaddr_nl local;     /**< Netlink client in user-space. */
+        pid_t              owner;     /**< Process that opened the socket. */
+        time_t             lastUsed;  /**< Last time the socket was used. */
+        unsigned int       inUse;     /**< Socket lent to a request. */
+        unsigned int       pooled;    /**< Socket owned by the pool. */
+        unsigned int       gen;       /**< Pool generation the socket was
+                                         lent in. */
+        unsigned int       strictChk; /**< Kernel filters dump requests
+                                         (NETLINK_GET_STRICT_CHK). */
+        unsigned int       seq;       /**< Last sequence number used. */
+        struct nlRequest  *pending[NL_MAX_INFLIGHT]; /**< Requests sent and
+                                                        waiting for
+                                                        replies. */
+        unsigned int       nPending;  /**< Number of pending requests. */
+        struct nlRequest  *dump;      /**< Dump in progress (the kernel runs
+                                         one dump per socket). */
+        struct nlRequest  *dumpHead;  /**< Dumps waiting for the socket. */
+        struct nlRequest  *dumpTail;  /**< Last queued dump. */
     };
 
     /**
      * Used to open a Netlink socket.
+     * @param sh [out] socket handler.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlOpenSocket();
+    int nlOpenSocket(struct nlSockHandle *sh);
 
     /**
      * Used to close a previously open Netlink socket.
+     * @param sh [in] socket handler.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlCloseSocket();
+    int nlCloseSocket(struct nlSockHandle *sh);
+
+    /**
+     * Used to get a socket from the pool. The socket is opened on first use
+     * and health checked before being reused. Sockets unused for
+     * NL_SOCK_IDLE_TIMEOUT seconds are closed by the next call (until
+     * then, or until nlSockPoolDestroy, they stay open). Thread safe: a
+     * socket is only lent to one request at a time. Not to be used by a
+     * child forked from a threaded process (see nlContext noPool).
+     * @return socket handler | NULL=fail
+     */
+    struct nlSockHandle* nlSockPoolGet();
+
+    /**
+     * Used to give back a socket obtained with nlSockPoolGet.
+     * @param sh [in] socket handler.
+     * @param status [in] result of the request (the socket is closed if it
+     * is not NL_OK).
+     */
+    void nlSockPoolPut(struct nlSockHandle *sh, int status);
+
+    /**
+     * Used to close every idle socket of the pool (provider cleanup).
+     * Sockets still lent are closed when they are given back.
+     */
+    void nlSockPoolDestroy();
 
     /**
      * This function is used to add an attribute to a netlink message.
@@ -101,6 +253,141 @@ extern "C" {
     int nlAddAttrToMsg32(struct nlmsghdr *h, int maxlen,
                          int attrType, unsigned int attrData);
 
+    /**
+     * This function is used to open a nested attribute in a netlink
+     * message. Attributes added until nlEndNestInMsg belong to it.
+     * @param h [out] message header.
+     * @param maxlen [in] message maximum length.
+     * @param attrType [in] attribute type.
+     * @return nested attribute | NULL=fail
+     */
+    struct rtattr* nlAddNestToMsg(struct nlmsghdr *h, int maxlen,
+                                  int attrType);
+
+    /**
+     * This function is used to close a nested attribute.
+     * @param h [in] message header.
+     * @param nest [out] nested attribute returned by nlAddNestToMsg.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlEndNestInMsg(struct nlmsghdr *h, struct rtattr *nest);
+
+    /**
+     * Send a request without waiting for its reply, so several requests can
+     * be in flight on the context socket. Each request gets the next
+     * sequence number of the socket; its replies are routed to its handler
+     * by nlWait, whichever request is being waited for. A dump is queued
+     * while another dump is running and sent when that one is done.
+     * @param ctx [in] request context (the socket is taken from the pool on
+     * first use).
+     * @param r [out] request handler (must live until nlWait returns).
+     * @param req [in] request message (must live until nlWait returns).
+     * @param handler [in] callback for each reply message (NULL if none is
+     * expected).
+     * @param arg [in] user data passed to handler.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlSubmit(struct nlContext *ctx, struct nlRequest *r,
+                 struct nlmsghdr *req, nlMsgHandler handler, void *arg);
+
+    /**
+     * Wait for a request sent with nlSubmit: dumps until NLMSG_DONE,
+     * modifications until their ACK and single requests until their only
+     * reply. Replies of the other requests in flight are dispatched
+     * meanwhile.
+     * @param ctx [in] request context.
+     * @param r [in] request handler.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlWait(struct nlContext *ctx, struct nlRequest *r);
+
+    /**
+     * Send a request to the kernel and process its reply (nlSubmit followed
+     * by nlWait).
+     * @param ctx [in] request context (the socket is taken from the pool on
+     * first use).
+     * @param req [in] request message (complete, including attributes).
+     * @param handler [in] callback for each reply message (NULL if none is
+     * expected).
+     * @param arg [in] user data passed to handler.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlTalk(struct nlContext *ctx, struct nlmsghdr *req,
+               nlMsgHandler handler, void *arg);
+
+    /**
+     * Send a dump request and process its replies like nlTalk. If the
+     * kernel reports that the dump was interrupted by a change
+     * (NLM_F_DUMP_INTR), the collected replies are dropped with reset and
+     * the dump is restarted, up to NL_DUMP_RETRIES times with a growing
+     * wait. When the retries run out, the last view is kept.
+     * @param ctx [in] request context.
+     * @param req [in] dump request message.
+     * @param handler [in] callback for each reply message.
+     * @param reset [in] callback used before a restart.
+     * @param arg [in] user data passed to handler and reset.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlTalkDump(struct nlContext *ctx, struct nlmsghdr *req,
+                   nlMsgHandler handler, nlDumpReset reset, void *arg);
+
+    /**
+     * Used to get a snapshot of the library counters.
+     * @param stats [out] counters.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlGetStats(struct nlStats *stats);
+
+    /**
+     * Used to initialize an arena. No memory is taken until the first
+     * allocation.
+     * @param arena [out] arena.
+     */
+    void nlArenaInit(struct nlArena *arena);
+
+    /**
+     * Used to allocate zeroed memory from an arena. It is freed by
+     * nlArenaRelease, never one by one.
+     * @param arena [in] arena.
+     * @param len [in] bytes wanted.
+     * @return allocated memory | NULL=fail
+     */
+    void* nlArenaAlloc(struct nlArena *arena, size_t len);
+
+    /**
+     * Used to free everything allocated from an arena. The arena can be
+     * used again afterwards.
+     * @param arena [in] arena.
+     */
+    void nlArenaRelease(struct nlArena *arena);
+
+    /**
+     * Used to intern a string in an arena. It is copied the first time it
+     * is seen and lives as long as the arena.
+     * @param arena [in] arena.
+     * @param s [in] string.
+     * @param len [in] string maximum length (it ends at the first NUL).
+     * @return handle | NL_STR_INVALID=fail
+     */
+    nlStrId nlStrIntern(struct nlArena *arena, const char *s, size_t len);
+
+    /**
+     * Used to get the handle of a string without interning it.
+     * @param arena [in] arena.
+     * @param s [in] string.
+     * @param len [in] string maximum length (it ends at the first NUL).
+     * @return handle | NL_STR_INVALID=not interned
+     */
+    nlStrId nlStrFind(const struct nlArena *arena, const char *s, size_t len);
+
+    /**
+     * Used to get an interned string.
+     * @param arena [in] arena.
+     * @param id [in] handle.
+     * @return string ("" for an unknown handle).
+     */
+    const char* nlStrGet(const struct nlArena *arena, nlStrId id);
+
     ////////////////////////////////////////////////////////////////////////////
 
 
@@ -109,11 +396,14 @@ extern "C" {
     ////////////////////////////////////////////////////////////////////////////
 
     /**
-     * Information of a single route.
+     * Information of a single route, in presentation format. Used to
+     * describe a request (filter, route to add or delete); the routes
+     * received from the kernel are nlRoute records.
      */
     struct nlRouteInfo {
         int  family;                       /**< IPv4=AF_INET ; IPv6=AF_INET6
-                                              (from rtmsg). */
+                                              (from rtmsg). As filter,
+                                              AF_UNSPEC matches both. */
         int  type;                         /**< Route type (from rtmsg). */
         int  protocol;                     /**< Route origin (from rtmsg). */
         int  scope;                        /**< Distance to the destination
@@ -140,81 +430,156 @@ extern "C" {
         int  table;                        /**< Route table (RTA_TABLE). */
     };
 
+    /**
+     * Route received from the kernel (64 bytes). Addresses are kept in
+     * network format (IPv4 in the first 4 bytes) and only converted to
+     * presentation format by the consumer (see nlRtAddr_n2a).
+     */
+    struct nlRoute {
+        unsigned char family;      /**< AF_INET | AF_INET6 (from rtmsg). */
+        unsigned char type;        /**< Route type (from rtmsg). */
+        unsigned char protocol;    /**< Route origin (from rtmsg). */
+        unsigned char scope;       /**< Distance to the destination
+                                      (from rtmsg). */
+        unsigned char srcLen;      /**< Source Route mask prefix
+                                      (from rtmsg). */
+        unsigned char dstLen;      /**< Destination Route mask prefix
+                                      (from rtmsg). */
+        unsigned char tos;         /**< Type of service (from rtmsg). */
+        uint32_t      addrs;       /**< Addresses received
+                                      (see NL_RT_HAS_ADDR). */
+        uint32_t      table;       /**< Route table (RTA_TABLE). */
+        uint32_t      inputIf;     /**< Input interface index (RTA_IIF). */
+        uint32_t      outputIf;    /**< Output interface index
+                                      (RTA_OIF). */
+        uint32_t      priority;    /**< Priority of the route
+                                      (RTA_PRIORITY). */
+        uint32_t      metrics;     /**< Route metrics (RTA_METRICS). */
+        unsigned char dstAddr[16]; /**< Destination address to be
+                                      reached (RTA_DST). */
+        unsigned char gw[16];      /**< Gateway of the route
+                                      (RTA_GATEWAY). */
+    };
+
+    /**
+     * Used to know if an address attribute (RTA_DST | RTA_GATEWAY) was
+     * received. The default route, for instance, has no destination.
+     */
+#define NL_RT_HAS_ADDR(route, type) (((route)->addrs >> (type)) & 1)
+
     /**
      * Routes container.
      */
-    struct nlRouteInfoList {
-        struct nlRouteInfo     *sptr; /**< Pointer to current position
-                                         in the list. */
-        struct nlRouteInfoList *next; /**< Pointer to next position
-                                         in the list. */
+    struct nlRouteList {
+        struct nlRoute     *sptr; /**< Pointer to current position
+                                     in the list. */
+        struct nlRouteList *next; /**< Pointer to next position
+                                     in the list. */
     };
 
     /**
-     * Struct used as route filter. If a field is deactivated (= 0),
-     * it will be skiped.
+     * Address of a filter in network format, compared with memcmp against
+     * the received attribute.
      */
-    struct {
-        unsigned int family   : 1;
-        unsigned int type     : 1;
-        unsigned int protocol : 1;
-        unsigned int scope    : 1;
-        unsigned int srcLen   : 1;
-        unsigned int dstLen   : 1;
-        unsigned int tos      : 1;
-        unsigned int dstAddr  : 1;
-        unsigned int srcAddr  : 1;
-        unsigned int inputIf  : 1;
-        unsigned int outputIf : 1;
-        unsigned int gw       : 1;
-        unsigned int priority : 1;
-        unsigned int prefSrc  : 1;
-        unsigned int metrics  : 1;
-        unsigned int table    : 1;
-    } rtFlt;
+    struct nlFilterAddr {
+        unsigned int  len;      /**< Address length (4 | 16). */
+        unsigned char data[16]; /**< Address (network byte order). */
+    };
+
+    /**
+     * Struct used as route filter. If a field is deactivated (= 0),
+     * it will be skiped. Fields are bytes (not bits) so the attribute
+     * descriptor tables can address them with offsetof.
+     */
+    struct nlRouteFilter {
+        unsigned char family;
+        unsigned char type;
+        unsigned char protocol;
+        unsigned char scope;
+        unsigned char srcLen;
+        unsigned char dstLen;
+        unsigned char tos;
+        unsigned char dstAddr;
+        unsigned char srcAddr;
+        unsigned char inputIf;
+        unsigned char outputIf;
+        unsigned char gw;
+        unsigned char priority;
+        unsigned char prefSrc;
+        unsigned char metrics;
+        unsigned char table;
+
+        // Filter values and addresses compiled by nlGenRouteFilter.
+        struct nlRoute      val;
+        struct nlFilterAddr dstAddrBin;
+        struct nlFilterAddr srcAddrBin;
+        struct nlFilterAddr gwBin;
+        struct nlFilterAddr prefSrcBin;
+    };
 
     /**
      * This function is used to get routes using a nlRouteInfo
      * structure as filter.
-     * @param nlRtInfoList [out] routes list (one or more entries).
+     * @param ctx [in] request context.
+     * @param nlRtList [out] routes list (allocated from ctx->arena).
      * @param nlRtInfo [in] route info used as filter.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlGetRoutes(struct nlRouteInfoList **nlRtInfoList,
+    int nlGetRoutes(struct nlContext *ctx, struct nlRouteList **nlRtList,
                     struct nlRouteInfo *nlRtInfo);
 
+    /**
+     * This function is used to get the routes of a single prefix without
+     * dumping the routing tables: the kernel is asked for the FIB entry
+     * used to reach the filter destination (RTM_F_FIB_MATCH). If that
+     * entry does not match the whole filter (another table, a more
+     * specific prefix, another next hop...) or the lookup fails, it falls
+     * back to nlGetRoutes.
+     * @param ctx [in] request context.
+     * @param nlRtList [out] routes list (allocated from ctx->arena).
+     * @param nlRtInfo [in] route info used as filter.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlGetRoute(struct nlContext *ctx, struct nlRouteList **nlRtList,
+                   struct nlRouteInfo *nlRtInfo);
+
     /**
      * This function is used to ADD/DELETE/MODIFY a route.
+     * @param ctx [in] request context.
      * @param nlRtInfo [in] route info.
      * @param hType [in] type of message (RTM_NEWROUTE || RTM_DELROUTE).
      * @param hFlags [in] message flags.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlModifyRoute(struct nlRouteInfo *nlRtInfo, int hType,
-                      unsigned int hFlags);
+    int nlModifyRoute(struct nlContext *ctx, struct nlRouteInfo *nlRtInfo,
+                      int hType, unsigned int hFlags);
 
     /**
-     * This function is used to add a route to specified routes list.
+     * This function is used to add a route to specified routes list if it
+     * passes the filter generated by nlGenRouteFilter.
+     * @param ctx [in] request context (holds the filter).
      * @param rcvH [in] route message header.
-     * @param nlRtInfoList [out] list where route will be added.
-     * @param nlRtInfo [in] route info.
+     * @param nlRtList [out] list where route will be added.
      * @return NL_OK=succesful | NL_FAIL=fail | NL_SKIP=skip
      */
-    int nlAddRouteToList(const struct nlmsghdr *rcvH,
-                         struct nlRouteInfoList **nlRtInfoList,
-                         const struct nlRouteInfo *nlRtInfo);
+    int nlAddRouteToList(struct nlContext *ctx, const struct nlmsghdr *rcvH,
+                         struct nlRouteList **nlRtList);
 
     /**
      * Used to generate a filter that will be applied to a list of routes.
+     * An AF_UNSPEC family takes the family of the first address of the
+     * filter, or matches IPv4 and IPv6 routes if it holds none.
+     * @param ctx [out] request context (holds the filter).
      * @param nlRtInfo [in] route info.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo);
+    int nlGenRouteFilter(struct nlContext *ctx, struct nlRouteInfo *nlRtInfo);
 
     /**
      * Used to reset the route filter handler.
+     * @param ctx [out] request context.
      */
-    void nlResetRouteFilter();
+    void nlResetRouteFilter(struct nlContext *ctx);
 
     /**
      * Used to create a nlRouteInfo structure with default values.
@@ -224,11 +589,16 @@ extern "C" {
     int nlCreateDefaultRtInfo(struct nlRouteInfo *nlRtInfo);
 
     /**
-     * Used to free a route info list.
-     * @param nlRtInfoList [out] routes list (one or more entries).
+     * Used to convert a route address to presentation format. An address
+     * the route has not got is an empty string.
+     * @param route [in] route.
+     * @param type [in] address attribute (RTA_DST | RTA_GATEWAY).
+     * @param buf [out] converted address.
+     * @param blen [in] converted address maximum length.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlFreeRouteInfoList(struct nlRouteInfoList *nlRtInfoList);
+    int nlRtAddr_n2a(const struct nlRoute *route, int type,
+                     char *buf, int blen);
 
     ////////////////////////////////////////////////////////////////////////////
 
@@ -238,7 +608,9 @@ extern "C" {
     ////////////////////////////////////////////////////////////////////////////
 
     /**
-     * Information of a single link.
+     * Information of a single link. The strings are handles of the request
+     * arena (ctx->arena), a link used as filter interns its strings there
+     * too, so they are compared as integers.
      */
     struct nlLinkInfo {
         unsigned char           family;            /**< AF_UNSPEC (from
@@ -259,19 +631,22 @@ extern "C" {
                                                       (IFLA_BROADCAST). */
         int                     broadcastLen;      /**< Used to store the length
                                                       of the broadcast. */
-        char                    ifname[IFNAMSIZ];  /**< Device name
-                                                      (IFLA_IFNAME). */
+        nlStrId                 ifname;            /**< Device name
+                                                      (IFLA_IFNAME,
+                                                      interned). */
         unsigned int            mtu;               /**< MTU of the device
                                                       (IFLA_MTU). */
         int                     link;              /**< Link type
                                                       (IFLA_LINK). */
-        char                    qdisc[64];         /**< Queueing discipline
-                                                      (IFLA_QDISC). */
+        nlStrId                 qdisc;             /**< Queueing discipline
+                                                      (IFLA_QDISC,
+                                                      interned). */
         struct net_device_stats stats;             /**< Interface statistics
                                                       (IFLA_STATS). */
         // IFLA_COST
         // IFLA_PRIORITY
-        // IFLA_MASTER
+        int                     master;            /**< Master device index
+                                                      (IFLA_MASTER). */
         // IFLA_WIRELESS
         // IFLA_PROTINFO
         int                     txqlen;            /**< Tx queue length. */
@@ -281,10 +656,14 @@ extern "C" {
         unsigned char           operstate;         /**< Operational state
                                                       (rfc 2863). */
         unsigned char           linkmode;          /**< Link mode. */
-        // IFLA_LINKINFO
+        nlStrId                 kind;              /**< Link kind, e.g. "vlan"
+                                                      (IFLA_INFO_KIND in
+                                                      IFLA_LINKINFO,
+                                                      interned). */
         // IFLA_NET_NS_PID
 #ifdef IFLA_IFALIAS
-        char                    ifalias[IFALIASZ]; /**< Interface alias. */
+        nlStrId                 ifalias;           /**< Interface alias
+                                                      (interned). */
 #endif //IFLA_IFALIAS
     };
 
@@ -302,35 +681,35 @@ extern "C" {
      * Struct used as link filter. If a field is deactivated (= 0),
      * it will be skiped.
      */
-    struct {
-        unsigned int family    : 1;
-        unsigned int type      : 1;
-        unsigned int index     : 1;
-        unsigned int flags     : 1;
-        unsigned int change    : 1;
-        unsigned int address   : 1;
-        unsigned int broadcast : 1;
-        unsigned int ifname    : 1;
-        unsigned int mtu       : 1;
-        unsigned int link      : 1;
-        unsigned int qdisc     : 1;
-        unsigned int stats     : 1;
+    struct nlLinkFilter {
+        unsigned char family;
+        unsigned char type;
+        unsigned char index;
+        unsigned char flags;
+        unsigned char change;
+        unsigned char address;
+        unsigned char broadcast;
+        unsigned char ifname;
+        unsigned char mtu;
+        unsigned char link;
+        unsigned char qdisc;
+        unsigned char stats;
         // IFLA_COST
         // IFLA_PRIORITY
-        // IFLA_MASTER
+        unsigned char master;
         // IFLA_WIRELESS
         // IFLA_PROTINFO
-        unsigned int txqlen    : 1;
-        unsigned int map       : 1;
+        unsigned char txqlen;
+        unsigned char map;
         // IFLA_WEIGHT
-        unsigned int operstate : 1;
-        unsigned int linkmode  : 1;
-        // IFLA_LINKINFO
+        unsigned char operstate;
+        unsigned char linkmode;
+        unsigned char kind;
         // IFLA_NET_NS_PID
 #ifdef IFLA_IFALIAS
-        unsigned int ifalias   : 1;
+        unsigned char ifalias;
 #endif //IFLA_IFALIAS
-    } linkFlt;
+    };
 
     /**
      * The list of link types.
@@ -379,45 +758,68 @@ extern "C" {
     /**
      * This function is used to get links using nlLinkInfo
      * structure as filter.
-     * @param nlLinkInfoList [out] links list (one or more entries).
+     * @param ctx [in] request context.
+     * @param nlLinkInfoList [out] links list (allocated from ctx->arena).
      * @param nlLinkInfo [in] link info used as filter.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlGetLinks(struct nlLinkInfoList **nlLinkInfoList,
+    int nlGetLinks(struct nlContext *ctx,
+                   struct nlLinkInfoList **nlLinkInfoList,
                    const struct nlLinkInfo *nlLinkInfo);
 
+    /**
+     * This function is used to get a single link without dumping every
+     * link: the kernel is asked for the link whose index (when index > 0)
+     * or ifname matches nlLinkInfo. The rest of nlLinkInfo is applied as
+     * filter. Without index and ifname, it behaves like nlGetLinks.
+     * @param ctx [in] request context.
+     * @param nlLinkInfoList [out] links list (empty if the link does not
+     * exist).
+     * @param nlLinkInfo [in] link info used as key and filter.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlGetLink(struct nlContext *ctx,
+                  struct nlLinkInfoList **nlLinkInfoList,
+                  const struct nlLinkInfo *nlLinkInfo);
+
     /**
      * This function is used to ADD/DELETE/MODIFY a link.
+     * @param ctx [in] request context.
      * @param nlLinkInfo [in] link info.
      * @param hType [in] message type (RTM_NEWLINK || RTM_DELLINK).
      * @param hFlags [in] message flags.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlModifyLink(const struct nlLinkInfo *nlLinkInfo, int hType,
+    int nlModifyLink(struct nlContext *ctx,
+                     const struct nlLinkInfo *nlLinkInfo, int hType,
                      unsigned int hFlags);
 
     /**
      * This function is used to add a link to specified links list.
+     * @param ctx [in] request context.
      * @param rcvH [in] link message header.
      * @param nlLinkInfoList [out] list where link will be added.
      * @param nlLinkInfo [in] link info.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlAddLinkToList(const struct nlmsghdr *rcvH,
+    int nlAddLinkToList(struct nlContext *ctx, const struct nlmsghdr *rcvH,
                         struct nlLinkInfoList **nlLinkInfoList,
                         const struct nlLinkInfo *nlLinkInfo);
 
     /**
      * Used to generate a filter that will be applied to a list of links.
+     * @param ctx [out] request context (holds the filter).
      * @param nlLinkInfo [in] link info.
      * @return NL_OK=succesful | NL_FAIL=fail
      */
-    int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo);
+    int nlGenLinkFilter(struct nlContext *ctx,
+                        const struct nlLinkInfo *nlLinkInfo);
 
     /**
      * Used to reset link filter handler.
+     * @param ctx [out] request context.
      */
-    void nlResetLinkFilter();
+    void nlResetLinkFilter(struct nlContext *ctx);
 
     /**
      * Used to create a nlLinkInfo structure with default values.
@@ -426,13 +828,6 @@ extern "C" {
      */
     int nlCreateDefaultLinkInfo(struct nlLinkInfo *nlLinkInfo);
 
-    /**
-     * Used to free a link info list.
-     * @param nlLinkInfoList [out] links list (one or more entries).
-     * @return NL_OK=succesful | NL_FAIL=fail
-     */
-    int nlFreeLinkInfoList(struct nlLinkInfoList *nlLinkInfoList);
-
     /**
      * Function to convert a L2 address from network representation to
      * string representation (user friendly).
@@ -455,6 +850,73 @@ extern "C" {
     ////////////////////////////////////////////////////////////////////////////
 
 
+    ////////////////////////////////////////////////////////////////////////////
+    // CONTEXT
+    ////////////////////////////////////////////////////////////////////////////
+
+    /**
+     * Request context. Everything a request needs is kept here instead of
+     * in globals, so several threads can use the library at the same time
+     * as long as each one uses its own context.
+     */
+    struct nlContext {
+        struct nlSockHandle *sh;        /**< Socket borrowed from the pool
+                                           (NULL until the first request). */
+        unsigned int         noPool;    /**< Use a private socket instead
+                                           of the pool: a child forked from
+                                           a threaded process could find
+                                           the pool lock held forever. */
+        char                *rcvBuf;    /**< Receive buffer (allocated on
+                                           first use). */
+        size_t               rcvBufLen; /**< Receive buffer length. */
+        struct nlUring      *uring;     /**< io_uring transport (io_uring
+                                           builds only, NULL otherwise). */
+        unsigned int         noUring;   /**< io_uring not usable, plain
+                                           syscalls are used. */
+        struct nlRouteFilter rtFlt;     /**< Route filter. */
+        struct nlLinkFilter  linkFlt;   /**< Link filter. */
+        unsigned int         noStats;   /**< Interface statistics are not
+                                           wanted: link requests set
+                                           RTEXT_FILTER_SKIP_STATS
+                                           (IFLA_EXT_MASK) and nlLinkInfo
+                                           stats are left zeroed. */
+        struct nlArena      *arena;     /**< Arena where the route and link
+                                           lists are allocated (set by the
+                                           caller, the lists live until it
+                                           is released). */
+        unsigned long long   rtAttrSkip;
+                                        /**< RTA_* attributes nobody asked
+                                           for (NL_ATTR_BIT), they are not
+                                           decoded unless the filter uses
+                                           them. */
+        unsigned long long   linkAttrSkip;
+                                        /**< IFLA_* attributes nobody asked
+                                           for (NL_ATTR_BIT). */
+    };
+
+    /**
+     * Bit of an attribute type in nlContext rtAttrSkip/linkAttrSkip.
+     * Types from 64 on have no bit and are always decoded.
+     */
+#define NL_ATTR_BIT(type) (((type) < 64) ? (1ULL << (type)) : 0ULL)
+
+    /**
+     * Used to initialize a request context.
+     * @param ctx [out] request context.
+     * @return NL_OK=succesful | NL_FAIL=fail
+     */
+    int nlCtxInit(struct nlContext *ctx);
+
+    /**
+     * Used to release a request context: the socket goes back to the pool
+     * and the buffers are freed.
+     * @param ctx [in] request context.
+     */
+    void nlCtxRelease(struct nlContext *ctx);
+
+    ////////////////////////////////////////////////////////////////////////////
+
+
 #ifdef __cplusplus
 }
 #endif //__cplusplus
@@ -47,15 +47,51 @@ extern "C" {
 #endif //MAXHOSTNAMELEN
 
     /**
-     * InstanceID format. It is supposed that it will be not changed.
+     * Legacy InstanceID format, still accepted by nhParseInstanceId. It is
+     * only generated to answer a request made with a legacy InstanceID (see
+     * nhConvIIdFormat): it was truncated for IPv6 routes with a gateway and
+     * routes only told apart by the metric shared it.
      * hostName|dstAddr|dstLen|table|outputIf|scope|gw
      */
 #define INSTANCEID_FORMAT "%s|%s|%d|%d|%d|%d|%s"
 
     /**
-     * InstanceID format for parse. It is supposed that it will be not changed.
+     * Compact InstanceID (version 1): NH_IID_VERSION followed by the route
+     * key in base64url (RFC 4648, no padding). It has a fixed width and no
+     * '|', so it is told apart from the legacy format. Key layout (fields
+     * in network byte order, absent addresses zeroed):
+     *   0 family | 1 dstLen | 2 tos | 3 scope | 4-7 table | 8-11 outputIf |
+     *   12-15 priority | 16-31 dstAddr | 32-47 gw
      */
-#define INSTANCEID_FORMAT_PARSE "%[^|]|%[^|]|%d|%d|%d|%d|%[^|]"
+#define NH_IID_VERSION '1' /**< Compact InstanceID version. */
+#define NH_IID_KEY_LEN 48  /**< Route key length. */
+#define NH_IID_LEN     65  /**< Compact InstanceID length (version plus
+                              NH_IID_KEY_LEN*4/3 characters). */
+
+    /**
+     * Requested properties (CIM property list). InstanceID is the key and
+     * is always filled.
+     */
+#define NH_P_ADDRESS_TYPE      0x00000001 /**< AddressType. */
+#define NH_P_ADMIN_DISTANCE    0x00000002 /**< AdminDistance. */
+#define NH_P_CAPTION           0x00000004 /**< Caption. */
+#define NH_P_DESCRIPTION       0x00000008 /**< Description. */
+#define NH_P_DST_ADDRESS       0x00000010 /**< DestinationAddress. */
+#define NH_P_DST_MASK          0x00000020 /**< DestinationMask. */
+#define NH_P_ELEMENT_NAME      0x00000040 /**< ElementName. */
+#define NH_P_IS_STATIC         0x00000080 /**< IsStatic. */
+#define NH_P_OTHER_DERIVATION  0x00000100 /**< OtherDerivation. */
+#define NH_P_PREFIX_LENGTH     0x00000200 /**< PrefixLength. */
+#define NH_P_ROUTE_DERIVATION  0x00000400 /**< RouteDerivation. */
+#define NH_P_ROUTE_GATEWAY     0x00000800 /**< RouteGateway. */
+#define NH_P_ROUTE_METRIC      0x00001000 /**< RouteMetric. */
+#define NH_P_ROUTE_OUTPUT_IF   0x00002000 /**< RouteOutputIf. */
+#define NH_P_ROUTE_SCOPE       0x00004000 /**< RouteScope. */
+#define NH_P_ROUTE_TABLE       0x00008000 /**< RouteTable. */
+#define NH_P_ROUTE_TYPE        0x00010000 /**< RouteType. */
+#define NH_P_TYPE_OF_ROUTE     0x00020000 /**< TypeOfRoute. */
+#define NH_P_NONE              0x00000000 /**< Only the key. */
+#define NH_P_ALL               0xFFFFFFFF /**< Every property. */
 
     /**
      * CIM - Describes the format of the address properties.
@@ -141,7 +177,9 @@ extern "C" {
     };
 
     /**
-     * This structure stores the route's properties.
+     * This structure stores the route's properties in CIM format. The
+     * routes are listed as nlRoute records and rendered to this structure
+     * one at a time, when the CIM instance is built (see nlRouteTOnh).
      */
     struct nextHopIP {
         unsigned short addressType;         /**< The format of the address
@@ -158,8 +196,9 @@ extern "C" {
                                                address. */
         char           elementName[64];     /**< User-friendly name for the
                                                object. */
-        char           instanceID[64];      /**< Opaquely and uniquely identify
-                                               an instance of this class. */
+        char           instanceID[72];      /**< Opaquely and uniquely identify
+                                               an instance of this class
+                                               (NH_IID_LEN plus NUL). */
         unsigned short isStatic;            /**< TRUE indicates that this is
                                                a static route. */
         char           otherDerivation[64]; /**< A string describing how the
@@ -181,39 +220,52 @@ extern "C" {
     };
 
     /**
-     * This structure is used as NextHopIPRoutes list.
+     * Conversion context of a CIM operation (see nhConvInit). What every
+     * route needs to be rendered is resolved once and shared by the
+     * nlRouteTOnh calls of the operation.
      */
-    struct nextHopIPList {
-        struct nextHopIP     *sptr;  /**< Pointer to current position
-                                        in the list. */
-        struct nextHopIPList *next;  /**< Pointer to next position
-                                        in the list. */
+    struct nhConv {
+        struct nlArena *arena;    /**< Request arena (the interface names
+                                     live in it). */
+        nlStrId        *ifNames;  /**< Interned interface name by index
+                                     (NULL when not needed). */
+        unsigned int    ifCount;  /**< Entries of ifNames. */
+        char           *hostName; /**< Host name of the legacy InstanceIDs
+                                     (NULL when compact InstanceIDs are
+                                     rendered). */
     };
 
     /**
      * This functions is used to get a list of routes based on nlRtInfo
      * filter.
-     * @param nHopIPList [out] routes struct to be filled.
+     * @param arena [in] request arena the list is allocated from.
+     * @param nlRtList [out] routes list (in kernel order).
      * @param nlRtInfo [in] route info.
      * @return NH_OK=succesful | NH_FAIL=fail
      */
-    int getIPRoutes(struct nextHopIPList **nHopIPList,
+    int getIPRoutes(struct nlArena *arena, struct nlRouteList **nlRtList,
                     struct nlRouteInfo *nlRtInfo);
 
     /**
      * This functions is used to get all ipv4 and ipv6 routes from fib.
-     * @param nHopIPList [out] routes struct to be filled.
+     * @param arena [in] request arena the list is allocated from.
+     * @param nlRtList [out] routes list.
      * @return NH_OK=succesful | NH_FAIL=fail
      */
-    int getAllIPRoutes(struct nextHopIPList **nHopIPList);
+    int getAllIPRoutes(struct nlArena *arena, struct nlRouteList **nlRtList);
 
     /**
      * This functions is used to get a route base on specified InstanceID.
-     * @param nHopIPList [out] routes struct to be filled.
+     * The route key must match exactly (a legacy InstanceID has no TOS nor
+     * priority and its scope 0 matches any scope).
+     * @param arena [in] request arena the list is allocated from.
+     * @param nlRtList [out] routes list (at most one route).
      * @param instanceId [in] route InstanceID.
-     * @return NH_OK=succesful | NH_FAIL=fail
+     * @return NH_OK=succesful | NH_FAIL=fail (the InstanceID names several
+     *         routes)
      */
-    int getIPRouteIId(struct nextHopIPList **nHopIPList, const char *instanceId);
+    int getIPRouteIId(struct nlArena *arena, struct nlRouteList **nlRtList,
+                      const char *instanceId);
 
     /**
      * This function is used to add a new route to FIB.
@@ -223,21 +275,14 @@ extern "C" {
     int addIPRoute(struct nextHopIP *nHopIP);
 
     /**
-     * This function is used to delete a route from FIB.
+     * This function is used to delete a route from FIB. The InstanceID is
+     * resolved by getIPRouteIId first, so only the route it names is
+     * deleted.
      * @param nHopIP [in] route to be deleted.
      * @return NH_OK=succesful | NH_FAIL=fail
      */
     int delIPRoute(const struct nextHopIP *nHopIP);
 
-    /**
-     * Converts a nlRouteInfoList structure to nextHopIPList strucutre.
-     * @param nlRtInfoList [in] list to be converted.
-     * @param nHopIPList [out] converted list.
-     * @return NH_OK=succesful | NH_FAIL=fail
-     */
-    int nlListTOnhList(struct nlRouteInfoList **nlRtInfoList,
-                       struct nextHopIPList **nHopIPList);
-
     /**
      * Converts a nextHopIP structure to nlRouteInfo structure.
      * @param nHopIP [in] structure to be converted.
@@ -247,12 +292,89 @@ extern "C" {
     int nhTOnlInfo(struct nextHopIP *nHopIP, struct nlRouteInfo *nlRtInfo);
 
     /**
-     * Converts a nlRouteInfo structure to nextHopIP structure.
-     * @param nlRtInfo [in] structure to be converted.
+     * Used to create the conversion context of a CIM operation. The
+     * interface names are taken from a single link dump when the
+     * Description is requested.
+     * @param conv [out] conversion context.
+     * @param arena [in] request arena.
+     * @param props [in] requested properties (NH_P_*) of the operation.
+     * @return NH_OK=succesful | NH_FAIL=fail
+     */
+    int nhConvInit(struct nhConv *conv, struct nlArena *arena,
+                   unsigned int props);
+
+    /**
+     * Used to render the InstanceIDs of a conversion context in the format
+     * of the one a client sent: a legacy InstanceID is answered with legacy
+     * ones, a compact InstanceID with compact ones.
+     * @param conv [in/out] conversion context (see nhConvInit).
+     * @param instanceId [in] InstanceID sent by the client.
+     * @return NH_OK=succesful | NH_FAIL=fail
+     */
+    int nhConvIIdFormat(struct nhConv *conv, const char *instanceId);
+
+    /**
+     * Used to get the name of an interface from a conversion context.
+     * @param conv [in] conversion context.
+     * @param ifindex [in] interface index.
+     * @return interface name ("" if unknown).
+     */
+    const char* nhConvIfName(const struct nhConv *conv, unsigned int ifindex);
+
+    /**
+     * Converts a nlRoute record to nextHopIP structure. Only the
+     * requested properties and the InstanceID are filled.
+     * @param conv [in] conversion context (created for props at least).
+     * @param route [in] route to be converted.
      * @param nHopIP [out] converted structure.
+     * @param props [in] requested properties (NH_P_*).
      * @return NH_OK=succesful | NH_FAIL=fail
      */
-    int nlInfoTOnh(const struct nlRouteInfo *nlRtInfo, struct nextHopIP *nHopIP);
+    int nlRouteTOnh(const struct nhConv *conv, const struct nlRoute *route,
+                    struct nextHopIP *nHopIP, unsigned int props);
+
+    /**
+     * Used to parse an InstanceID, compact or legacy (INSTANCEID_FORMAT),
+     * in a single pass. The numeric keys are stored as they are parsed,
+     * the addresses are validated and give the filter family.
+     * @param instanceId [in] InstanceID.
+     * @param nlRtInfo [in/out] route filter (see nlCreateDefaultRtInfo).
+     * @return NH_OK=succesful | NH_FAIL=invalid InstanceID
+     */
+    int nhParseInstanceId(const char *instanceId,
+                          struct nlRouteInfo *nlRtInfo);
+
+    /**
+     * Used to get the key of a route (see NH_IID_VERSION).
+     * @param route [in] route.
+     * @param key [out] route key (NH_IID_KEY_LEN bytes).
+     */
+    void nhRouteKey(const struct nlRoute *route, unsigned char *key);
+
+    /**
+     * Used to get the key of a route given in CIM format (CreateInstance
+     * and SetInstance). The TOS is not part of the class, it is 0.
+     * @param nHopIP [in] route.
+     * @param key [out] route key (NH_IID_KEY_LEN bytes).
+     * @return NH_OK=succesful | NH_FAIL=invalid addresses
+     */
+    int nhNextHopKey(const struct nextHopIP *nHopIP, unsigned char *key);
+
+    /**
+     * Used to encode a route key as compact InstanceID.
+     * @param key [in] route key (NH_IID_KEY_LEN bytes).
+     * @param instanceId [out] InstanceID (NH_IID_LEN+1 bytes).
+     */
+    void nhEncodeInstanceId(const unsigned char *key, char *instanceId);
+
+    /**
+     * Used to decode a compact InstanceID. Only the canonical encoding of
+     * a valid key is accepted, so equal keys mean equal InstanceIDs.
+     * @param instanceId [in] InstanceID.
+     * @param key [out] route key (NH_IID_KEY_LEN bytes).
+     * @return NH_OK=succesful | NH_FAIL=not a compact InstanceID
+     */
+    int nhDecodeInstanceId(const char *instanceId, unsigned char *key);
 
     /**
      * Used to get CIM address type from specified route address.
@@ -270,11 +392,10 @@ extern "C" {
     int getAddrTypeStr(int addressType, char *addrTypeStr);
 
     /**
-     * This function is used to clean a nextHopIP list.
-     * @param lptr [in] list to be cleaned.
-     * @return NH_OK=succesful | NH_FAIL=fail
+     * This function is used to release the resources kept between requests
+     * (netlink sockets). Called from the provider cleanup.
      */
-    int freeNextHopIPList(struct nextHopIPList *lptr);
+    void cleanupIPRoutes();
 
     ////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,93 @@
+#ifndef _OSBASE_PARSE_H_
+#define _OSBASE_PARSE_H_
+
+/**
+ * @file
+ * OSBase_Parse.h
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Text parsing.
+ * Single pass parsers for the text fields the providers receive: IPv4 and
+ * IPv6 literals (same acceptance as inet_pton in glibc, the family is told
+ * by the parse itself), decimal fields and the interface index of a
+ * LANEndpoint ElementName. They work on length bounded fields, so the
+ * fields of a key are parsed in place. It does not depend on the CIM
+ * layer.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+    ////////////////////////////////////////////////////////////////////////////
+    // TEXT PARSING
+    ////////////////////////////////////////////////////////////////////////////
+
+    /**
+     * Used to parse an IPv4 dotted-quad literal.
+     * @param s [in] text.
+     * @param len [in] text length.
+     * @param addr [out] address (4 bytes, network byte order).
+     * @return 1=valid | 0=invalid (addr is undefined)
+     */
+    int nlParseIPv4(const char *s, size_t len, unsigned char *addr);
+
+    /**
+     * Used to parse an IPv6 literal (with "::" compression and IPv4
+     * dotted-quad tail).
+     * @param s [in] text.
+     * @param len [in] text length.
+     * @param addr [out] address (16 bytes, network byte order).
+     * @return 1=valid | 0=invalid (addr is undefined)
+     */
+    int nlParseIPv6(const char *s, size_t len, unsigned char *addr);
+
+    /**
+     * Used to parse an address literal of any family. The family is told
+     * by the text, so it is parsed once.
+     * @param s [in] text.
+     * @param len [in] text length.
+     * @param addr [out] address (16 bytes, network byte order, IPv4 in
+     *        the first 4 bytes).
+     * @return AF_INET | AF_INET6 | AF_UNSPEC=empty or invalid
+     */
+    int nlParseAddr(const char *s, size_t len, unsigned char *addr);
+
+    /**
+     * Used to parse a decimal field (optional '-' and digits).
+     * @param s [in] text.
+     * @param end [in] end of the text.
+     * @param val [out] value.
+     * @return first character after the field | NULL=invalid or out of
+     *         int range
+     */
+    const char* nlParseInt(const char *s, const char *end, int *val);
+
+    /**
+     * Used to get the interface index of a LANEndpoint ElementName
+     * ("ifname_ifindex", the ifname could contain '_').
+     * @param elementName [in] ElementName.
+     * @param ifindex [out] interface index.
+     * @return 1=found | 0=invalid ElementName
+     */
+    int nlParseIfIndex(const char *elementName, int *ifindex);
+
+    ////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+#endif //_OSBASE_PARSE_H_
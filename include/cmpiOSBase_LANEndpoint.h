@@ -48,12 +48,20 @@ CMPIObjectPath* _makePath_LANEndpoint(const CMPIBroker *_broker,
                                       const struct LANEndpoint *LANEP,
                                       CMPIStatus *rc);
 
+/**
+ * Method to get the requested properties of a property list.
+ * @param properties [in] CIM property list (NULL = every property).
+ * @return requested properties (LEP_P_*).
+ */
+unsigned int _propMask_LANEndpoint(const char **properties);
+
 /**
  * Method to create a CMPIInstance of this class.
  * @param _broker [in] CIM Object Manager.
  * @param ctx [in] Context object.
  * @param cop [in] Source objectPath.
  * @param properties [in]
+ * @param props [in] requested properties (see _propMask_LANEndpoint).
  * @param LANEP [in] LANEndpoint instance.
  * @param rc [in] cim status.
  * @return created LANEndpoint instance.
@@ -62,6 +70,7 @@ CMPIInstance* _makeInst_LANEndpoint(const CMPIBroker *_broker,
                                     const CMPIContext *ctx,
                                     const CMPIObjectPath *cop,
                                     const char **properties,
+                                    unsigned int props,
                                     const struct LANEndpoint *LANEP,
                                     CMPIStatus *rc);
 
@@ -38,23 +38,34 @@ static char *_ClassName = "Linux_NextHopIPRoute";
  * @param _broker [in] CIM Object Manager.
  * @param ctx [in] Context object.
  * @param cop [in] Source objectPath.
- * @param NHop [in] nextHopIP instance.
+ * @param conv [in] conversion context of the operation.
+ * @param route [in] route.
  * @param rc [in] cim status.
  * @return created NextHopIPRoute ObjectPath.
  */
 CMPIObjectPath* _makePath_NextHopIPRoute(const CMPIBroker *_broker,
                                          const CMPIContext *ctx,
                                          const CMPIObjectPath *cop,
-                                         const struct nextHopIP *NHop,
+                                         const struct nhConv *conv,
+                                         const struct nlRoute *route,
                                          CMPIStatus *rc);
 
+/**
+ * Method to get the requested properties of a property list.
+ * @param properties [in] CIM property list (NULL = every property).
+ * @return requested properties (NH_P_*).
+ */
+unsigned int _propMask_NextHopIPRoute(const char **properties);
+
 /**
  * Method to create a CMPIInstance of this class.
  * @param _broker [in] CIM Object Manager.
  * @param ctx [in] Context object.
  * @param cop [in] Source objectPath.
  * @param properties [in]
- * @param NHop [in] nextHopIP instance.
+ * @param props [in] requested properties (see _propMask_NextHopIPRoute).
+ * @param conv [in] conversion context of the operation.
+ * @param route [in] route (rendered to CIM format here).
  * @param rc [in] cim status.
  * @return created NextHopIPRoute instance.
  */
@@ -62,7 +73,9 @@ CMPIInstance* _makeInst_NextHopIPRoute(const CMPIBroker *_broker,
                                        const CMPIContext *ctx,
                                        const CMPIObjectPath *cop,
                                        const char **properties,
-                                       const struct nextHopIP *NHop,
+                                       unsigned int props,
+                                       const struct nhConv *conv,
+                                       const struct nlRoute *route,
                                        CMPIStatus *rc);
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -121,8 +121,9 @@ CMPIStatus* _assoc_get_NextHopRoute_insts(const CMPIBroker *_broker,
                                           CMPIStatus *rc);
 
 /**
- * Retrieve a list of instances from target class (CIM_ProtocolEndpoint
- * subclass), associated to source class.
+ * Retrieve the instance of target class (CIM_ProtocolEndpoint subclass)
+ * associated to source class. The endpoint of the route output interface
+ * is got by key, endpoints are not enumerated.
  * @param _broker [in] CIM Object Manager.
  * @param ctx [in] context object.
  * @param rslt [in] result.
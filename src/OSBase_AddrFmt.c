@@ -0,0 +1,323 @@
+/**
+ * @file
+ * OSBase_AddrFmt.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Address formatting.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <sys/socket.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define NL_FMT_SSE2
+#endif
+
+#include "OSBase_AddrFmt.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TABLES
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Lower case hex digits.
+ */
+static const char nlFmtHexDigit[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+/**
+ * Decimal text of every byte value: up to three digits (zero padded on
+ * the right) and the number of digits in the last position. Four bytes
+ * are always copied and the output advanced by the number of digits.
+ */
+static const char nlFmtDec[256][4] = {
+    {'0',0,0,1}, {'1',0,0,1}, {'2',0,0,1}, {'3',0,0,1},
+    {'4',0,0,1}, {'5',0,0,1}, {'6',0,0,1}, {'7',0,0,1},
+    {'8',0,0,1}, {'9',0,0,1}, {'1','0',0,2}, {'1','1',0,2},
+    {'1','2',0,2}, {'1','3',0,2}, {'1','4',0,2}, {'1','5',0,2},
+    {'1','6',0,2}, {'1','7',0,2}, {'1','8',0,2}, {'1','9',0,2},
+    {'2','0',0,2}, {'2','1',0,2}, {'2','2',0,2}, {'2','3',0,2},
+    {'2','4',0,2}, {'2','5',0,2}, {'2','6',0,2}, {'2','7',0,2},
+    {'2','8',0,2}, {'2','9',0,2}, {'3','0',0,2}, {'3','1',0,2},
+    {'3','2',0,2}, {'3','3',0,2}, {'3','4',0,2}, {'3','5',0,2},
+    {'3','6',0,2}, {'3','7',0,2}, {'3','8',0,2}, {'3','9',0,2},
+    {'4','0',0,2}, {'4','1',0,2}, {'4','2',0,2}, {'4','3',0,2},
+    {'4','4',0,2}, {'4','5',0,2}, {'4','6',0,2}, {'4','7',0,2},
+    {'4','8',0,2}, {'4','9',0,2}, {'5','0',0,2}, {'5','1',0,2},
+    {'5','2',0,2}, {'5','3',0,2}, {'5','4',0,2}, {'5','5',0,2},
+    {'5','6',0,2}, {'5','7',0,2}, {'5','8',0,2}, {'5','9',0,2},
+    {'6','0',0,2}, {'6','1',0,2}, {'6','2',0,2}, {'6','3',0,2},
+    {'6','4',0,2}, {'6','5',0,2}, {'6','6',0,2}, {'6','7',0,2},
+    {'6','8',0,2}, {'6','9',0,2}, {'7','0',0,2}, {'7','1',0,2},
+    {'7','2',0,2}, {'7','3',0,2}, {'7','4',0,2}, {'7','5',0,2},
+    {'7','6',0,2}, {'7','7',0,2}, {'7','8',0,2}, {'7','9',0,2},
+    {'8','0',0,2}, {'8','1',0,2}, {'8','2',0,2}, {'8','3',0,2},
+    {'8','4',0,2}, {'8','5',0,2}, {'8','6',0,2}, {'8','7',0,2},
+    {'8','8',0,2}, {'8','9',0,2}, {'9','0',0,2}, {'9','1',0,2},
+    {'9','2',0,2}, {'9','3',0,2}, {'9','4',0,2}, {'9','5',0,2},
+    {'9','6',0,2}, {'9','7',0,2}, {'9','8',0,2}, {'9','9',0,2},
+    {'1','0','0',3}, {'1','0','1',3}, {'1','0','2',3}, {'1','0','3',3},
+    {'1','0','4',3}, {'1','0','5',3}, {'1','0','6',3}, {'1','0','7',3},
+    {'1','0','8',3}, {'1','0','9',3}, {'1','1','0',3}, {'1','1','1',3},
+    {'1','1','2',3}, {'1','1','3',3}, {'1','1','4',3}, {'1','1','5',3},
+    {'1','1','6',3}, {'1','1','7',3}, {'1','1','8',3}, {'1','1','9',3},
+    {'1','2','0',3}, {'1','2','1',3}, {'1','2','2',3}, {'1','2','3',3},
+    {'1','2','4',3}, {'1','2','5',3}, {'1','2','6',3}, {'1','2','7',3},
+    {'1','2','8',3}, {'1','2','9',3}, {'1','3','0',3}, {'1','3','1',3},
+    {'1','3','2',3}, {'1','3','3',3}, {'1','3','4',3}, {'1','3','5',3},
+    {'1','3','6',3}, {'1','3','7',3}, {'1','3','8',3}, {'1','3','9',3},
+    {'1','4','0',3}, {'1','4','1',3}, {'1','4','2',3}, {'1','4','3',3},
+    {'1','4','4',3}, {'1','4','5',3}, {'1','4','6',3}, {'1','4','7',3},
+    {'1','4','8',3}, {'1','4','9',3}, {'1','5','0',3}, {'1','5','1',3},
+    {'1','5','2',3}, {'1','5','3',3}, {'1','5','4',3}, {'1','5','5',3},
+    {'1','5','6',3}, {'1','5','7',3}, {'1','5','8',3}, {'1','5','9',3},
+    {'1','6','0',3}, {'1','6','1',3}, {'1','6','2',3}, {'1','6','3',3},
+    {'1','6','4',3}, {'1','6','5',3}, {'1','6','6',3}, {'1','6','7',3},
+    {'1','6','8',3}, {'1','6','9',3}, {'1','7','0',3}, {'1','7','1',3},
+    {'1','7','2',3}, {'1','7','3',3}, {'1','7','4',3}, {'1','7','5',3},
+    {'1','7','6',3}, {'1','7','7',3}, {'1','7','8',3}, {'1','7','9',3},
+    {'1','8','0',3}, {'1','8','1',3}, {'1','8','2',3}, {'1','8','3',3},
+    {'1','8','4',3}, {'1','8','5',3}, {'1','8','6',3}, {'1','8','7',3},
+    {'1','8','8',3}, {'1','8','9',3}, {'1','9','0',3}, {'1','9','1',3},
+    {'1','9','2',3}, {'1','9','3',3}, {'1','9','4',3}, {'1','9','5',3},
+    {'1','9','6',3}, {'1','9','7',3}, {'1','9','8',3}, {'1','9','9',3},
+    {'2','0','0',3}, {'2','0','1',3}, {'2','0','2',3}, {'2','0','3',3},
+    {'2','0','4',3}, {'2','0','5',3}, {'2','0','6',3}, {'2','0','7',3},
+    {'2','0','8',3}, {'2','0','9',3}, {'2','1','0',3}, {'2','1','1',3},
+    {'2','1','2',3}, {'2','1','3',3}, {'2','1','4',3}, {'2','1','5',3},
+    {'2','1','6',3}, {'2','1','7',3}, {'2','1','8',3}, {'2','1','9',3},
+    {'2','2','0',3}, {'2','2','1',3}, {'2','2','2',3}, {'2','2','3',3},
+    {'2','2','4',3}, {'2','2','5',3}, {'2','2','6',3}, {'2','2','7',3},
+    {'2','2','8',3}, {'2','2','9',3}, {'2','3','0',3}, {'2','3','1',3},
+    {'2','3','2',3}, {'2','3','3',3}, {'2','3','4',3}, {'2','3','5',3},
+    {'2','3','6',3}, {'2','3','7',3}, {'2','3','8',3}, {'2','3','9',3},
+    {'2','4','0',3}, {'2','4','1',3}, {'2','4','2',3}, {'2','4','3',3},
+    {'2','4','4',3}, {'2','4','5',3}, {'2','4','6',3}, {'2','4','7',3},
+    {'2','4','8',3}, {'2','4','9',3}, {'2','5','0',3}, {'2','5','1',3},
+    {'2','5','2',3}, {'2','5','3',3}, {'2','5','4',3}, {'2','5','5',3}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ADDRESS FORMATTING
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+int nlFmtIPv4(const unsigned char *addr, char *buf)
+{
+    char *p = buf; // Current output position.
+
+    // The last copy ends at most at buf[15], the NUL position.
+    memcpy(p, nlFmtDec[addr[0]], 4);
+    p += nlFmtDec[addr[0]][3];
+    *p++ = '.';
+    memcpy(p, nlFmtDec[addr[1]], 4);
+    p += nlFmtDec[addr[1]][3];
+    *p++ = '.';
+    memcpy(p, nlFmtDec[addr[2]], 4);
+    p += nlFmtDec[addr[2]][3];
+    *p++ = '.';
+    memcpy(p, nlFmtDec[addr[3]], 4);
+    p += nlFmtDec[addr[3]][3];
+    *p = '\0';
+
+    return (int)(p - buf);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get the hex digits of the eight words of an IPv6 address (four
+ * digits per word, leading zeros included) and the mask of the zero words
+ * (bit i = word i).
+ * @param addr [in] address (16 bytes, network byte order).
+ * @param hex [out] hex digits (32 bytes, not terminated).
+ * @return zero words mask.
+ */
+static unsigned int nlFmtIPv6Hex(const unsigned char *addr, char *hex)
+{
+#if defined(NL_FMT_SSE2)
+    const __m128i low   = _mm_set1_epi8(0x0F);
+    const __m128i nine  = _mm_set1_epi8(9);
+    const __m128i zero  = _mm_set1_epi8('0');
+    const __m128i alpha = _mm_set1_epi8('a' - '0' - 10);
+    __m128i v  = _mm_loadu_si128((const __m128i*)addr);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low);
+    __m128i lo = _mm_and_si128(v, low);
+    __m128i d0 = _mm_unpacklo_epi8(hi, lo); // Words 0-3.
+    __m128i d1 = _mm_unpackhi_epi8(hi, lo); // Words 4-7.
+    __m128i z  = _mm_cmpeq_epi16(v, _mm_setzero_si128());
+
+    d0 = _mm_add_epi8(_mm_add_epi8(d0, zero),
+                      _mm_and_si128(_mm_cmpgt_epi8(d0, nine), alpha));
+    d1 = _mm_add_epi8(_mm_add_epi8(d1, zero),
+                      _mm_and_si128(_mm_cmpgt_epi8(d1, nine), alpha));
+    _mm_storeu_si128((__m128i*)hex, d0);
+    _mm_storeu_si128((__m128i*)(hex + 16), d1);
+
+    // One byte per word (0xFF = zero word), then one bit per word.
+    return (unsigned int)_mm_movemask_epi8(_mm_packs_epi16(z, z)) & 0xFF;
+#else
+    unsigned int zmask = 0; // Zero words mask.
+    int          i     = 0; // Current byte.
+
+    for(i=0 ; i<16 ; i++) {
+        hex[2*i]   = nlFmtHexDigit[addr[i] >> 4];
+        hex[2*i+1] = nlFmtHexDigit[addr[i] & 0x0F];
+    }
+    for(i=0 ; i<8 ; i++) {
+        zmask |= (unsigned int)((addr[2*i] | addr[2*i+1]) == 0) << i;
+    }
+    return zmask;
+#endif
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlFmtIPv6(const unsigned char *addr, char *buf)
+{
+    char          hex[36];       // Hex digits of every word (padded
+                                 // for the 4 bytes copies).
+    unsigned int  zmask = 0;     // Zero words mask.
+    unsigned int  run   = 0;     // Words starting a zero run of len words.
+    unsigned int  word  = 0;     // Current word value.
+    int           base  = -1;    // First word of the compressed run.
+    int           len   = 0;     // Length of the compressed run.
+    int           n     = 0;     // Digits of the current word.
+    int           i     = 0;     // Current word.
+    char         *p     = buf;   // Current output position.
+
+    zmask = nlFmtIPv6Hex(addr, hex);
+
+    // After k steps bit i is set when words i..i+k are zero, so the last
+    // non empty mask gives the longest run and its lowest bit the first
+    // one of that length.
+    run = zmask;
+    while(run != 0) {
+        zmask = run;
+        run &= run >> 1;
+        len++;
+    }
+    if(len >= 2) {
+        base = __builtin_ctz(zmask);
+    } else {
+        len = 0;
+    }
+
+    for(i=0 ; i<8 ; ) {
+        if(i == base) {
+            *p++ = ':';
+            i += len;
+            continue;
+        }
+        if(i != 0) {
+            *p++ = ':';
+        }
+        // IPv4 compatible (::a.b.c.d) or mapped (::ffff:a.b.c.d).
+        if(i == 6 && base == 0 &&
+           (len == 6 || (len == 5 && addr[10] == 0xFF && addr[11] == 0xFF))) {
+            return (int)(p - buf) + nlFmtIPv4(addr + 12, p);
+        }
+        // Leading zeros are not written (at least one digit is).
+        word = ((unsigned int)addr[2*i] << 8) | addr[2*i+1];
+        n = 1 + (word > 0xF) + (word > 0xFF) + (word > 0xFFF);
+        memcpy(p, hex + 4*i + 4 - n, 4);
+        p += n;
+        i++;
+    }
+    if(base != -1 && base + len == 8) {
+        *p++ = ':';
+    }
+    *p = '\0';
+
+    return (int)(p - buf);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlFmtAddr(int family, const unsigned char *addr, char *buf, int blen)
+{
+    char tmp[NL_FMT_IPV6_MAXLEN]; // Used when buf could be too small.
+    int  len = 0;                 // Converted address length.
+
+    if(family == AF_INET) {
+        if(blen >= NL_FMT_IPV4_MAXLEN) {
+            return nlFmtIPv4(addr, buf);
+        }
+        len = nlFmtIPv4(addr, tmp);
+    } else if(family == AF_INET6) {
+        if(blen >= NL_FMT_IPV6_MAXLEN) {
+            return nlFmtIPv6(addr, buf);
+        }
+        len = nlFmtIPv6(addr, tmp);
+    } else {
+        return -1;
+    }
+
+    if(len >= blen) {
+        return -1;
+    }
+    memcpy(buf, tmp, len + 1);
+    return len;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlFmtMAC(const unsigned char *addr, int alen, char *buf, int blen)
+{
+    char *p   = buf; // Current output position.
+    int   len = 0;   // Converted address length.
+    int   i   = 0;   // Current byte.
+
+    // alen bytes take 3*alen-1 characters. Bytes that do not fit at all
+    // are dropped, the last one is cut by the terminator.
+    if(alen > (blen + 2) / 3) {
+        alen = (blen + 2) / 3;
+    }
+    if(alen <= 0) {
+        buf[0] = '\0';
+        return 0;
+    }
+
+    for(i=0 ; i<alen-1 ; i++) {
+        p[0] = nlFmtHexDigit[addr[i] >> 4];
+        p[1] = nlFmtHexDigit[addr[i] & 0x0F];
+        p[2] = ':';
+        p += 3;
+    }
+    len = 3*alen - 1;
+    if(len < blen) {
+        p[0] = nlFmtHexDigit[addr[i] >> 4];
+        p[1] = nlFmtHexDigit[addr[i] & 0x0F];
+    } else {
+        len = blen - 1;
+        if(len > (int)(p - buf)) {
+            p[0] = nlFmtHexDigit[addr[i] >> 4];
+        }
+    }
+    buf[len] = '\0';
+
+    return len;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
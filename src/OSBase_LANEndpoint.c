@@ -35,6 +35,11 @@
 // COMMON
 ////////////////////////////////////////////////////////////////////////////////
 
+const unsigned short lepAvailReqStates[LEP_AVAIL_REQ_STATES_MAX] = {
+    LEP_RS_ENABLED, LEP_RS_DISABLED, LEP_RS_SHUT_DOWN, LEP_RS_OFFLINE,
+    LEP_RS_TEST, LEP_RS_DEFERRED, LEP_RS_QUIESCE, LEP_RS_REBOOT, LEP_RS_RESET
+};
+
 //------------------------------------------------------------------------------
 /**
  * This function converts from datetime string interval to total number
@@ -63,14 +68,45 @@ unsigned long datetime_str_interval_to_ms(const char *pDatetimeString) {
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int getLANEndpoints(struct LANEndpointList **lanEPList,
-                    const struct nlLinkInfo *nlLinkInfo)
+/**
+ * Used to get the link attributes that are not needed to fill the
+ * requested properties. The keys only need the ifname.
+ * @param props [in] requested properties (LEP_P_*).
+ * @return attributes to skip (NL_ATTR_BIT).
+ */
+static unsigned long long lepLinkAttrSkip(unsigned int props)
+{
+    unsigned long long need = NL_ATTR_BIT(IFLA_IFNAME); // Attributes needed.
+
+    if(props & (LEP_P_MAC_ADDRESS | LEP_P_INSTANCE_ID)) {
+        need |= NL_ATTR_BIT(IFLA_ADDRESS);
+    }
+    if(props & LEP_P_MAX_DATA_SIZE) {
+        need |= NL_ATTR_BIT(IFLA_MTU);
+    }
+    if(props & LEP_P_STATUS) {
+        need |= NL_ATTR_BIT(IFLA_OPERSTATE);
+    }
+    return ~need;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int getLANEndpoints(struct nlArena *arena, struct LANEndpointList **lanEPList,
+                    const struct nlLinkInfo *nlLinkInfo, unsigned int props)
 {
     _OSBASE_TRACE(3, ("--- getLANEndpoints() called"));
 
+    struct nlContext       ctx;           // Netlink request context.
     struct nlLinkInfoList *list = NULL;   // Netlink links list.
     int                    rc   = LEP_OK; // Result handler.
 
+    nlCtxInit(&ctx);
+    ctx.arena        = arena;
+    ctx.linkAttrSkip = lepLinkAttrSkip(props);
+    // LANEndpoint does not report interface statistics.
+    ctx.noStats      = 1;
+
     // Check link info (used as filter).
     if(nlLinkInfo == NULL) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid filter."));
@@ -78,30 +114,15 @@ int getLANEndpoints(struct LANEndpointList **lanEPList,
         goto out;
     }
 
-    // Open netlink socket.
-    if(nlOpenSocket() != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Unable to open netlink socket."));
-        rc = LEP_FAIL;
-        goto out;
-    }
-
     // Get LANEndpoint.
-    if(nlGetLinks(&list, nlLinkInfo) != NL_OK) {
-        nlCloseSocket();
+    if(nlGetLinks(&ctx, &list, nlLinkInfo) != NL_OK) {
         _OSBASE_TRACE(1, ("[ERROR] - Unable to get LANEndpoint."));
         rc = LEP_FAIL;
         goto out;
     }
 
-    // Close netlink socket.
-    if(nlCloseSocket() != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Unable to close netlink socket."));
-        rc = LEP_FAIL;
-        goto out;
-    }
-
     // Convert list.
-    if(nlListTOLanEPList(&list, lanEPList) != LEP_OK) {
+    if(nlListTOLanEPList(arena, &list, lanEPList, props) != LEP_OK) {
         _OSBASE_TRACE(1, ("[ERROR] - Could not convert netlink links list to " \
                           "LANEndpoint links list."));
         rc = LEP_FAIL;
@@ -109,10 +130,9 @@ int getLANEndpoints(struct LANEndpointList **lanEPList,
     }
 
  out:
-    nlFreeLinkInfoList(list);
+    nlCtxRelease(&ctx);
     if(rc == LEP_FAIL) {
-        freeLANEndpointList(*lanEPList);
-        FREE_SAFE(lanEPList);
+        *lanEPList = NULL;
     }
 
     _OSBASE_TRACE(3, ("--- getLANEndpoints() exited"));
@@ -121,7 +141,8 @@ int getLANEndpoints(struct LANEndpointList **lanEPList,
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int getALLLANEndpoints(struct LANEndpointList **list)
+int getALLLANEndpoints(struct nlArena *arena, struct LANEndpointList **list,
+                       unsigned int props)
 {
     _OSBASE_TRACE(3, ("--- getALLLANEndpoints() called"));
 
@@ -137,7 +158,7 @@ int getALLLANEndpoints(struct LANEndpointList **list)
     }
 
     // Get LANEndpoint.
-    if(getLANEndpoints(list, &nlLinkInfo) != LEP_OK) {
+    if(getLANEndpoints(arena, list, &nlLinkInfo, props) != LEP_OK) {
         _OSBASE_TRACE(1, ("[ERROR] - Could not get LANEndpoints."));
         rc = LEP_FAIL;
         goto out;
@@ -150,12 +171,21 @@ int getALLLANEndpoints(struct LANEndpointList **list)
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int getLANEndpoint(struct LANEndpointList **lanEPList, const char *linkName)
+int getLANEndpoint(struct nlArena *arena, struct LANEndpointList **lanEPList,
+                   const char *linkName, unsigned int props)
 {
     _OSBASE_TRACE(3, ("--- getLANEndpoint() called"));
 
-    struct nlLinkInfo nlLinkInfo;  // Filter.
-    int               rc = LEP_OK; // Result handler.
+    struct nlContext       ctx;           // Netlink request context.
+    struct nlLinkInfo      nlLinkInfo;    // Filter.
+    struct nlLinkInfoList *list = NULL;   // Netlink links list.
+    int                    rc   = LEP_OK; // Result handler.
+
+    nlCtxInit(&ctx);
+    ctx.arena        = arena;
+    ctx.linkAttrSkip = lepLinkAttrSkip(props);
+    // LANEndpoint does not report interface statistics.
+    ctx.noStats      = 1;
 
     // Generic link info (used as filter).
     if(nlCreateDefaultLinkInfo(&nlLinkInfo) != NL_OK) {
@@ -166,16 +196,34 @@ int getLANEndpoint(struct LANEndpointList **lanEPList, const char *linkName)
     }
     
     // Add ifname.
-    snprintf(nlLinkInfo.ifname, IFNAMSIZ, "%s", linkName);
+    nlLinkInfo.ifname = nlStrIntern(arena, linkName, IFNAMSIZ-1);
+    if(nlLinkInfo.ifname == NL_STR_INVALID) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not intern link name."));
+        rc = LEP_FAIL;
+        goto out;
+    }
 
-    // Get LANEndpoint.
-    if(getLANEndpoints(lanEPList, &nlLinkInfo) != LEP_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Could not get LANEndpoints."));
+    // Get LANEndpoint (looked up by name, not dumped).
+    if(nlGetLink(&ctx, &list, &nlLinkInfo) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Unable to get LANEndpoint."));
+        rc = LEP_FAIL;
+        goto out;
+    }
+
+    // Convert list.
+    if(nlListTOLanEPList(arena, &list, lanEPList, props) != LEP_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not convert netlink links list to " \
+                          "LANEndpoint links list."));
         rc = LEP_FAIL;
         goto out;
     }
 
  out:
+    nlCtxRelease(&ctx);
+    if(rc == LEP_FAIL) {
+        *lanEPList = NULL;
+    }
+
     _OSBASE_TRACE(3, ("--- getLANEndpoint() exited"));
     return rc;
 }
@@ -188,10 +236,16 @@ unsigned short changeLinkOPState(const char *linkName,
 {
     _OSBASE_TRACE(3, ("--- changeLinkOPState() called"));
 
+    struct nlArena    arena;      // Request memory.
+    struct nlContext  ctx;        // Netlink request context.
     struct nlLinkInfo nlLinkInfo; // Filter.
     pid_t             cpid = 0;   // Child process id.
     unsigned short    rc   = 0;   // Result.
 
+    nlArenaInit(&arena);
+    nlCtxInit(&ctx);
+    ctx.arena = &arena;
+
     // Creating a child process.
     if(timeoutPeriod != 0) {
         cpid = fork();
@@ -199,6 +253,9 @@ unsigned short changeLinkOPState(const char *linkName,
             rc = 2;
             goto out;
         }
+        if(cpid == 0) {
+            ctx.noPool = 1;
+        }
     }
 
     if(cpid == 0) { // Code executed by child.
@@ -238,30 +295,20 @@ unsigned short changeLinkOPState(const char *linkName,
         }
 
         // Setting link ifname.
-        snprintf(nlLinkInfo.ifname, IFNAMSIZ, "%s", linkName);
-
-        // Open netlink socket.
-        if(nlOpenSocket() != NL_OK) {
-            _OSBASE_TRACE(1, ("[ERROR] - Unable to open netlink socket."));
+        nlLinkInfo.ifname = nlStrIntern(&arena, linkName, IFNAMSIZ-1);
+        if(nlLinkInfo.ifname == NL_STR_INVALID) {
+            _OSBASE_TRACE(1, ("[ERROR] - Could not intern link name."));
             rc = 4;
             goto out;
         }
 
         // Change state.
-        if(nlModifyLink(&nlLinkInfo, RTM_NEWLINK, 0) != NL_OK) {
-            nlCloseSocket();
+        if(nlModifyLink(&ctx, &nlLinkInfo, RTM_NEWLINK, 0) != NL_OK) {
             _OSBASE_TRACE(1, ("[ERROR] - Unable to change link operative " \
                               "state."));
             rc = 4;
             goto out;
         }
-
-        // Close netlink socket.
-        if(nlCloseSocket() != NL_OK) {
-            _OSBASE_TRACE(1, ("[ERROR] - Unable to close netlink socket."));
-            rc = 4;
-            goto out;
-        }
     } else { // Code executed by parent.
         // Kill child after specified milliseconds.
         if(usleep(timeoutPeriod) != 0) {
@@ -280,48 +327,61 @@ unsigned short changeLinkOPState(const char *linkName,
     }
 
  out:
+    nlCtxRelease(&ctx);
+    nlArenaRelease(&arena);
     _OSBASE_TRACE(3, ("--- changeLinkOPState() exited"));
     return rc;
 }
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlListTOLanEPList(struct nlLinkInfoList **nlLinkInfoList,
-                      struct LANEndpointList **lanEPList)
+int nlListTOLanEPList(struct nlArena *arena,
+                      struct nlLinkInfoList **nlLinkInfoList,
+                      struct LANEndpointList **lanEPList,
+                      unsigned int props)
 {
     _OSBASE_TRACE(3, ("--- nlListTOLanEPList() called"));
 
     struct nlLinkInfoList  *nlLinkInfoListCurr = NULL;   // Current link info.
     struct LANEndpointList *lanEPListCurr      = NULL;   // Current LANEndpoint.
+    char                   *systemName         = NULL;   // Host name.
     int                     rc                 = LEP_OK; // Result handler.
 
+    // SystemName (read once, every LANEndpoint references it).
+    systemName = nlArenaAlloc(arena, MAXHOSTNAMELEN+1);
+    if(systemName == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
+                          "\'systemName\'."));
+        rc = LEP_FAIL;
+        goto out;
+    }
+    gethostname(systemName, MAXHOSTNAMELEN);
+
     nlLinkInfoListCurr = *nlLinkInfoList;
     while(nlLinkInfoListCurr != NULL) {
         if(nlLinkInfoListCurr->sptr != NULL) {
             // Create new LANEndpoint struct and temp containers variables.
-            lanEPListCurr = malloc(sizeof(*lanEPListCurr));
+            lanEPListCurr = nlArenaAlloc(arena, sizeof(*lanEPListCurr));
             if(lanEPListCurr == NULL) {
                 _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
                                   "\'lanEPListCurr\'."));
                 rc = LEP_FAIL;
                 goto out;
             }
-            memset(lanEPListCurr, 0, sizeof(*lanEPListCurr));
 
-            lanEPListCurr->sptr = malloc(sizeof(*(lanEPListCurr->sptr)));
+            lanEPListCurr->sptr =
+                nlArenaAlloc(arena, sizeof(*(lanEPListCurr->sptr)));
             if(lanEPListCurr->sptr == NULL) {
-                FREE_SAFE(lanEPListCurr);
                 _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
                                   "\'lanEPListCurr->sptr\'."));
                 rc = LEP_FAIL;
                 goto out;
             }
-            memset(lanEPListCurr->sptr, 0, sizeof(*(lanEPListCurr->sptr)));
 
             // Convert from nl to LANEndpoint.
-            if(nlInfoTOLanEP(nlLinkInfoListCurr->sptr,
-                             lanEPListCurr->sptr) != LEP_OK) {
-                freeLANEndpointList(lanEPListCurr);
+            if(nlInfoTOLanEP(arena, nlLinkInfoListCurr->sptr,
+                             lanEPListCurr->sptr, systemName,
+                             props) != LEP_OK) {
                 _OSBASE_TRACE(1, ("[ERROR] - Could not convert structure " \
                                   "from nl to LANEndpoint."));
                 rc = LEP_FAIL;
@@ -342,38 +402,100 @@ int nlListTOLanEPList(struct nlLinkInfoList **nlLinkInfoList,
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlInfoTOLanEP(struct nlLinkInfo *nlLinkInfo,
-                  struct LANEndpoint *lanEP)
+int nlInfoTOLanEP(const struct nlArena *arena,
+                  struct nlLinkInfo *nlLinkInfo,
+                  struct LANEndpoint *lanEP, const char *systemName,
+                  unsigned int props)
 {
     _OSBASE_TRACE(3, ("--- nlInfoTOLanEP() called"));
 
-    int typePos = 0;      // Link type.
-    int rc      = LEP_OK; // Result handler.
+    int rc = LEP_OK; // Result handler.
 
-    // MacAddress.
-    nlAddr_n2a(nlLinkInfo->address, nlLinkInfo->addressLen,
-               nlLinkInfo->type, lanEP->macAddress, 32);
+    // MacAddress and InstanceID (rendered when the instance is built).
+    if(props & (LEP_P_MAC_ADDRESS | LEP_P_INSTANCE_ID)) {
+        lanEP->addressLen = nlLinkInfo->addressLen;
+        if(lanEP->addressLen > sizeof(lanEP->address)) {
+            lanEP->addressLen = sizeof(lanEP->address);
+        }
+        memcpy(lanEP->address, nlLinkInfo->address, lanEP->addressLen);
+    }
 
-    // Name.
-    snprintf(lanEP->name, 256, "%s", nlLinkInfo->ifname);
+    // Name (the interned ifname, not copied).
+    lanEP->name = nlStrGet(arena, nlLinkInfo->ifname);
 
-    // Caption.
-    snprintf(lanEP->caption, 64, LANENDPOINT_CAPTION);
+    // ElementName and NameFormat (rendered when the instance is built).
+    lanEP->index = nlLinkInfo->index;
+    lanEP->type  = nlLinkInfo->type;
 
-    // CreationClassName.
-    snprintf(lanEP->creationClassName, 256, "%s", CREATION_CLASS_NAME);
+    // CommunicationStatus, DetailedStatus, EnabledState, HealthState,
+    // OperatingStatus, PrimaryStatus, OperationalStatus.
+    if(props & LEP_P_STATUS) {
+        if(nlLinkInfo->operstate == IF_OPER_UNKNOWN) {
+            if((nlLinkInfo->flags & IFF_UP) &&
+               (nlLinkInfo->flags & IFF_LOWER_UP)) {
+                lanEP->communicationStatus = LEP_CS_COMMUNICATION_OK;
+                lanEP->detailedStatus = LEP_DS_NO_ADDITIONAL_INFORMATION;
+                lanEP->enabledState = LEP_ES_ENABLED;
+                lanEP->healthState = LEP_HS_OK;
+                lanEP->operatingStatus = LEP_OS_IN_SERVICE;
+                lanEP->primaryStatus = LEP_PS_OK;
+                lanEP->operationalStatus = LEP_OPS_OK;
+            } else {
+                lanEP->communicationStatus = LEP_CS_UNKNOWN;
+                lanEP->detailedStatus = LEP_DS_NON_RECOVERABLE_ERROR;
+                lanEP->enabledState = LEP_ES_DISABLED;
+                lanEP->healthState = LEP_HS_UNKNOWN;
+                lanEP->operatingStatus = LEP_OS_UNKNOWN;
+                lanEP->primaryStatus = LEP_PS_UNKNOWN;
+                lanEP->operationalStatus = LEP_OPS_UNKNOWN;
+            }
 
-    // Description.
-    snprintf(lanEP->description, 256, "%s", LANENDPOINT_DESC);
+        } else if(nlLinkInfo->operstate == IF_OPER_NOTPRESENT) {
+            lanEP->communicationStatus = LEP_CS_UNKNOWN;
+            lanEP->detailedStatus = LEP_DS_NON_RECOVERABLE_ERROR;
+            lanEP->enabledState = LEP_ES_DISABLED;
+            lanEP->healthState = LEP_HS_NON_RECOVERABLE_ERROR;
+            lanEP->operatingStatus = LEP_OS_ABORTED;
+            lanEP->primaryStatus = LEP_PS_ERROR;
+            lanEP->operationalStatus = LEP_OPS_NON_RECOVERABLE_ERROR;
 
-    // ElementName.
-    snprintf(lanEP->elementName, 64, "%s_%d", lanEP->name, nlLinkInfo->index);
+        } else if(nlLinkInfo->operstate == IF_OPER_DOWN) {
+            lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
+            lanEP->detailedStatus = LEP_DS_NON_RECOVERABLE_ERROR;
+            lanEP->enabledState = LEP_ES_DISABLED;
+            lanEP->healthState = LEP_HS_CRITICAL_FAILURE;
+            lanEP->operatingStatus = LEP_OS_STOPPED;
+            lanEP->primaryStatus = LEP_PS_ERROR;
+            lanEP->operationalStatus = LEP_OPS_STOPPED;
+
+        } else if(nlLinkInfo->operstate == IF_OPER_LOWERLAYERDOWN) {
+            lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
+            lanEP->detailedStatus = LEP_DS_SUPPORTING_ENTITY_IN_ERROR;
+            lanEP->enabledState = LEP_ES_DISABLED;
+            lanEP->healthState = LEP_HS_MAJOR_FAILURE;
+            lanEP->operatingStatus = LEP_OS_ABORTED;
+            lanEP->primaryStatus = LEP_PS_ERROR;
+            lanEP->operationalStatus = LEP_OPS_SUPPORTING_ENTITY_IN_ERROR;
 
-    // CommunicationStatus, DetailedStatus, EnabledState, HealthState,
-    // OperatingStatus, PrimaryStatus, OperationalStatus.
-    if(nlLinkInfo->operstate == IF_OPER_UNKNOWN) {
-        if((nlLinkInfo->flags & IFF_UP) &&
-           (nlLinkInfo->flags & IFF_LOWER_UP)) {
+        } else if(nlLinkInfo->operstate == IF_OPER_TESTING) {
+            lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
+            lanEP->detailedStatus = LEP_DS_NON_RECOVERABLE_ERROR;
+            lanEP->enabledState = LEP_ES_IN_TEST;
+            lanEP->healthState = LEP_HS_MINOR_FAILURE;
+            lanEP->operatingStatus = LEP_OS_IN_TEST;
+            lanEP->primaryStatus = LEP_PS_DEGRADED;
+            lanEP->operationalStatus = LEP_OPS_IN_SERVICE;
+
+        } else if(nlLinkInfo->operstate == IF_OPER_DORMANT) {
+            lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
+            lanEP->detailedStatus = LEP_DS_STRESSED;
+            lanEP->enabledState = LEP_ES_QUIESCE;
+            lanEP->healthState = LEP_HS_CRITICAL_FAILURE;
+            lanEP->operatingStatus = LEP_OS_DORMANT;
+            lanEP->primaryStatus = LEP_PS_DEGRADED;
+            lanEP->operationalStatus = LEP_OPS_DORMANT;
+
+        } else if(nlLinkInfo->operstate == IF_OPER_UP) {
             lanEP->communicationStatus = LEP_CS_COMMUNICATION_OK;
             lanEP->detailedStatus = LEP_DS_NO_ADDITIONAL_INFORMATION;
             lanEP->enabledState = LEP_ES_ENABLED;
@@ -381,101 +503,21 @@ int nlInfoTOLanEP(struct nlLinkInfo *nlLinkInfo,
             lanEP->operatingStatus = LEP_OS_IN_SERVICE;
             lanEP->primaryStatus = LEP_PS_OK;
             lanEP->operationalStatus = LEP_OPS_OK;
+
         } else {
-            lanEP->communicationStatus = LEP_CS_UNKNOWN;
-            lanEP->detailedStatus = LEP_DS_NON_RECOVERABLE_ERROR;
+            lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
+            lanEP->detailedStatus = LEP_DS_NOT_AVAILABLE;
             lanEP->enabledState = LEP_ES_DISABLED;
             lanEP->healthState = LEP_HS_UNKNOWN;
             lanEP->operatingStatus = LEP_OS_UNKNOWN;
             lanEP->primaryStatus = LEP_PS_UNKNOWN;
             lanEP->operationalStatus = LEP_OPS_UNKNOWN;
         }
-
-    } else if(nlLinkInfo->operstate == IF_OPER_NOTPRESENT) {
-        lanEP->communicationStatus = LEP_CS_UNKNOWN;
-        lanEP->detailedStatus = LEP_DS_NON_RECOVERABLE_ERROR;
-        lanEP->enabledState = LEP_ES_DISABLED;
-        lanEP->healthState = LEP_HS_NON_RECOVERABLE_ERROR;
-        lanEP->operatingStatus = LEP_OS_ABORTED;
-        lanEP->primaryStatus = LEP_PS_ERROR;
-        lanEP->operationalStatus = LEP_OPS_NON_RECOVERABLE_ERROR;
-
-    } else if(nlLinkInfo->operstate == IF_OPER_DOWN) {
-        lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
-        lanEP->detailedStatus = LEP_DS_NON_RECOVERABLE_ERROR;
-        lanEP->enabledState = LEP_ES_DISABLED;
-        lanEP->healthState = LEP_HS_CRITICAL_FAILURE;
-        lanEP->operatingStatus = LEP_OS_STOPPED;
-        lanEP->primaryStatus = LEP_PS_ERROR;
-        lanEP->operationalStatus = LEP_OPS_STOPPED;
-
-    } else if(nlLinkInfo->operstate == IF_OPER_LOWERLAYERDOWN) {
-        lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
-        lanEP->detailedStatus = LEP_DS_SUPPORTING_ENTITY_IN_ERROR;
-        lanEP->enabledState = LEP_ES_DISABLED;
-        lanEP->healthState = LEP_HS_MAJOR_FAILURE;
-        lanEP->operatingStatus = LEP_OS_ABORTED;
-        lanEP->primaryStatus = LEP_PS_ERROR;
-        lanEP->operationalStatus = LEP_OPS_SUPPORTING_ENTITY_IN_ERROR;
-
-    } else if(nlLinkInfo->operstate == IF_OPER_TESTING) {
-        lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
-        lanEP->detailedStatus = LEP_DS_NON_RECOVERABLE_ERROR;
-        lanEP->enabledState = LEP_ES_IN_TEST;
-        lanEP->healthState = LEP_HS_MINOR_FAILURE;
-        lanEP->operatingStatus = LEP_OS_IN_TEST;
-        lanEP->primaryStatus = LEP_PS_DEGRADED;
-        lanEP->operationalStatus = LEP_OPS_IN_SERVICE;
-
-    } else if(nlLinkInfo->operstate == IF_OPER_DORMANT) {
-        lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
-        lanEP->detailedStatus = LEP_DS_STRESSED;
-        lanEP->enabledState = LEP_ES_QUIESCE;
-        lanEP->healthState = LEP_HS_CRITICAL_FAILURE;
-        lanEP->operatingStatus = LEP_OS_DORMANT;
-        lanEP->primaryStatus = LEP_PS_DEGRADED;
-        lanEP->operationalStatus = LEP_OPS_DORMANT;
-
-    } else if(nlLinkInfo->operstate == IF_OPER_UP) {
-        lanEP->communicationStatus = LEP_CS_COMMUNICATION_OK;
-        lanEP->detailedStatus = LEP_DS_NO_ADDITIONAL_INFORMATION;
-        lanEP->enabledState = LEP_ES_ENABLED;
-        lanEP->healthState = LEP_HS_OK;
-        lanEP->operatingStatus = LEP_OS_IN_SERVICE;
-        lanEP->primaryStatus = LEP_PS_OK;
-        lanEP->operationalStatus = LEP_OPS_OK;
-
-    } else {
-        lanEP->communicationStatus = LEP_CS_LOST_COMMUNICATION;
-        lanEP->detailedStatus = LEP_DS_NOT_AVAILABLE;
-        lanEP->enabledState = LEP_ES_DISABLED;
-        lanEP->healthState = LEP_HS_UNKNOWN;
-        lanEP->operatingStatus = LEP_OS_UNKNOWN;
-        lanEP->primaryStatus = LEP_PS_UNKNOWN;
-        lanEP->operationalStatus = LEP_OPS_UNKNOWN;
     }
 
-    // InstanceID.
-    snprintf(lanEP->instanceID, 64, "%s-%s", lanEP->name, lanEP->macAddress);
-
-    // LanID.
-    snprintf(lanEP->lanID, 64, "NULL");
-
     // MaxDataSize.
     lanEP->maxDataSize = nlLinkInfo->mtu;
 
-    // NameFormat.
-    // We look the position of the link type into linkType array, then
-    // we can obtain the string representation from linkTypeName.
-    typePos = nlGetLinkTypePos(nlLinkInfo->type);
-    snprintf(lanEP->nameFormat, 256, "%s", linkTypeName[typePos]);
-
-    // OtherEnabledState.
-    snprintf(lanEP->otherEnabledState, 64, "");
-
-    // OtherTypeDescription.
-    snprintf(lanEP->otherTypeDescription, 64, "");
-
     // ProtocolIFType.
     // @todo implement, we need to take this info from snmp.
     lanEP->protocolIFType = 0;
@@ -484,12 +526,8 @@ int nlInfoTOLanEP(struct nlLinkInfo *nlLinkInfo,
     // @todo implement.
     lanEP->requestedState = LEP_RS_UNKNOWN;
 
-    // SystemCreationClassName.
-    // @todo Defined in cmpiOSBase_LANEndpoint.c, we should obtain it.
-    snprintf(lanEP->systemCreationClassName, 256, "");
-
     // SystemName.
-    gethostname(lanEP->systemName, MAXHOSTNAMELEN);
+    lanEP->systemName = systemName;
 
     // TransitioningToState.
     // @todo implement.
@@ -497,34 +535,9 @@ int nlInfoTOLanEP(struct nlLinkInfo *nlLinkInfo,
 
     // InstallDate.
     // @todo implement. how can obtain installation date form a device?
-    // snprintf(lanEP->installDate, 64, "%s", );
 
     // TimeOfLastStateChange.
     // @todo implement. How can obtain device last change?.
-    // snprintf(lanEP->timeOfLastStateChange, 64, "%s", );
-
-    // StatusDescriptions.
-    snprintf(lanEP->statusDescriptions, 256, "");
-
-    // GroupAddresses.
-    // @todo implement (use CTRL_ATTR_MCAST_GROUPS).
-    snprintf(lanEP->groupAddresses, 32, "");
-
-    // AliasAddresses.
-    // @todo implement. Is this supported on linux?
-    snprintf(lanEP->aliasAddresses, 32, "");
-
-    // AvailableRequestedStates.
-    // @todo implement CIM_EnabledLogicalElementCapabilities.
-    lanEP->availReqStates[0] = LEP_RS_ENABLED;
-    lanEP->availReqStates[1] = LEP_RS_DISABLED;
-    lanEP->availReqStates[2] = LEP_RS_SHUT_DOWN;
-    lanEP->availReqStates[3] = LEP_RS_OFFLINE;
-    lanEP->availReqStates[4] = LEP_RS_TEST;
-    lanEP->availReqStates[5] = LEP_RS_DEFERRED;
-    lanEP->availReqStates[6] = LEP_RS_QUIESCE;
-    lanEP->availReqStates[7] = LEP_RS_REBOOT;
-    lanEP->availReqStates[8] = LEP_RS_RESET;
 
  out:
     _OSBASE_TRACE(3, ("--- nlInfoTOLanEP() exited"));
@@ -533,30 +546,13 @@ int nlInfoTOLanEP(struct nlLinkInfo *nlLinkInfo,
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int freeLANEndpointList(struct LANEndpointList *lptr)
+void cleanupLANEndpoints()
 {
-    _OSBASE_TRACE(3,("--- freeLANEndpointList() called"));
-
-    struct LANEndpointList *ls = NULL;   // Temporary list container.
-    int                     rc = LEP_OK; // Result handler.
-
-    // Check received parameters.
-    if(lptr == NULL) {
-        _OSBASE_TRACE(2, ("[INFO] - NULL LANEndpoints list, nothing to free."));
-        goto out;
-    }
+    _OSBASE_TRACE(3, ("--- cleanupLANEndpoints() called"));
 
-    // Clean.
-    while(lptr != NULL) {
-        FREE_SAFE(lptr->sptr);
-        ls = lptr;
-        lptr = lptr->next;
-        FREE_SAFE(ls);
-    }
+    nlSockPoolDestroy();
 
- out:
-    _OSBASE_TRACE(3,("--- freeLANEndpointList() exited"));
-    return rc;
+    _OSBASE_TRACE(3, ("--- cleanupLANEndpoints() exited"));
 }
 //------------------------------------------------------------------------------
 
@@ -18,7 +18,12 @@
  *              (http://www.linuxfoundation.org/en/Net:Iproute2)
  */
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 #include <sys/socket.h>
@@ -28,9 +33,15 @@
 #include <netinet/in.h>
 #include <errno.h>
 #include <time.h>
+#include <pthread.h>
+#ifdef NL_USE_IO_URING
+#include <liburing.h>
+#endif
 
 #include "OSBase_Common.h"
 #include "OSBase_Netlink.h"
+#include "OSBase_AddrFmt.h"
+#include "OSBase_Parse.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,28 +50,58 @@
 
 //------------------------------------------------------------------------------
 /**
- * Netlink socket handler instance.
+ * Netlink socket pool. Sockets are opened on first use and kept open
+ * between requests, so every request does not pay for socket creation.
+ */
+static struct nlSockHandle nlSockPool[NL_SOCK_POOL_SIZE] = {
+    [0 ... NL_SOCK_POOL_SIZE-1] = { .fd = -1, .pooled = 1 }
+};
+static pthread_mutex_t nlSockPoolLock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int    nlSockPoolGen  = 0; // Bumped by nlSockPoolDestroy.
+
+/**
+ * Library counters, updated atomically.
  */
-struct nlSockHandle nlSH = { .fd = -1 };
+static struct nlStats nlStats;
+
+#ifdef NL_USE_IO_URING
+// A read does not report truncation and can not be sized beforehand, so the
+// buffer is kept larger than any dump datagram the kernel builds (they are
+// sized after the largest read seen, up to 32KB).
+#define NL_RCV_BUFF_INIT (2 * NL_RCV_BUFF_LEN)
+#else
+#define NL_RCV_BUFF_INIT NL_RCV_BUFF_LEN
+#endif
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlOpenSocket()
+int nlOpenSocket(struct nlSockHandle *sh)
 {
     _OSBASE_TRACE(3, ("--- nlOpenSocket() called"));
 
-    socklen_t addrLen = 0;                    // Socket address length.
-    int       sndbuf  = NL_SOCK_SND_BUFF_LEN; // Send buffer length.
-    int       rcvbuf  = NL_SOCK_RCV_BUFF_LEN; // Receive buffer length.
-    int       rc      = NL_OK;                // Result handler.
+    struct sockaddr_nl kern;                           // Kernel address.
+    socklen_t          addrLen = 0;                    // Socket address
+                                                       // length.
+    int                sndbuf  = NL_SOCK_SND_BUFF_LEN; // Send buffer length.
+    int                rcvbuf  = NL_SOCK_RCV_BUFF_LEN; // Receive buffer
+                                                       // length.
+    int                one     = 1;                    // Option enabled.
+    int                rc      = NL_OK;                // Result handler.
+
+    // Check received parameters.
+    if(sh == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
 
     // Create netlink endpoint.
     // AF_NETLINK    = Kernel user interface device.
     // SOCK_RAW      = Raw network protocol access.
     // NETLINK_ROUTE = Receives routing and link updates and may be used
     //                 to modify the routing tables (both IPv4 and IPv6).
-    nlSH.fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
-    if(nlSH.fd < 0) {
+    sh->fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+    if(sh->fd < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Cannot open netlink socket. %s",
                           strerror(errno)));
         rc = NL_FAIL;
@@ -68,7 +109,7 @@ int nlOpenSocket()
     }
 
     // Changes the send socket buffer size.
-    if(setsockopt(nlSH.fd, SOL_SOCKET, SO_SNDBUF, &sndbuf,
+    if(setsockopt(sh->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf,
                   sizeof(sndbuf)) < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Could not change netlink send socket " \
                           "buffer size. %s", strerror(errno)));
@@ -76,9 +117,13 @@ int nlOpenSocket()
         goto out;
     }
 
-    // Changes the receive socket buffer size.
-    if(setsockopt(nlSH.fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf,
-                  sizeof(rcvbuf)) < 0) {
+    // Changes the receive socket buffer size. A large buffer keeps the
+    // replies of pipelined requests from overrunning the socket (ENOBUFS).
+    // Without CAP_NET_ADMIN the size is capped by net.core.rmem_max.
+    if((setsockopt(sh->fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf,
+                   sizeof(rcvbuf)) < 0) &&
+       (setsockopt(sh->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf,
+                   sizeof(rcvbuf)) < 0)) {
         _OSBASE_TRACE(1, ("[ERROR] - Could not change netlink receive socket " \
                           "buffer size. %s", strerror(errno)));
         rc = NL_FAIL;
@@ -86,12 +131,13 @@ int nlOpenSocket()
     }
 
     // Setup local address and bind it to socket.
-    // Address where we will receive messages from kernel.
-    memset(&nlSH.local, 0, sizeof(nlSH.local));
-    nlSH.local.nl_family = AF_NETLINK; // Netlink family.
-    nlSH.local.nl_pid    = getpid();   // Destination local.
-    nlSH.local.nl_groups = 0;          // Not multicast will be received.
-    if(bind(nlSH.fd, (struct sockaddr*)&nlSH.local, sizeof(nlSH.local)) < 0) {
+    // Address where we will receive messages from kernel. The port ID is
+    // assigned by the kernel, several sockets may be open in one process.
+    memset(&sh->local, 0, sizeof(sh->local));
+    sh->local.nl_family = AF_NETLINK; // Netlink family.
+    sh->local.nl_pid    = 0;          // Assigned by the kernel.
+    sh->local.nl_groups = 0;          // Not multicast will be received.
+    if(bind(sh->fd, (struct sockaddr*)&sh->local, sizeof(sh->local)) < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Cannot bind local address to netlink " \
                           "socket. %s", strerror(errno)));
         rc = NL_FAIL;
@@ -100,8 +146,8 @@ int nlOpenSocket()
 
     // Ensure that everything is ok.
     // Get locally-bound name of the socket.
-    addrLen = sizeof(nlSH.local);
-    if(getsockname(nlSH.fd, (struct sockaddr*)&nlSH.local, &addrLen) < 0) {
+    addrLen = sizeof(sh->local);
+    if(getsockname(sh->fd, (struct sockaddr*)&sh->local, &addrLen) < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Cannot get socket name. %s",
                           strerror(errno)));
         rc = NL_FAIL;
@@ -109,43 +155,83 @@ int nlOpenSocket()
     }
 
     // Checking address length.
-    if(addrLen != sizeof(nlSH.local)) {
+    if(addrLen != sizeof(sh->local)) {
         _OSBASE_TRACE(1, ("[ERROR] - Wrong address length %u.", addrLen));
         rc = NL_FAIL;
         goto out;
     }
 
     // Checking family.
-    if(nlSH.local.nl_family != AF_NETLINK) {
+    if(sh->local.nl_family != AF_NETLINK) {
         _OSBASE_TRACE(1, ("[ERROR] - Wrong address family %hu.",
-                          nlSH.local.nl_family));
+                          sh->local.nl_family));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Ask the kernel to check dump requests strictly, so it filters the
+    // dumps by the header fields and attributes of the request. Not fatal,
+    // older kernels dump everything and the filter is applied here.
+    sh->strictChk = 0;
+#ifdef NETLINK_GET_STRICT_CHK
+    if(setsockopt(sh->fd, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &one,
+                  sizeof(one)) == 0) {
+        sh->strictChk = 1;
+    } else {
+        _OSBASE_TRACE(2, ("[INFO] - Netlink strict checking not " \
+                          "supported. %s", strerror(errno)));
+    }
+#endif
+
+    // Connect to the kernel: the kernel then refuses unicasts from other
+    // ports, and replies can be read without looking at the sender.
+    memset(&kern, 0, sizeof(kern));
+    kern.nl_family = AF_NETLINK;
+    if(connect(sh->fd, (struct sockaddr*)&kern, sizeof(kern)) < 0) {
+        _OSBASE_TRACE(1, ("[ERROR] - Cannot connect netlink socket. %s",
+                          strerror(errno)));
         rc = NL_FAIL;
         goto out;
     }
 
+    sh->owner    = getpid();
+    sh->lastUsed = time(NULL);
+
+    // No request in flight. Sequence numbers start from the current time so
+    // late replies to a previous socket with the same port ID are not taken
+    // as ours.
+    sh->seq      = time(NULL);
+    sh->nPending = 0;
+    sh->dump     = NULL;
+    sh->dumpHead = NULL;
+    sh->dumpTail = NULL;
+
  out:
+    if((rc != NL_OK) && (sh != NULL) && (sh->fd >= 0)) {
+        nlCloseSocket(sh);
+    }
+
     _OSBASE_TRACE(3, ("--- nlOpenSocket() exited"));
     return rc;
 }
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlCloseSocket()
+int nlCloseSocket(struct nlSockHandle *sh)
 {
     _OSBASE_TRACE(3, ("--- nlCloseSocket() called"));
 
     int rc = NL_OK; // Result handler.
 
     // Close Netlink socket.
-    if(nlSH.fd >= 0) {
-        if(close(nlSH.fd) < 0) {
+    if((sh != NULL) && (sh->fd >= 0)) {
+        if(close(sh->fd) < 0) {
             _OSBASE_TRACE(1, ("[ERROR] - Unable to close socket. %s",
                               strerror(errno)));
             rc = NL_FAIL;
-            goto out;
         }
-        nlSH.fd = -1;
-        memset(&nlSH.local, 0, sizeof(nlSH.local));
+        sh->fd = -1;
+        memset(&sh->local, 0, sizeof(sh->local));
     } else {
         _OSBASE_TRACE(1, ("[ERROR] - Netlink socket has not been created " \
                           "previously."));
@@ -159,6 +245,205 @@ int nlCloseSocket()
 }
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+/**
+ * Used to check that a previously open socket can be reused: it must
+ * belong to this process (not inherited through fork), have no pending
+ * error and no stale replies of an aborted request in its queue.
+ * @param sh [in] socket handler.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlCheckSocket(struct nlSockHandle *sh)
+{
+    _OSBASE_TRACE(3, ("--- nlCheckSocket() called"));
+
+    char      drain[256];       // Stale messages container.
+    int       sockErr = 0;      // Pending socket error.
+    socklen_t errLen  = sizeof(sockErr);
+    int       rc      = NL_OK;  // Result handler.
+
+    // Socket inherited from the parent process.
+    if(sh->owner != getpid()) {
+        _OSBASE_TRACE(2, ("[INFO] - Socket inherited from process %d.",
+                          (int)sh->owner));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Pending error.
+    if((getsockopt(sh->fd, SOL_SOCKET, SO_ERROR, &sockErr, &errLen) < 0) ||
+       (sockErr != 0)) {
+        _OSBASE_TRACE(2, ("[INFO] - Socket error pending. %s",
+                          strerror(sockErr ? sockErr : errno)));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Drop stale messages.
+    while(recv(sh->fd, drain, sizeof(drain), MSG_DONTWAIT) >= 0) {
+        _OSBASE_TRACE(2, ("[INFO] - Stale message dropped."));
+    }
+    if((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+        _OSBASE_TRACE(2, ("[INFO] - Socket not usable. %s", strerror(errno)));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlCheckSocket() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to open a socket that is not owned by the pool: it is closed when
+ * it is given back. The pool lock is not taken.
+ * @return socket handler | NULL=fail
+ */
+static struct nlSockHandle* nlSockPrivate()
+{
+    struct nlSockHandle *sh = NULL; // New socket.
+
+    sh = malloc(sizeof(*sh));
+    if(sh == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for \'sh\'."));
+        return NULL;
+    }
+    memset(sh, 0, sizeof(*sh));
+    sh->fd     = -1;
+    sh->pooled = 0;
+    sh->inUse  = 1;
+    if(nlOpenSocket(sh) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Unable to open netlink socket."));
+        FREE_SAFE(sh);
+        return NULL;
+    }
+    return sh;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+struct nlSockHandle* nlSockPoolGet()
+{
+    _OSBASE_TRACE(3, ("--- nlSockPoolGet() called"));
+
+    struct nlSockHandle *sh  = NULL;       // Selected socket.
+    time_t               now = time(NULL); // Current time.
+    int                  i   = 0;
+
+    // Close idle sockets (there is no timer, they are closed here by the
+    // next request) and pick a free one (an open one if possible). The
+    // lock is only held while choosing, the socket is ours once it is marked
+    // in use.
+    pthread_mutex_lock(&nlSockPoolLock);
+    for(i=0 ; i<NL_SOCK_POOL_SIZE ; i++) {
+        if(nlSockPool[i].inUse) {
+            continue;
+        }
+        if((nlSockPool[i].fd >= 0) &&
+           ((now - nlSockPool[i].lastUsed) > NL_SOCK_IDLE_TIMEOUT)) {
+            _OSBASE_TRACE(2, ("[INFO] - Closing idle netlink socket."));
+            nlCloseSocket(&nlSockPool[i]);
+        }
+        if((sh == NULL) || ((sh->fd < 0) && (nlSockPool[i].fd >= 0))) {
+            sh = &nlSockPool[i];
+        }
+    }
+    if(sh != NULL) {
+        sh->inUse = 1;
+        sh->gen   = nlSockPoolGen;
+    }
+    pthread_mutex_unlock(&nlSockPoolLock);
+
+    // Pool exhausted, use a socket that is closed when it is returned.
+    if(sh == NULL) {
+        _OSBASE_TRACE(2, ("[INFO] - Netlink socket pool exhausted."));
+        sh = nlSockPrivate();
+        goto out;
+    }
+
+    // Health check.
+    if((sh->fd >= 0) && (nlCheckSocket(sh) != NL_OK)) {
+        _OSBASE_TRACE(2, ("[INFO] - Reopening netlink socket."));
+        if(sh->owner != getpid()) {
+            // The descriptor is shared with the parent, only drop our copy.
+            close(sh->fd);
+            sh->fd = -1;
+        } else {
+            nlCloseSocket(sh);
+        }
+    }
+
+    // Open on first use.
+    if((sh->fd < 0) && (nlOpenSocket(sh) != NL_OK)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Unable to open netlink socket."));
+        nlSockPoolPut(sh, NL_FAIL);
+        sh = NULL;
+        goto out;
+    }
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlSockPoolGet() exited"));
+    return sh;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void nlSockPoolPut(struct nlSockHandle *sh, int status)
+{
+    _OSBASE_TRACE(3, ("--- nlSockPoolPut() called"));
+
+    if(sh == NULL) {
+        goto out;
+    }
+
+    if(!sh->pooled) {
+        if(sh->fd >= 0) {
+            nlCloseSocket(sh);
+        }
+        FREE_SAFE(sh);
+        goto out;
+    }
+
+    // Replies of a failed or unfinished request may still be queued, do not
+    // reuse it. Sockets lent before the pool was destroyed are not reused
+    // either.
+    pthread_mutex_lock(&nlSockPoolLock);
+    if((sh->fd >= 0) &&
+       ((status != NL_OK) || (sh->nPending > 0) || (sh->dumpHead != NULL) ||
+        (sh->gen != nlSockPoolGen))) {
+        nlCloseSocket(sh);
+    }
+    sh->lastUsed = time(NULL);
+    sh->inUse    = 0;
+    pthread_mutex_unlock(&nlSockPoolLock);
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlSockPoolPut() exited"));
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void nlSockPoolDestroy()
+{
+    _OSBASE_TRACE(3, ("--- nlSockPoolDestroy() called"));
+
+    int i = 0;
+
+    pthread_mutex_lock(&nlSockPoolLock);
+    for(i=0 ; i<NL_SOCK_POOL_SIZE ; i++) {
+        if((!nlSockPool[i].inUse) && (nlSockPool[i].fd >= 0)) {
+            nlCloseSocket(&nlSockPool[i]);
+        }
+    }
+    nlSockPoolGen++;
+    pthread_mutex_unlock(&nlSockPoolLock);
+
+    _OSBASE_TRACE(3, ("--- nlSockPoolDestroy() exited"));
+}
+//------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------------
 int nlAddAttrToMsg(struct nlmsghdr *h, int maxlen, int attrType,
                    const void *attrData, int attrBytelen)
@@ -234,364 +519,354 @@ int nlAddAttrToMsg32(struct nlmsghdr *h, int maxlen,
 }
 //------------------------------------------------------------------------------
 
-////////////////////////////////////////////////////////////////////////////////
-
-
-////////////////////////////////////////////////////////////////////////////////
-// ROUTES
-////////////////////////////////////////////////////////////////////////////////
-
 //------------------------------------------------------------------------------
-int nlGetRoutes(struct nlRouteInfoList **nlRtInfoList,
-                struct nlRouteInfo *nlRtInfo)
+struct rtattr* nlAddNestToMsg(struct nlmsghdr *h, int maxlen, int attrType)
 {
-    _OSBASE_TRACE(3, ("--- nlGetRoutes() called"));
-
-    struct sockaddr_nl nlSockAddrKern;                  // Netlink client in
-                                                        // kernel.
-    struct iovec       iov;                             // Scatter-and-gather
-                                                        // buffer.
-    struct msghdr      msg;                             // Final message
-                                                        // structure.
-    char               rcvBuffer[NL_SOCK_SND_BUFF_LEN]; // Received message
-                                                        // buffer.
-    struct nlmsghdr   *rcvH   = NULL;                   // Received Netlink
-                                                        // message header.
-    struct nlmsgerr   *errmsg = NULL;                   // Netlink errors
-                                                        // container.
-    int                status = 0;                      // Send/Receive message
-                                                        // status.
-    int                rc     = NL_OK;                  // Result handler.
+    _OSBASE_TRACE(3, ("--- nlAddNestToMsg() called"));
 
-    // Buffer to hold the RTNETLINK request.
-    struct {
-        struct nlmsghdr h; // Netlink message header.
-        struct rtmsg    m; // Message.
-    } req;
+    struct rtattr *nest = NULL; // Nested attribute handler.
 
     // Check received parameters.
-    if(nlRtInfo == NULL) {
+    if((h == NULL) || (maxlen < 0)) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
-        rc = NL_FAIL;
         goto out;
     }
 
-    // Generate filter.
-    if(nlGenRouteFilter(nlRtInfo) != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Problem generating route filter."));
-        rc = NL_FAIL;
+    if(NLMSG_ALIGN(h->nlmsg_len) + RTA_LENGTH(0) > (unsigned int)maxlen) {
+        _OSBASE_TRACE(1, ("[ERROR] - Max allowed bound %d exceeded.", maxlen));
         goto out;
     }
 
-    // Fill request message.
-    memset(&req, 0, sizeof(req));
-    // Length of message including header.
-    req.h.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
-    // Receive information about a network route.
-    req.h.nlmsg_type = RTM_GETROUTE;
-    // Return the complete table matching criteria passed in message content.
-    req.h.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
-    // Sequence number (opaque for netlink core).
-    req.h.nlmsg_seq = time(NULL);
-    // PID of the sending process (opaque for netlink core).
-    req.h.nlmsg_pid = getpid();
-    // Address family of route.
-    req.m.rtm_family = nlRtInfo->family;
-    // Length of source.
-    req.m.rtm_src_len = 0;
-    // Length of destination.
-    req.m.rtm_dst_len = 0;
-    // TOS filter.
-    req.m.rtm_tos = 0;
-    // Routing table.
-    req.m.rtm_table = RT_TABLE_UNSPEC;
-    // Route origin.
-    req.m.rtm_protocol = RTN_UNSPEC;
-    // Distance to the destination.
-    req.m.rtm_scope = RT_SCOPE_UNIVERSE;
-    // Route type.
-    req.m.rtm_type = RTA_UNSPEC;
-
-    // Setup kernel address. Address to where we will send messages.
-    memset(&nlSockAddrKern, 0, sizeof(nlSockAddrKern));
-    nlSockAddrKern.nl_family = AF_NETLINK; // Netlink family.
-    nlSockAddrKern.nl_pid    = 0;          // Destination kernel.
-    nlSockAddrKern.nl_groups = 0;          // Not multicast will be received.
-
-    // Init iovec structure.
-    iov.iov_base = (void*)&(req.h);
-    iov.iov_len  = req.h.nlmsg_len;
+    // Add an empty attribute, its length is fixed by nlEndNestInMsg.
+    nest = NLMSG_TAIL(h);
+    nest->rta_type = attrType;
+    nest->rta_len  = RTA_LENGTH(0);
+    h->nlmsg_len = NLMSG_ALIGN(h->nlmsg_len) + RTA_LENGTH(0);
 
-    // Init final message structure.
-    msg.msg_name       = &nlSockAddrKern;        // Socket name.
-    msg.msg_namelen    = sizeof(nlSockAddrKern); // Length of name.
-    msg.msg_iov        = &iov;                   // Data blocks.
-    msg.msg_iovlen     = 1;                      // Number of blocks.
-    msg.msg_control    = NULL;                   // Ancillary data.
-    msg.msg_controllen = 0;                      // Ancillary data buffer len.
-    msg.msg_flags      = 0;                      // Flags on received message.
+ out:
+    _OSBASE_TRACE(3, ("--- nlAddNestToMsg() exited"));
+    return nest;
+}
+//------------------------------------------------------------------------------
 
-    // Send request message to kernel.
-    if(sendmsg(nlSH.fd, &msg, 0) < 0) {
-        _OSBASE_TRACE(1, ("[ERROR] - Cannot talk to rtnetlink. %s",
-                          strerror(errno)));
-        rc = NL_FAIL;
-        goto out;
+//------------------------------------------------------------------------------
+int nlEndNestInMsg(struct nlmsghdr *h, struct rtattr *nest)
+{
+    // Check received parameters.
+    if((h == NULL) || (nest == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        return NL_FAIL;
     }
 
-    // Receive kernel messages (route table).
-    memset(rcvBuffer, 0, NL_SOCK_SND_BUFF_LEN*sizeof(*rcvBuffer));
-    iov.iov_base = rcvBuffer;
-    while(1) {
-        rcvH        = NULL; // Received Netlink message header.
-        iov.iov_len = sizeof(rcvBuffer);
-        status      = recvmsg(nlSH.fd, &msg, 0);
-
-        // Check if received message is correct.
-        if(status < 0) {
-            // EINTR  = Was interrupted by a signal before any data was
-            //          available.
-            // EAGAIN = The socket's file descriptor is marked O_NONBLOCK
-            //          and no data is waiting to be received.
-            if((errno == EINTR) || (errno == EAGAIN)) {
-                continue;
-            }
-            _OSBASE_TRACE(1, ("[ERROR] - Netlink receive error - %s (%d).",
-                              strerror(errno), errno));
-            rc = NL_FAIL;
-            goto out;
-        }
-        if(status == 0) {
-            _OSBASE_TRACE(1, ("[ERROR] - No messages are available to be "
-                              "received. %s", strerror(errno)));
-            rc = NL_FAIL;
-            goto out;
-        }
-
-        // Parse message.
-        rcvH = (struct nlmsghdr*)rcvBuffer;
-        while(NLMSG_OK(rcvH, status)) {
-            // Check pid and seq.
-            if((nlSockAddrKern.nl_pid != 0) ||
-               (rcvH->nlmsg_pid != nlSH.local.nl_pid) ||
-               (rcvH->nlmsg_seq != req.h.nlmsg_seq)) {
-                rcvH = NLMSG_NEXT(rcvH, status);
-                continue;
-            }
-
-            // If done, exit.
-            if(rcvH->nlmsg_type == NLMSG_DONE) {
-                goto out;
-            }
-
-            // Error received.
-            if(rcvH->nlmsg_type == NLMSG_ERROR) {
-                errmsg = (struct nlmsgerr*)NLMSG_DATA(rcvH);
-                if(rcvH->nlmsg_len < NLMSG_LENGTH(sizeof(*errmsg))) {
-                    _OSBASE_TRACE(1, ("[ERROR] - Truncated."));
-                } else {
-                    _OSBASE_TRACE(1, ("[ERROR] - RTNETLINK answers."));
-                }
-                rc = NL_FAIL;
-                goto out;
-            }
-
-            // We need to pass route info to filter routes because
-            // NLM_F_MATCH is not implemented yet (in kernel), so we are
-            // receiving all routes from all tables.
-            if(nlAddRouteToList(rcvH, nlRtInfoList, nlRtInfo) == NL_FAIL) {
-                rc = NL_FAIL;
-                goto out;
-            }
-
-            // Next route.
-            rcvH = NLMSG_NEXT(rcvH, status);
-        }
+    nest->rta_len = (void*)NLMSG_TAIL(h) - (void*)nest;
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
 
-        // MSG_TRUNC = Normal data truncated.
-        if(msg.msg_flags & MSG_TRUNC) {
-            _OSBASE_TRACE(2, ("[INFO] - Message truncated."));
-            continue;
-        }
-        if(status) {
-            _OSBASE_TRACE(1, ("[ERROR] - Remnant of size %d.", status));
-            rc = NL_FAIL;
-            goto out;
-        }
-    }
+#ifdef NL_USE_IO_URING
+//------------------------------------------------------------------------------
+/**
+ * io_uring state of a context. Sends are only queued by nlSubmit and go to
+ * the kernel together with the next receive, so a batch of requests costs a
+ * single io_uring_enter. The receive buffer is registered with the ring.
+ */
+struct nlUring {
+    struct io_uring ring;  /**< Submission and completion queues. */
+    unsigned int    nSend; /**< Sends whose completion was not reaped
+                              (drained before the socket is given back). */
+};
+
+#define NL_URING_ENTRIES 32 /**< Ring size. */
+#define NL_URING_SEND    1  /**< Send completion tag. */
+#define NL_URING_RECV    2  /**< Receive completion tag. */
+//------------------------------------------------------------------------------
 
- out:
-    if(rc != NL_OK) {
-        nlFreeRouteInfoList(*nlRtInfoList);
+//------------------------------------------------------------------------------
+/**
+ * Used to tear down the context ring (requests queued on it are dropped).
+ * @param ctx [in] request context.
+ */
+static void nlUringExit(struct nlContext *ctx)
+{
+    if(ctx->uring == NULL) {
+        return;
     }
-
-    _OSBASE_TRACE(3, ("--- nlGetRoutes() exited"));
-    return rc;
+    io_uring_queue_exit(&ctx->uring->ring);
+    FREE_SAFE(ctx->uring);
 }
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlModifyRoute(struct nlRouteInfo *nlRtInfo, int hType,
-                  unsigned int hFlags)
+/**
+ * Used to set up the context ring and register the receive buffer. When
+ * the kernel does not support io_uring the context stays on the plain
+ * syscall path.
+ * @param ctx [in] request context.
+ */
+static void nlUringInit(struct nlContext *ctx)
 {
-    _OSBASE_TRACE(3, ("--- nlModifyRoute() called"));
+    _OSBASE_TRACE(3, ("--- nlUringInit() called"));
 
-    struct sockaddr_nl nlSockAddrKern;                  // Netlink client in
-                                                        // kernel.
-    struct iovec       iov;                             // Scatter-and-gather
-                                                        // buffer.
-    struct msghdr      msg;                             // Final message
-                                                        // structure.
-    char               rcvBuffer[NL_SOCK_SND_BUFF_LEN]; // Received message
-                                                        // buffer.
-    struct nlmsghdr   *rcvH   = NULL;                   // Received Netlink
-                                                        // message header.
-    struct nlmsgerr   *errmsg = NULL;                   // Netlink errors
-                                                        // container.
-    uint32_t           attrData[8];                     // Attribute data.
-    uint8_t            attrBytelen;                     // Attribute byte
-                                                        // length.
-    int                status = 0;                      // Send/Receive message
-                                                        // status.
-    int                rc     = NL_OK;                  // Result handler.
-
-    // Buffer to hold the RTNETLINK request.
-    struct {
-        struct nlmsghdr h;         // Netlink message header.
-        struct rtmsg    m;         // Message.
-        char            buf[1024]; // Attributes buffer.
-    } req;
+    struct iovec iov;     // Registered buffer.
+    int          err = 0; // io_uring error.
 
-    // Check received parameters.
-    if(nlRtInfo == NULL) {
-        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
-        rc = NL_FAIL;
+    if((ctx->uring != NULL) || (ctx->noUring)) {
         goto out;
     }
 
-    // Check hType.
-    if((hType != RTM_NEWROUTE) && (hType != RTM_DELROUTE)) {
-        _OSBASE_TRACE(1, ("[ERROR] - Invalid message type."));
-        rc = NL_FAIL;
+    ctx->uring = malloc(sizeof(*ctx->uring));
+    if(ctx->uring == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
+                          "\'uring\'."));
+        ctx->noUring = 1;
         goto out;
     }
+    memset(ctx->uring, 0, sizeof(*ctx->uring));
 
-    // Generate filter.
-    if(nlGenRouteFilter(nlRtInfo) != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Problem generating filter."));
-        rc = NL_FAIL;
+    err = io_uring_queue_init(NL_URING_ENTRIES, &ctx->uring->ring, 0);
+    if(err < 0) {
+        _OSBASE_TRACE(2, ("[INFO] - io_uring not available, using plain " \
+                          "syscalls. %s", strerror(-err)));
+        FREE_SAFE(ctx->uring);
+        ctx->noUring = 1;
         goto out;
     }
 
-    // Fill message.
-    memset(&req, 0, sizeof(req));
-    // Length of message including header.
-    req.h.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
-    // Type of message content.
-    req.h.nlmsg_type = hType;
-    // Flags.
-    req.h.nlmsg_flags = NLM_F_ACK | NLM_F_REQUEST | hFlags;
-    // Sequence number (opaque for netlink core).
-    req.h.nlmsg_seq = time(NULL);
-    // PID of the sending process (opaque for netlink core).
-    req.h.nlmsg_pid = getpid();
-    // Address family of route.
-    req.m.rtm_family = nlRtInfo->family;
-    // Length of source.
-    req.m.rtm_src_len = nlRtInfo->srcLen;
-    // Length of destination.
-    req.m.rtm_dst_len = nlRtInfo->dstLen;
-    // TOS filter.
-    req.m.rtm_tos = nlRtInfo->tos;
-    // Routing table.
-    req.m.rtm_table = nlRtInfo->table;
-    // Route origin.
-    req.m.rtm_protocol = nlRtInfo->protocol;
-    // Distance to the destination.
-    req.m.rtm_scope = nlRtInfo->scope;
-    // Route type.
-    req.m.rtm_type = nlRtInfo->type;
+    iov.iov_base = ctx->rcvBuf;
+    iov.iov_len  = ctx->rcvBufLen;
+    err = io_uring_register_buffers(&ctx->uring->ring, &iov, 1);
+    if(err < 0) {
+        _OSBASE_TRACE(2, ("[INFO] - Could not register io_uring buffer, " \
+                          "using plain syscalls. %s", strerror(-err)));
+        nlUringExit(ctx);
+        ctx->noUring = 1;
+        goto out;
+    }
 
-    // Destination address to be reached.
-    if(rtFlt.dstAddr) {
-        if(inet_pton(nlRtInfo->family, nlRtInfo->dstAddr, attrData,
-                     ((nlRtInfo->family == AF_INET) ? (INET_ADDRSTRLEN) :
-                      (INET6_ADDRSTRLEN))) <= 0) {
-            _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from " \
-                              "presentation format to numeric format. %s",
-                              strerror(errno)));
+ out:
+    _OSBASE_TRACE(3, ("--- nlUringInit() exited"));
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a free submission entry, flushing the queue when it is full.
+ * @param ctx [in] request context.
+ * @return submission entry | NULL=fail
+ */
+static struct io_uring_sqe* nlUringGetSqe(struct nlContext *ctx)
+{
+    struct io_uring_sqe *sqe = NULL; // Submission entry.
+
+    sqe = io_uring_get_sqe(&ctx->uring->ring);
+    if(sqe == NULL) {
+        io_uring_submit(&ctx->uring->ring);
+        sqe = io_uring_get_sqe(&ctx->uring->ring);
+    }
+    return sqe;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to queue a request message. It is linked to the entries queued after
+ * it, so requests reach the kernel in order and before the next receive.
+ * @param ctx [in] request context.
+ * @param m [in] request message.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlUringSend(struct nlContext *ctx, struct nlmsghdr *m)
+{
+    struct io_uring_sqe *sqe = NULL; // Submission entry.
+
+    sqe = nlUringGetSqe(ctx);
+    if(sqe == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - io_uring submission queue full."));
+        return NL_FAIL;
+    }
+    io_uring_prep_send(sqe, ctx->sh->fd, m, m->nlmsg_len, 0);
+    sqe->flags     |= IOSQE_IO_LINK;
+    sqe->user_data  = NL_URING_SEND;
+    ctx->uring->nSend++;
+
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to receive one datagram into the registered buffer. Queued sends are
+ * submitted with it and their completions reaped on the way.
+ * @param ctx [in] request context.
+ * @param len [out] datagram length.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlUringRecv(struct nlContext *ctx, int *len)
+{
+    _OSBASE_TRACE(3, ("--- nlUringRecv() called"));
+
+    struct io_uring_sqe *sqe = NULL;  // Submission entry.
+    struct io_uring_cqe *cqe = NULL;  // Completion entry.
+    unsigned long long   tag = 0;     // Completion tag.
+    int                  res = 0;     // Completion result.
+    int                  err = 0;     // io_uring error.
+    int                  rc  = NL_OK; // Result handler.
+
+ again:
+    // The socket is connected to the kernel, so a plain read is enough and
+    // nobody else can send to us.
+    sqe = nlUringGetSqe(ctx);
+    if(sqe == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - io_uring submission queue full."));
+        rc = NL_FAIL;
+        goto out;
+    }
+    io_uring_prep_read_fixed(sqe, ctx->sh->fd, ctx->rcvBuf, ctx->rcvBufLen,
+                             0, 0);
+    sqe->user_data = NL_URING_RECV;
+
+    err = io_uring_submit_and_wait(&ctx->uring->ring, 1);
+    if((err < 0) && (err != -EINTR)) {
+        _OSBASE_TRACE(1, ("[ERROR] - io_uring submit error. %s",
+                          strerror(-err)));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    while(1) {
+        err = io_uring_wait_cqe(&ctx->uring->ring, &cqe);
+        if(err == -EINTR) {
+            continue;
+        }
+        if(err < 0) {
+            _OSBASE_TRACE(1, ("[ERROR] - io_uring wait error. %s",
+                              strerror(-err)));
             rc = NL_FAIL;
             goto out;
         }
-        (nlRtInfo->family == AF_INET) ? (attrBytelen = 4) : (attrBytelen = 16);
-        nlAddAttrToMsg(&req.h, sizeof(req), RTA_DST, &attrData, attrBytelen);
-    }
+        tag = cqe->user_data;
+        res = cqe->res;
+        io_uring_cqe_seen(&ctx->uring->ring, cqe);
+
+        if(tag == NL_URING_SEND) {
+            ctx->uring->nSend--;
+            if(res < 0) {
+                _OSBASE_TRACE(1, ("[ERROR] - Cannot talk to rtnetlink. %s",
+                                  strerror(-res)));
+                rc = NL_FAIL;
+                goto out;
+            }
+            continue;
+        }
 
-    // Source address.
-    if(rtFlt.srcAddr) {
-        if(inet_pton(nlRtInfo->family, nlRtInfo->srcAddr, attrData,
-                     ((nlRtInfo->family == AF_INET) ? (INET_ADDRSTRLEN) :
-                      (INET6_ADDRSTRLEN))) <= 0) {
-            _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from "\
-                              "presentation format to numeric format. %s",
-                              strerror(errno)));
+        if((res == -EINTR) || (res == -EAGAIN)) {
+            goto again;
+        }
+        if(res < 0) {
+            _OSBASE_TRACE(1, ("[ERROR] - Netlink receive error - %s (%d).",
+                              strerror(-res), -res));
+            rc = NL_FAIL;
+            goto out;
+        }
+        if(res == 0) {
+            _OSBASE_TRACE(1, ("[ERROR] - No messages are available to be "
+                              "received."));
             rc = NL_FAIL;
             goto out;
         }
-        (nlRtInfo->family == AF_INET) ? (attrBytelen = 4) : (attrBytelen = 16);
-        nlAddAttrToMsg(&req.h, sizeof(req), RTA_SRC, &attrData, attrBytelen);
+        // A read does not report MSG_TRUNC. The buffer is larger than any
+        // datagram the kernel builds, so a full buffer means truncation.
+        if((size_t)res >= ctx->rcvBufLen) {
+            _OSBASE_TRACE(1, ("[ERROR] - Truncated message."));
+            rc = NL_FAIL;
+            goto out;
+        }
+        *len = res;
+        break;
     }
 
-    // Input interface index.
-    if(rtFlt.inputIf) {
-        nlAddAttrToMsg32(&req.h, sizeof(req), RTA_IIF,
-                         (uint32_t)(nlRtInfo->inputIf));
+ out:
+    _OSBASE_TRACE(3, ("--- nlUringRecv() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to reap the completions of the sends still outstanding on the
+ * context ring, so the socket is not handed to another context while a send
+ * of this one may still write to it.
+ * @param ctx [in] request context.
+ * @return NL_OK=every send is over and succeeded | NL_FAIL=fail
+ */
+static int nlUringDrain(struct nlContext *ctx)
+{
+    _OSBASE_TRACE(3, ("--- nlUringDrain() called"));
+
+    struct io_uring_cqe *cqe = NULL;  // Completion entry.
+    int                  err = 0;     // io_uring error.
+    int                  rc  = NL_OK; // Result handler.
+
+    if((ctx->uring == NULL) || (ctx->uring->nSend == 0)) {
+        goto out;
     }
 
-    // Output interface index.
-    if(rtFlt.outputIf) {
-        nlAddAttrToMsg32(&req.h, sizeof(req), RTA_OIF,
-                         (uint32_t)(nlRtInfo->outputIf));
+    // Sends never submitted have no request waiting for them anymore.
+    if(io_uring_sq_ready(&ctx->uring->ring) > 0) {
+        rc = NL_FAIL;
+        goto out;
     }
 
-    // Gateway of the route.
-    if(rtFlt.gw) {
-        if(inet_pton(nlRtInfo->family, nlRtInfo->gw, attrData,
-                     ((nlRtInfo->family == AF_INET) ? (INET_ADDRSTRLEN) :
-                      (INET6_ADDRSTRLEN))) <= 0) {
-            _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from " \
-                              "presentation format to numeric format. %s",
-                              strerror(errno)));
+    while(ctx->uring->nSend > 0) {
+        err = io_uring_wait_cqe(&ctx->uring->ring, &cqe);
+        if(err == -EINTR) {
+            continue;
+        }
+        if(err < 0) {
+            _OSBASE_TRACE(1, ("[ERROR] - io_uring wait error. %s",
+                              strerror(-err)));
             rc = NL_FAIL;
             goto out;
         }
-        (nlRtInfo->family == AF_INET) ? (attrBytelen = 4) : (attrBytelen = 16);
-        nlAddAttrToMsg(&req.h, sizeof(req), RTA_GATEWAY, &attrData,
-                       attrBytelen);
-    }
-
-    // Priority of the route.
-    if(rtFlt.priority) {
-        nlAddAttrToMsg32(&req.h, sizeof(req), RTA_PRIORITY,
-                         (uint32_t)nlRtInfo->priority);
-    }
-
-    // Prefered source.
-    if(rtFlt.prefSrc) {
-        if(inet_pton(nlRtInfo->family, nlRtInfo->prefSrc, attrData,
-                     ((nlRtInfo->family == AF_INET) ? (INET_ADDRSTRLEN) :
-                      (INET6_ADDRSTRLEN))) <= 0) {
-            _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from " \
-                              "presentation format to numeric format. %s",
-                              strerror(errno)));
+        // Anything else than a successful send leaves the socket unknown.
+        if((cqe->user_data != NL_URING_SEND) || (cqe->res < 0)) {
             rc = NL_FAIL;
+        } else {
+            ctx->uring->nSend--;
+        }
+        io_uring_cqe_seen(&ctx->uring->ring, cqe);
+        if(rc != NL_OK) {
             goto out;
         }
-        (nlRtInfo->family == AF_INET) ? (attrBytelen = 4) : (attrBytelen = 16);
-        nlAddAttrToMsg(&req.h, sizeof(req), RTA_PREFSRC, &attrData,
-                       attrBytelen);
     }
 
+ out:
+    _OSBASE_TRACE(3, ("--- nlUringDrain() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+#endif // NL_USE_IO_URING
+
+//------------------------------------------------------------------------------
+/**
+ * Used to send a request message to the kernel (queued when io_uring is
+ * used).
+ * @param ctx [in] request context.
+ * @param m [in] request message.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlTransportSend(struct nlContext *ctx, struct nlmsghdr *m)
+{
+    struct sockaddr_nl nlSockAddrKern; // Netlink client in kernel.
+    struct iovec       iov;            // Scatter-and-gather buffer.
+    struct msghdr      msg;            // Final message structure.
+
+#ifdef NL_USE_IO_URING
+    if(ctx->uring != NULL) {
+        return nlUringSend(ctx, m);
+    }
+#endif
+
     // Setup kernel address. Address where we will send messages.
     memset(&nlSockAddrKern, 0, sizeof(nlSockAddrKern));
     nlSockAddrKern.nl_family = AF_NETLINK; // Netlink family.
@@ -599,8 +874,8 @@ int nlModifyRoute(struct nlRouteInfo *nlRtInfo, int hType,
     nlSockAddrKern.nl_groups = 0;          // Not multicast will be received.
 
     // Init iovec structure.
-    iov.iov_base = (void*)&(req.h);
-    iov.iov_len  = req.h.nlmsg_len;
+    iov.iov_base = (void*)m;
+    iov.iov_len  = m->nlmsg_len;
 
     // Init final message structure.
     msg.msg_name       = &nlSockAddrKern;        // Socket name.
@@ -612,20 +887,104 @@ int nlModifyRoute(struct nlRouteInfo *nlRtInfo, int hType,
     msg.msg_flags      = 0;                      // Flags on received message.
 
     // Send request message to kernel.
-    if(sendmsg(nlSH.fd, &msg, 0) < 0) {
+    if(sendmsg(ctx->sh->fd, &msg, 0) < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Cannot talk to rtnetlink. %s",
                           strerror(errno)));
-        rc = NL_FAIL;
+        return NL_FAIL;
+    }
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to grow the receive buffer so a datagram fits in it. The length is
+ * doubled until it fits, up to NL_RCV_BUFF_MAX.
+ * @param ctx [in] request context.
+ * @param len [in] datagram length.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlGrowRcvBuf(struct nlContext *ctx, size_t len)
+{
+    char   *buf    = NULL;           // New buffer.
+    size_t  bufLen = ctx->rcvBufLen; // New buffer length.
+
+    while(bufLen < len) {
+        bufLen *= 2;
+    }
+    if(bufLen > NL_RCV_BUFF_MAX) {
+        _OSBASE_TRACE(1, ("[ERROR] - Message too long (%lu bytes).",
+                          (unsigned long)len));
+        return NL_FAIL;
+    }
+
+    // The old contents are not needed, the datagram is still queued.
+    buf = malloc(bufLen);
+    if(buf == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
+                          "'rcvBuf'."));
+        return NL_FAIL;
+    }
+    free(ctx->rcvBuf);
+    ctx->rcvBuf    = buf;
+    ctx->rcvBufLen = bufLen;
+    _OSBASE_TRACE(2, ("[INFO] - Receive buffer grown to %lu bytes.",
+                      (unsigned long)bufLen));
+
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to receive one datagram from the kernel into the context buffer.
+ * @param ctx [in] request context.
+ * @param len [out] datagram length.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlTransportRecv(struct nlContext *ctx, int *len)
+{
+    _OSBASE_TRACE(3, ("--- nlTransportRecv() called"));
+
+    struct sockaddr_nl nlSockAddrKern; // Netlink client in kernel.
+    struct iovec       iov;            // Scatter-and-gather buffer.
+    struct msghdr      msg;            // Final message structure.
+    int                status = 0;     // Receive message status.
+    int                rc     = NL_OK; // Result handler.
+
+#ifdef NL_USE_IO_URING
+    if(ctx->uring != NULL) {
+        rc = nlUringRecv(ctx, len);
         goto out;
     }
+#endif
+
+    // Init final message structure. Replies are handed to the handlers
+    // straight out of the receive buffer, so it does not need to be
+    // cleared.
+    msg.msg_name       = &nlSockAddrKern;
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = NULL;
+    msg.msg_controllen = 0;
 
     // Receive kernel messages.
-    memset(rcvBuffer, 0, NL_SOCK_SND_BUFF_LEN*sizeof(*rcvBuffer));
-    iov.iov_base = rcvBuffer;
     while(1) {
-        rcvH = NULL; // Received Netlink message header.
-        iov.iov_len = sizeof(rcvBuffer);
-        status = recvmsg(nlSH.fd, &msg, 0);
+        // Peek the length of the next datagram (MSG_TRUNC returns the real
+        // length, nothing is copied) and make room for it, so large
+        // messages are not truncated.
+        status = recv(ctx->sh->fd, NULL, 0, MSG_PEEK | MSG_TRUNC);
+        if((status > 0) && ((size_t)status > ctx->rcvBufLen) &&
+           (nlGrowRcvBuf(ctx, status) != NL_OK)) {
+            rc = NL_FAIL;
+            goto out;
+        }
+
+        iov.iov_base    = ctx->rcvBuf;
+        iov.iov_len     = ctx->rcvBufLen;
+        msg.msg_namelen = sizeof(nlSockAddrKern);
+        msg.msg_flags   = 0;
+        status          = recvmsg(ctx->sh->fd, &msg, 0);
 
         // Check if received message is correct.
         if(status < 0) {
@@ -648,102 +1007,1539 @@ int nlModifyRoute(struct nlRouteInfo *nlRtInfo, int hType,
             goto out;
         }
 
-        // Check sender address.
-        if(msg.msg_namelen != sizeof(nlSockAddrKern)) {
-            _OSBASE_TRACE(1, ("[ERROR] - Wrong sender address length == %d.",
-                              msg.msg_namelen));
-            rc = NL_FAIL;
-            goto out;
+        // Check sender address (only the kernel is allowed to answer).
+        if((msg.msg_namelen != sizeof(nlSockAddrKern)) ||
+           (nlSockAddrKern.nl_pid != 0)) {
+            _OSBASE_TRACE(2, ("[INFO] - Skip message from unexpected sender."));
+            continue;
         }
+        break;
+    }
 
-        // Parse receive message.
-        for(rcvH=(struct nlmsghdr*)rcvBuffer ; status>=sizeof(*rcvH) ; ) {
-            int len = rcvH->nlmsg_len;
-            int l = len - sizeof(*rcvH);
-
-            // Check message length.
-            if((l<0) || (len>status)) {
-                // MSG_TRUNC = Normal data truncated.
-                if(msg.msg_flags & MSG_TRUNC) {
-                    _OSBASE_TRACE(1, ("[ERROR] - Truncated message."));
-                    rc = NL_FAIL;
-                    goto out;
-                }
-                _OSBASE_TRACE(1, ("[ERROR] - Malformed message: len=%d.", len));
-                rc = NL_FAIL;
-                goto out;
-            }
+    // MSG_TRUNC = Normal data truncated. The rest of the datagram is lost,
+    // so we can not know which requests lost replies.
+    if(msg.msg_flags & MSG_TRUNC) {
+        _OSBASE_TRACE(1, ("[ERROR] - Truncated message."));
+        rc = NL_FAIL;
+        goto out;
+    }
+    *len = status;
 
-            // Check pid and seq.
-            if((nlSockAddrKern.nl_pid != 0) ||
-               (rcvH->nlmsg_pid != req.h.nlmsg_pid) ||
-               (rcvH->nlmsg_seq != req.h.nlmsg_seq)) {
-                // Don't forget to skip that message.
-                status -= NLMSG_ALIGN(len);
-                rcvH = (struct nlmsghdr*)((char*)rcvH + NLMSG_ALIGN(len));
-                continue;
-            }
+ out:
+    _OSBASE_TRACE(3, ("--- nlTransportRecv() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
 
-            // Error / ACK received.
-            if(rcvH->nlmsg_type == NLMSG_ERROR) {
-                errmsg = (struct nlmsgerr*)NLMSG_DATA(rcvH);
-                if(l < sizeof(struct nlmsgerr)) {
-                    _OSBASE_TRACE(1, ("[ERROR] - Truncated message."));
-                    rc = NL_FAIL;
-                    goto out;
-                } else { // ACK
-                    errno = -errmsg->error;
-                    goto out;
-                }
-            }
+//------------------------------------------------------------------------------
+/**
+ * Used to take a finished request out of the socket tables.
+ * @param sh [in] socket handler.
+ * @param r [in] request handler.
+ * @param rc [in] request result.
+ */
+static void nlFinishRequest(struct nlSockHandle *sh, struct nlRequest *r,
+                            int rc)
+{
+    unsigned int i = 0;
 
-            _OSBASE_TRACE(1, ("[ERROR] - Unexpected reply!!!"));
-            status -= NLMSG_ALIGN(len);
-            rcvH = (struct nlmsghdr*)((char*)rcvH + NLMSG_ALIGN(len));
+    for(i=0 ; i<sh->nPending ; i++) {
+        if(sh->pending[i] == r) {
+            sh->pending[i] = sh->pending[--sh->nPending];
+            sh->pending[sh->nPending] = NULL;
+            break;
         }
+    }
+    if(sh->dump == r) {
+        sh->dump = NULL;
+    }
+    if(rc != NL_OK) {
+        r->rc = NL_FAIL;
+    }
+    r->done = 1;
+}
+//------------------------------------------------------------------------------
 
-        // MSG_TRUNC = Normal data truncated.
-        if(msg.msg_flags & MSG_TRUNC) {
-            _OSBASE_TRACE(2, ("[INFO] - Message truncated."));
-            continue;
-        }
-        if(status) {
-            _OSBASE_TRACE(1, ("[ERROR] - Remnant of size %d.", status));
-            rc = NL_FAIL;
-            goto out;
-        }
+//------------------------------------------------------------------------------
+/**
+ * Used to send a request: the next sequence number of the socket is
+ * assigned and the request is added to the pending table.
+ * @param ctx [in] request context.
+ * @param r [in] request handler.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlSendRequest(struct nlContext *ctx, struct nlRequest *r)
+{
+    _OSBASE_TRACE(3, ("--- nlSendRequest() called"));
+
+    struct nlSockHandle *sh = ctx->sh;  // Context socket.
+    int                  rc = NL_OK;    // Result handler.
+
+    // Sequence number, unique among the requests in flight on this socket
+    // (0 is never used, it marks a request not sent yet).
+    if(++sh->seq == 0) {
+        ++sh->seq;
+    }
+    r->seq            = sh->seq;
+    r->msg->nlmsg_seq = r->seq;
+    // Port ID of the sending socket (opaque for netlink core).
+    r->msg->nlmsg_pid = sh->local.nl_pid;
+
+    if(nlTransportSend(ctx, r->msg) != NL_OK) {
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    sh->pending[sh->nPending++] = r;
+    if(r->isDump) {
+        sh->dump = r;
     }
 
  out:
-    _OSBASE_TRACE(3, ("--- nlModifyRoute() exited"));
+    _OSBASE_TRACE(3, ("--- nlSendRequest() exited"));
     return rc;
 }
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlAddRouteToList(const struct nlmsghdr *rcvH,
-                     struct nlRouteInfoList **nlRtInfoList,
-                     const struct nlRouteInfo *nlRtInfo)
+/**
+ * Used to send the next queued dump once the socket is free for it.
+ * @param ctx [in] request context.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlStartNextDump(struct nlContext *ctx)
 {
-    _OSBASE_TRACE(3, ("--- nlAddRouteToList() called"));
+    struct nlSockHandle *sh = ctx->sh; // Context socket.
+    struct nlRequest    *r  = NULL;    // Next dump.
 
-    struct nlRouteInfoList *nlRtInfoListCurr = NULL;  // Current routes list.
-    struct rtmsg           *rMsg             = NULL;  // Message content.
-    struct rtattr          *rAttr            = NULL;  // Message attributes.
-    int                     rAttrCount       = 0;     // Number of message
-                                                      // attributes.
-    int                     rc               = NL_OK; // Result handler.
+    if((sh->dump != NULL) || (sh->dumpHead == NULL) ||
+       (sh->nPending >= NL_MAX_INFLIGHT)) {
+        return NL_OK;
+    }
 
-    // Check netlink message header.
-    if(rcvH == NULL) {
-        _OSBASE_TRACE(1, ("[ERROR] - Invalid netlink message."));
+    r = sh->dumpHead;
+    sh->dumpHead = r->next;
+    if(sh->dumpHead == NULL) {
+        sh->dumpTail = NULL;
+    }
+    r->next = NULL;
+
+    return nlSendRequest(ctx, r);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to fail every request of the context socket and give the socket back
+ * to the pool. Called when the socket itself can not be trusted anymore.
+ * @param ctx [in] request context.
+ */
+static void nlFailAll(struct nlContext *ctx)
+{
+    struct nlSockHandle *sh = ctx->sh; // Context socket.
+    struct nlRequest    *r  = NULL;    // Current request.
+
+    if(sh == NULL) {
+        return;
+    }
+
+    while(sh->nPending > 0) {
+        nlFinishRequest(sh, sh->pending[0], NL_FAIL);
+    }
+    while(sh->dumpHead != NULL) {
+        r = sh->dumpHead;
+        sh->dumpHead = r->next;
+        r->next = NULL;
+        nlFinishRequest(sh, r, NL_FAIL);
+    }
+    sh->dumpTail = NULL;
+
+#ifdef NL_USE_IO_URING
+    // Entries still queued refer to the socket being dropped.
+    nlUringExit(ctx);
+#endif
+
+    nlSockPoolPut(sh, NL_FAIL);
+    ctx->sh = NULL;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to receive one datagram and route each of its messages to the
+ * pending request with the same sequence number.
+ * @param ctx [in] request context.
+ * @return NL_OK=succesful | NL_FAIL=fail (socket error)
+ */
+static int nlDispatch(struct nlContext *ctx)
+{
+    _OSBASE_TRACE(3, ("--- nlDispatch() called"));
+
+    struct nlSockHandle *sh     = ctx->sh; // Context socket.
+    struct nlmsghdr     *rcvH   = NULL;    // Received Netlink message
+                                           // header.
+    struct nlmsgerr     *errmsg = NULL;    // Netlink errors container.
+    struct nlRequest    *r      = NULL;    // Request the message belongs to.
+    unsigned int         i      = 0;
+    int                  status = 0;       // Receive message status.
+    int                  rc     = NL_OK;   // Result handler.
+
+    if(nlTransportRecv(ctx, &status) != NL_OK) {
         rc = NL_FAIL;
         goto out;
     }
 
-    // Check Route filter info.
-    if(nlRtInfo == NULL) {
-        _OSBASE_TRACE(1, ("[ERROR] - Invalid route filter info."));
+    // Parse received messages.
+    for(rcvH = (struct nlmsghdr*)ctx->rcvBuf ; NLMSG_OK(rcvH, status) ;
+        rcvH = NLMSG_NEXT(rcvH, status)) {
+        // Find the request by pid and seq.
+        r = NULL;
+        if(rcvH->nlmsg_pid == sh->local.nl_pid) {
+            for(i=0 ; i<sh->nPending ; i++) {
+                if(sh->pending[i]->seq == rcvH->nlmsg_seq) {
+                    r = sh->pending[i];
+                    break;
+                }
+            }
+        }
+        if(r == NULL) {
+            _OSBASE_TRACE(2, ("[INFO] - Skip reply of unknown request %u.",
+                              rcvH->nlmsg_seq));
+            continue;
+        }
+
+        // The dump was interrupted by a change (the DONE message carries
+        // the flag too).
+        if(rcvH->nlmsg_flags & NLM_F_DUMP_INTR) {
+            r->intr = 1;
+        }
+
+        // If done, the request is finished. Newer kernels report dump errors
+        // here.
+        if(rcvH->nlmsg_type == NLMSG_DONE) {
+            if((rcvH->nlmsg_len >= NLMSG_LENGTH(sizeof(int))) &&
+               (*((int*)NLMSG_DATA(rcvH)) < 0)) {
+                r->err = -(*((int*)NLMSG_DATA(rcvH)));
+                _OSBASE_TRACE(1, ("[ERROR] - RTNETLINK dump failed. %s",
+                                  strerror(r->err)));
+                nlFinishRequest(sh, r, NL_FAIL);
+            } else {
+                nlFinishRequest(sh, r, NL_OK);
+            }
+            continue;
+        }
+
+        // Error / ACK received.
+        if(rcvH->nlmsg_type == NLMSG_ERROR) {
+            errmsg = (struct nlmsgerr*)NLMSG_DATA(rcvH);
+            if(rcvH->nlmsg_len < NLMSG_LENGTH(sizeof(*errmsg))) {
+                _OSBASE_TRACE(1, ("[ERROR] - Truncated."));
+                nlFinishRequest(sh, r, NL_FAIL);
+                continue;
+            }
+            if(errmsg->error == 0) { // ACK
+                if(!r->isDump) {
+                    nlFinishRequest(sh, r, NL_OK);
+                }
+                continue;
+            }
+            r->err = -errmsg->error;
+            _OSBASE_TRACE(1, ("[ERROR] - RTNETLINK answers. %s",
+                              strerror(r->err)));
+            nlFinishRequest(sh, r, NL_FAIL);
+            continue;
+        }
+
+        // Deliver the message. Once a dump has failed, the rest of it is
+        // only drained.
+        if(r->rc == NL_OK) {
+            if(r->handler == NULL) {
+                _OSBASE_TRACE(1, ("[ERROR] - Unexpected reply!!!"));
+            } else if(r->handler(rcvH, r->arg) == NL_FAIL) {
+                r->rc = NL_FAIL;
+                if(!r->isDump) {
+                    nlFinishRequest(sh, r, NL_FAIL);
+                    continue;
+                }
+            }
+        }
+
+        // A non dump request without ACK has a single reply.
+        if((!r->isDump) && (!(r->msg->nlmsg_flags & NLM_F_ACK))) {
+            nlFinishRequest(sh, r, NL_OK);
+        }
+    }
+
+    if(status) {
+        _OSBASE_TRACE(1, ("[ERROR] - Remnant of size %d.", status));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // The dump in progress may be over.
+    rc = nlStartNextDump(ctx);
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlDispatch() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to borrow a socket from the pool for the lifetime of the context.
+ * @param ctx [in] request context.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlCtxGetSocket(struct nlContext *ctx)
+{
+    if(ctx->sh == NULL) {
+        ctx->sh = (ctx->noPool) ? nlSockPrivate() : nlSockPoolGet();
+        if(ctx->sh == NULL) {
+            _OSBASE_TRACE(1, ("[ERROR] - Unable to get a netlink socket."));
+            return NL_FAIL;
+        }
+    }
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlSubmit(struct nlContext *ctx, struct nlRequest *r,
+             struct nlmsghdr *req, nlMsgHandler handler, void *arg)
+{
+    _OSBASE_TRACE(3, ("--- nlSubmit() called"));
+
+    int rc = NL_OK; // Result handler.
+
+    // Check received parameters.
+    if((ctx == NULL) || (r == NULL) || (req == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    memset(r, 0, sizeof(*r));
+    r->msg     = req;
+    r->handler = handler;
+    r->arg     = arg;
+    r->rc      = NL_OK;
+    // Dumps are terminated by NLMSG_DONE, everything else by its reply or
+    // by the ACK.
+    r->isDump  = ((req->nlmsg_flags & NLM_F_DUMP) == NLM_F_DUMP);
+
+    // Borrow a socket for the lifetime of the context.
+    if(nlCtxGetSocket(ctx) != NL_OK) {
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Receive buffer.
+    if(ctx->rcvBuf == NULL) {
+        ctx->rcvBuf = malloc(NL_RCV_BUFF_INIT);
+        if(ctx->rcvBuf == NULL) {
+            _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
+                              "\'rcvBuf\'."));
+            rc = NL_FAIL;
+            goto out;
+        }
+        ctx->rcvBufLen = NL_RCV_BUFF_INIT;
+    }
+
+#ifdef NL_USE_IO_URING
+    nlUringInit(ctx);
+#endif
+
+    // The kernel runs a single dump per socket, the others wait for it.
+    if(r->isDump && ((ctx->sh->dump != NULL) || (ctx->sh->dumpHead != NULL))) {
+        if(ctx->sh->dumpTail != NULL) {
+            ctx->sh->dumpTail->next = r;
+        } else {
+            ctx->sh->dumpHead = r;
+        }
+        ctx->sh->dumpTail = r;
+        goto out;
+    }
+
+    // Make room in the pending table.
+    while(ctx->sh->nPending >= NL_MAX_INFLIGHT) {
+        if(nlDispatch(ctx) != NL_OK) {
+            nlFailAll(ctx);
+            rc = NL_FAIL;
+            goto out;
+        }
+    }
+
+    if(nlSendRequest(ctx, r) != NL_OK) {
+        nlFailAll(ctx);
+        rc = NL_FAIL;
+        goto out;
+    }
+
+ out:
+    if((rc != NL_OK) && (r != NULL)) {
+        r->rc   = NL_FAIL;
+        r->done = 1;
+    }
+
+    _OSBASE_TRACE(3, ("--- nlSubmit() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlWait(struct nlContext *ctx, struct nlRequest *r)
+{
+    _OSBASE_TRACE(3, ("--- nlWait() called"));
+
+    int rc = NL_OK; // Result handler.
+
+    // Check received parameters.
+    if((ctx == NULL) || (r == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Dispatch replies until this request is done.
+    while(!r->done) {
+        if((ctx->sh == NULL) || (nlDispatch(ctx) != NL_OK)) {
+            nlFailAll(ctx);
+            r->rc   = NL_FAIL;
+            r->done = 1;
+        }
+    }
+
+    rc = r->rc;
+    if(r->err) {
+        errno = r->err;
+    }
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlWait() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlTalk(struct nlContext *ctx, struct nlmsghdr *req,
+           nlMsgHandler handler, void *arg)
+{
+    _OSBASE_TRACE(3, ("--- nlTalk() called"));
+
+    struct nlRequest r;          // Request handler.
+    int              rc = NL_OK; // Result handler.
+
+    if(nlSubmit(ctx, &r, req, handler, arg) != NL_OK) {
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    if(nlWait(ctx, &r) != NL_OK) {
+        rc = NL_FAIL;
+        goto out;
+    }
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlTalk() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlTalkDump(struct nlContext *ctx, struct nlmsghdr *req,
+               nlMsgHandler handler, nlDumpReset reset, void *arg)
+{
+    _OSBASE_TRACE(3, ("--- nlTalkDump() called"));
+
+    struct nlRequest r;                           // Request handler.
+    struct timespec  wait;                        // Wait before a restart.
+    long             waitMs = NL_DUMP_BACKOFF_MS; // Wait length.
+    unsigned int     retry  = 0;                  // Restarts done.
+    int              rc     = NL_OK;              // Result handler.
+
+    __sync_fetch_and_add(&nlStats.dumps, 1);
+
+    while(1) {
+        if((nlSubmit(ctx, &r, req, handler, arg) != NL_OK) ||
+           (nlWait(ctx, &r) != NL_OK)) {
+            rc = NL_FAIL;
+            goto out;
+        }
+        if(!r.intr) {
+            break;
+        }
+
+        // The routes or links changed during the dump.
+        __sync_fetch_and_add(&nlStats.dumpsIntr, 1);
+        if(retry == NL_DUMP_RETRIES) {
+            __sync_fetch_and_add(&nlStats.dumpsInconsistent, 1);
+            _OSBASE_TRACE(1, ("[ERROR] - Dump still interrupted after %u " \
+                              "retries, it may be inconsistent.", retry));
+            break;
+        }
+        _OSBASE_TRACE(2, ("[INFO] - Dump interrupted, restart in %ld ms.",
+                          waitMs));
+        if(reset != NULL) {
+            reset(arg);
+        }
+        wait.tv_sec  = waitMs / 1000;
+        wait.tv_nsec = (waitMs % 1000) * 1000000;
+        while((nanosleep(&wait, &wait) < 0) && (errno == EINTR));
+        waitMs *= 2;
+        retry++;
+        __sync_fetch_and_add(&nlStats.dumpRetries, 1);
+    }
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlTalkDump() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlGetStats(struct nlStats *stats)
+{
+    // Check received parameters.
+    if(stats == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        return NL_FAIL;
+    }
+
+    stats->dumps             = __sync_fetch_and_add(&nlStats.dumps, 0);
+    stats->dumpsIntr         = __sync_fetch_and_add(&nlStats.dumpsIntr, 0);
+    stats->dumpRetries       = __sync_fetch_and_add(&nlStats.dumpRetries, 0);
+    stats->dumpsInconsistent =
+        __sync_fetch_and_add(&nlStats.dumpsInconsistent, 0);
+
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Arena chunk. The data follows the header, the chunks of an arena are
+ * linked from the newest one.
+ */
+struct nlArenaChunk {
+    struct nlArenaChunk *prev; /**< Previous chunk. */
+    size_t               size; /**< Usable length. */
+    size_t               used; /**< Bytes handed out. */
+};
+
+/**
+ * Offset of the data of a chunk.
+ */
+#define NL_ARENA_HDR_LEN                                                \
+    ((sizeof(struct nlArenaChunk) + NL_ARENA_ALIGN - 1) &               \
+     ~((size_t)NL_ARENA_ALIGN - 1))
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void nlArenaInit(struct nlArena *arena)
+{
+    if(arena != NULL) {
+        memset(arena, 0, sizeof(*arena));
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void* nlArenaAlloc(struct nlArena *arena, size_t len)
+{
+    struct nlArenaChunk *chunk = NULL; // Chunk the memory is taken from.
+    size_t               size  = 0;    // Usable length of a new chunk.
+    char                *ptr   = NULL; // Allocated memory.
+
+    // Check received parameters.
+    if((arena == NULL) || (len == 0) || (len > (size_t)-1 / 2)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        return NULL;
+    }
+    len = (len + NL_ARENA_ALIGN - 1) & ~((size_t)NL_ARENA_ALIGN - 1);
+
+    chunk = arena->head;
+    if((chunk == NULL) || (chunk->size - chunk->used < len)) {
+        // Large allocations get a chunk of their own, kept behind the
+        // current one so its free space is not lost.
+        size  = (len > NL_ARENA_CHUNK_LEN / 4) ? len : NL_ARENA_CHUNK_LEN;
+        chunk = malloc(NL_ARENA_HDR_LEN + size);
+        if(chunk == NULL) {
+            _OSBASE_TRACE(1, ("[ERROR] - Could not alloc arena chunk of " \
+                              "%lu bytes.", (unsigned long)size));
+            return NULL;
+        }
+        chunk->size  = size;
+        chunk->used  = 0;
+        arena->size += NL_ARENA_HDR_LEN + size;
+        if((size != NL_ARENA_CHUNK_LEN) && (arena->head != NULL)) {
+            chunk->prev       = arena->head->prev;
+            arena->head->prev = chunk;
+        } else {
+            chunk->prev = arena->head;
+            arena->head = chunk;
+        }
+    }
+
+    ptr          = (char*)chunk + NL_ARENA_HDR_LEN + chunk->used;
+    chunk->used += len;
+    memset(ptr, 0, len);
+    return ptr;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void nlArenaRelease(struct nlArena *arena)
+{
+    struct nlArenaChunk *chunk = NULL; // Chunk to be freed.
+
+    if(arena == NULL) {
+        return;
+    }
+
+    while(arena->head != NULL) {
+        chunk       = arena->head;
+        arena->head = chunk->prev;
+        free(chunk);
+    }
+    arena->size = 0;
+    arena->strs = NULL;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Strings interned in an arena, open addressing by hash. The table itself
+ * is arena memory: when it grows, the old arrays stay in the arena until
+ * it is released (at most as much as the new ones).
+ */
+struct nlStrTab {
+    const char  **strs;   /**< Strings by handle (strs[0] is ""). */
+    uint32_t     *hashes; /**< Hash of every string by handle. */
+    nlStrId      *slots;  /**< Handle of every slot (0=free, "" is never
+                             stored). */
+    unsigned int  count;  /**< Handles given. */
+    unsigned int  mask;   /**< Number of slots - 1 (0=no slots yet). */
+};
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to hash a string (FNV-1a).
+ * @param s [in] string.
+ * @param len [in] string length.
+ * @return hash.
+ */
+static uint32_t nlStrHash(const char *s, size_t len)
+{
+    uint32_t hash = 2166136261U; // Current hash.
+    size_t   i    = 0;           // Current character.
+
+    for(i=0 ; i<len ; i++) {
+        hash = (hash ^ (unsigned char)s[i]) * 16777619U;
+    }
+    return hash;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to look a string up in a table with slots.
+ * @param tab [in] table.
+ * @param s [in] string.
+ * @param len [in] string length (no NUL within).
+ * @param hash [in] string hash.
+ * @return slot of the string | free slot where it goes.
+ */
+static unsigned int nlStrSlot(const struct nlStrTab *tab, const char *s,
+                              size_t len, uint32_t hash)
+{
+    unsigned int slot = hash & tab->mask; // Current slot.
+    nlStrId      id   = 0;                // Handle in the slot.
+
+    while((id = tab->slots[slot]) != 0) {
+        if((tab->hashes[id] == hash) &&
+           (strncmp(tab->strs[id], s, len) == 0) &&
+           (tab->strs[id][len] == '\0')) {
+            break;
+        }
+        slot = (slot + 1) & tab->mask;
+    }
+    return slot;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to double the slots of a table (the first call creates them).
+ * @param arena [in] arena of the table.
+ * @param tab [in] table.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlStrTabGrow(struct nlArena *arena, struct nlStrTab *tab)
+{
+    unsigned int   nSlots = 0;    // New number of slots.
+    const char   **strs   = NULL; // New strings array.
+    uint32_t      *hashes = NULL; // New hashes array.
+    nlStrId       *slots  = NULL; // New slots.
+    unsigned int   slot   = 0;    // Current slot.
+    nlStrId        id     = 0;    // Current handle.
+
+    nSlots = (tab->mask == 0) ? NL_STR_TAB_SLOTS : 2 * (tab->mask + 1);
+    strs   = nlArenaAlloc(arena, nSlots / 2 * sizeof(*strs));
+    hashes = nlArenaAlloc(arena, nSlots / 2 * sizeof(*hashes));
+    slots  = nlArenaAlloc(arena, nSlots * sizeof(*slots));
+    if((strs == NULL) || (hashes == NULL) || (slots == NULL)) {
+        return NL_FAIL;
+    }
+
+    if(tab->count == 0) {
+        strs[NL_STR_EMPTY] = "";
+        tab->count         = 1;
+    } else {
+        memcpy(strs, tab->strs, tab->count * sizeof(*strs));
+        memcpy(hashes, tab->hashes, tab->count * sizeof(*hashes));
+    }
+    for(id=1 ; id<tab->count ; id++) {
+        slot = hashes[id] & (nSlots - 1);
+        while(slots[slot] != 0) {
+            slot = (slot + 1) & (nSlots - 1);
+        }
+        slots[slot] = id;
+    }
+
+    tab->strs   = strs;
+    tab->hashes = hashes;
+    tab->slots  = slots;
+    tab->mask   = nSlots - 1;
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+nlStrId nlStrIntern(struct nlArena *arena, const char *s, size_t len)
+{
+    struct nlStrTab *tab  = NULL; // Arena table.
+    char            *copy = NULL; // Interned copy.
+    uint32_t         hash = 0;    // String hash.
+    unsigned int     slot = 0;    // String slot.
+
+    if((arena == NULL) || (s == NULL)) {
+        return NL_STR_INVALID;
+    }
+    len = strnlen(s, len);
+    if(len == 0) {
+        return NL_STR_EMPTY;
+    }
+
+    if(arena->strs == NULL) {
+        arena->strs = nlArenaAlloc(arena, sizeof(*(arena->strs)));
+        if(arena->strs == NULL) {
+            return NL_STR_INVALID;
+        }
+    }
+    tab  = arena->strs;
+    hash = nlStrHash(s, len);
+    if(tab->mask != 0) {
+        slot = nlStrSlot(tab, s, len, hash);
+        if(tab->slots[slot] != 0) {
+            return tab->slots[slot];
+        }
+    }
+
+    // New string, the table is kept at most half full.
+    if(tab->count >= (tab->mask + 1) / 2) {
+        if(nlStrTabGrow(arena, tab) != NL_OK) {
+            return NL_STR_INVALID;
+        }
+        slot = nlStrSlot(tab, s, len, hash);
+    }
+    copy = nlArenaAlloc(arena, len + 1);
+    if(copy == NULL) {
+        return NL_STR_INVALID;
+    }
+    memcpy(copy, s, len);
+    tab->strs[tab->count]   = copy;
+    tab->hashes[tab->count] = hash;
+    tab->slots[slot]        = tab->count;
+    return tab->count++;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+nlStrId nlStrFind(const struct nlArena *arena, const char *s, size_t len)
+{
+    const struct nlStrTab *tab  = NULL; // Arena table.
+    unsigned int           slot = 0;    // String slot.
+
+    if((arena == NULL) || (s == NULL)) {
+        return NL_STR_INVALID;
+    }
+    len = strnlen(s, len);
+    if(len == 0) {
+        return NL_STR_EMPTY;
+    }
+
+    tab = arena->strs;
+    if((tab == NULL) || (tab->mask == 0)) {
+        return NL_STR_INVALID;
+    }
+    slot = nlStrSlot(tab, s, len, nlStrHash(s, len));
+    return (tab->slots[slot] != 0) ? tab->slots[slot] : NL_STR_INVALID;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+const char* nlStrGet(const struct nlArena *arena, nlStrId id)
+{
+    if((arena == NULL) || (arena->strs == NULL) ||
+       (id >= arena->strs->count)) {
+        return "";
+    }
+    return arena->strs->strs[id];
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+struct nlAttrDesc;
+
+/**
+ * Used to compare an attribute with the filter. Interned strings are
+ * looked up in arena.
+ * @return 1=match | 0=no match
+ */
+typedef int (*nlAttrMatchFn)(struct nlArena *arena,
+                             const struct nlAttrDesc *desc,
+                             const struct rtattr *rAttr,
+                             const void *flt, const void *fltInfo);
+
+/**
+ * Used to store an attribute in the received info. Interned strings are
+ * added to arena.
+ * @return NL_OK=succesful | NL_SKIP=skip
+ */
+typedef int (*nlAttrCopyFn)(struct nlArena *arena,
+                            const struct nlAttrDesc *desc,
+                            const struct rtattr *rAttr, void *info);
+
+#define NL_ATTR_F_FIXED 0x01 /**< Payload must hold the whole field. */
+#define NL_ATTR_F_STATS 0x02 /**< Not copied when ctx->noStats is set. */
+
+/**
+ * Attribute descriptor. The tables are indexed by attribute type, an entry
+ * without decoder is an attribute nobody asked for.
+ */
+struct nlAttrDesc {
+    nlAttrMatchFn match; /**< Filter test (NULL = not tested here). */
+    nlAttrCopyFn  copy;  /**< Decoder. */
+    unsigned int  flags; /**< NL_ATTR_F_*. */
+    size_t        aux;   /**< Length field offset in the info (binary) or
+                            compiled address offset in the filter. */
+    size_t        off;   /**< Field offset in the info. */
+    size_t        len;   /**< Field length. */
+    size_t        flt;   /**< Flag offset in the filter. */
+    const char   *name;  /**< Attribute description. */
+};
+
+/**
+ * Descriptor of the attribute "type" stored in the field "f" of the info
+ * struct "I", filtered by the flag "f" of the filter struct "F". "kind" is
+ * one of the NL_ATTR_<kind> decoders.
+ */
+#define NL_ATTR_DESC(I, F, kind, type, f, name)                         \
+    [type] = { NL_ATTR_##kind(I, F, f), offsetof(I, f),                 \
+               sizeof(((I*)0)->f), offsetof(F, f), name },
+
+#define NL_ATTR_U8(I, F, f)       nlAttrMatchU8, nlAttrCopyU8,          \
+                                  NL_ATTR_F_FIXED, 0
+#define NL_ATTR_U32(I, F, f)      nlAttrMatchU32, nlAttrCopyU32,        \
+                                  NL_ATTR_F_FIXED, 0
+#define NL_ATTR_U32_COPY(I, F, f) NULL, nlAttrCopyU32, NL_ATTR_F_FIXED, 0
+#define NL_ATTR_STR_ID(I, F, f)   nlAttrMatchStrId, nlAttrCopyStrId, 0, 0
+#define NL_ATTR_BIN(I, F, f)      nlAttrMatchBin, nlAttrCopyBin, 0,     \
+                                  offsetof(I, f##Len)
+#define NL_ATTR_MEM(I, F, f)      NULL, nlAttrCopyMem, 0, 0
+#define NL_ATTR_STATS(I, F, f)    NULL, nlAttrCopyMem, NL_ATTR_F_STATS, 0
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a field of an info struct.
+ */
+#define NL_ATTR_FIELD(info, desc) ((char*)(info) + (desc)->off)
+#define NL_ATTR_CFIELD(info, desc) ((const char*)(info) + (desc)->off)
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrMatchU8(struct nlArena *arena,
+                         const struct nlAttrDesc *desc,
+                         const struct rtattr *rAttr,
+                         const void *flt, const void *fltInfo)
+{
+    (void)arena;
+    (void)flt;
+
+    return (*((const unsigned char*)RTA_DATA(rAttr)) ==
+            *((const unsigned char*)NL_ATTR_CFIELD(fltInfo, desc)));
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrCopyU8(struct nlArena *arena,
+                        const struct nlAttrDesc *desc,
+                        const struct rtattr *rAttr, void *info)
+{
+    (void)arena;
+
+    *((unsigned char*)NL_ATTR_FIELD(info, desc)) =
+        *((const unsigned char*)RTA_DATA(rAttr));
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrMatchU32(struct nlArena *arena,
+                          const struct nlAttrDesc *desc,
+                          const struct rtattr *rAttr,
+                          const void *flt, const void *fltInfo)
+{
+    (void)arena;
+    (void)flt;
+
+    return (*((const unsigned int*)RTA_DATA(rAttr)) ==
+            *((const unsigned int*)NL_ATTR_CFIELD(fltInfo, desc)));
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrCopyU32(struct nlArena *arena,
+                         const struct nlAttrDesc *desc,
+                         const struct rtattr *rAttr, void *info)
+{
+    (void)arena;
+
+    *((unsigned int*)NL_ATTR_FIELD(info, desc)) =
+        *((const unsigned int*)RTA_DATA(rAttr));
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrMatchStrId(struct nlArena *arena,
+                            const struct nlAttrDesc *desc,
+                            const struct rtattr *rAttr,
+                            const void *flt, const void *fltInfo)
+{
+    (void)flt;
+
+    return (nlStrFind(arena, (const char*)RTA_DATA(rAttr),
+                      RTA_PAYLOAD(rAttr)) ==
+            *((const nlStrId*)NL_ATTR_CFIELD(fltInfo, desc)));
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrCopyStrId(struct nlArena *arena,
+                           const struct nlAttrDesc *desc,
+                           const struct rtattr *rAttr, void *info)
+{
+    nlStrId id = nlStrIntern(arena, (const char*)RTA_DATA(rAttr),
+                             RTA_PAYLOAD(rAttr)); // Interned string.
+
+    if(id == NL_STR_INVALID) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not intern \'%s\'.", desc->name));
+        return NL_SKIP;
+    }
+    *((nlStrId*)NL_ATTR_FIELD(info, desc)) = id;
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrMatchBin(struct nlArena *arena,
+                          const struct nlAttrDesc *desc,
+                          const struct rtattr *rAttr,
+                          const void *flt, const void *fltInfo)
+{
+    unsigned int len = *((const int*)((const char*)fltInfo + desc->aux));
+
+    (void)arena;
+    (void)flt;
+
+    return ((RTA_PAYLOAD(rAttr) == len) &&
+            (memcmp(RTA_DATA(rAttr), NL_ATTR_CFIELD(fltInfo, desc),
+                    len) == 0));
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrCopyBin(struct nlArena *arena,
+                         const struct nlAttrDesc *desc,
+                         const struct rtattr *rAttr, void *info)
+{
+    size_t len = RTA_PAYLOAD(rAttr); // Stored length.
+
+    (void)arena;
+
+    if(len > desc->len) {
+        len = desc->len;
+    }
+    memcpy(NL_ATTR_FIELD(info, desc), RTA_DATA(rAttr), len);
+    *((int*)((char*)info + desc->aux)) = len;
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlAttrCopyMem(struct nlArena *arena,
+                         const struct nlAttrDesc *desc,
+                         const struct rtattr *rAttr, void *info)
+{
+    size_t len = RTA_PAYLOAD(rAttr); // Copied length.
+
+    (void)arena;
+
+    if(len > desc->len) {
+        len = desc->len;
+    }
+    memcpy(NL_ATTR_FIELD(info, desc), RTA_DATA(rAttr), len);
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to decode the attributes of a message with a descriptor table.
+ * Each attribute is looked up by type, tested against the filter when its
+ * filter flag is set and copied. Attributes without descriptor are
+ * skipped.
+ * @param ctx [in] request context.
+ * @param tbl [in] descriptor table (indexed by attribute type).
+ * @param tblLen [in] number of descriptors.
+ * @param skip [in] attributes not wanted (NL_ATTR_BIT), decoded only when
+ * the filter uses them.
+ * @param rAttr [in] first attribute.
+ * @param rAttrCount [in] attributes length.
+ * @param flt [in] filter flags.
+ * @param fltInfo [in] info used as filter.
+ * @param info [out] received info.
+ * @return NL_OK=succesful | NL_SKIP=skip
+ */
+static int nlDecodeAttrs(const struct nlContext *ctx,
+                         const struct nlAttrDesc *tbl, unsigned int tblLen,
+                         unsigned long long skip,
+                         const struct rtattr *rAttr, int rAttrCount,
+                         const void *flt, const void *fltInfo, void *info)
+{
+    const struct nlAttrDesc *desc = NULL; // Attribute descriptor.
+
+    for( ; RTA_OK(rAttr, rAttrCount) ; rAttr=RTA_NEXT(rAttr, rAttrCount)) {
+        if(rAttr->rta_type >= tblLen) {
+            continue;
+        }
+        desc = &tbl[rAttr->rta_type];
+        if((desc->copy == NULL) ||
+           ((desc->flags & NL_ATTR_F_FIXED) &&
+            (RTA_PAYLOAD(rAttr) < desc->len)) ||
+           ((desc->flags & NL_ATTR_F_STATS) && (ctx->noStats)) ||
+           ((skip & NL_ATTR_BIT(rAttr->rta_type)) &&
+            (!((const unsigned char*)flt)[desc->flt]))) {
+            continue;
+        }
+        if((desc->match != NULL) &&
+           (((const unsigned char*)flt)[desc->flt]) &&
+           (!desc->match(ctx->arena, desc, rAttr, flt, fltInfo))) {
+            _OSBASE_TRACE(2, ("[INFO] - Skip \'%s\'.", desc->name));
+            return NL_SKIP;
+        }
+        if(desc->copy(ctx->arena, desc, rAttr, info) != NL_OK) {
+            return NL_SKIP;
+        }
+    }
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ROUTES
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+/**
+ * Data handed to nlRouteMsgHandler and nlRouteDumpReset by nlGetRoutes.
+ */
+struct nlRouteHandlerArg {
+    struct nlContext    *ctx;      /**< Request context. */
+    struct nlRouteList **nlRtList; /**< List where routes are added. */
+    struct nlRouteList  *head;     /**< List head before the dump. */
+};
+
+/**
+ * nlTalk callback used to add every received route to a list.
+ * @param rcvH [in] route message header.
+ * @param arg [in] nlRouteHandlerArg.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlRouteMsgHandler(const struct nlmsghdr *rcvH, void *arg)
+{
+    struct nlRouteHandlerArg *hArg = (struct nlRouteHandlerArg*)arg;
+
+    if(rcvH->nlmsg_type != RTM_NEWROUTE) {
+        _OSBASE_TRACE(2, ("[INFO] - Skip unexpected message type %d.",
+                          rcvH->nlmsg_type));
+        return NL_OK;
+    }
+
+    if(nlAddRouteToList(hArg->ctx, rcvH, hArg->nlRtList) == NL_FAIL) {
+        return NL_FAIL;
+    }
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * nlTalkDump callback used to drop the routes added by an interrupted dump
+ * (they were added at the head of the list). Their memory stays in the
+ * arena until the request is over.
+ * @param arg [in] nlRouteHandlerArg.
+ */
+static void nlRouteDumpReset(void *arg)
+{
+    struct nlRouteHandlerArg *hArg = (struct nlRouteHandlerArg*)arg;
+
+    *(hArg->nlRtList) = hArg->head;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlGetRoutes(struct nlContext *ctx, struct nlRouteList **nlRtList,
+                struct nlRouteInfo *nlRtInfo)
+{
+    _OSBASE_TRACE(3, ("--- nlGetRoutes() called"));
+
+    struct nlRouteHandlerArg hArg;       // Route handler data.
+    int                      rc = NL_OK; // Result handler.
+
+    // Buffer to hold the RTNETLINK request.
+    struct {
+        struct nlmsghdr h;        // Netlink message header.
+        struct rtmsg    m;        // Message.
+        char            buf[64];  // Filter attributes.
+    } req;
+
+    // Check received parameters.
+    if((ctx == NULL) || (ctx->arena == NULL) || (nlRtInfo == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Generate filter.
+    if(nlGenRouteFilter(ctx, nlRtInfo) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Problem generating route filter."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Fill request message.
+    memset(&req, 0, sizeof(req));
+    // Length of message including header.
+    req.h.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    // Receive information about a network route.
+    req.h.nlmsg_type = RTM_GETROUTE;
+    // Return the complete table matching criteria passed in message content.
+    req.h.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    // Address family of route.
+    req.m.rtm_family = nlRtInfo->family;
+    // Length of source.
+    req.m.rtm_src_len = 0;
+    // Length of destination.
+    req.m.rtm_dst_len = 0;
+    // TOS filter.
+    req.m.rtm_tos = 0;
+    // Routing table.
+    req.m.rtm_table = RT_TABLE_UNSPEC;
+    // Route origin.
+    req.m.rtm_protocol = RTN_UNSPEC;
+    // Distance to the destination.
+    req.m.rtm_scope = RT_SCOPE_UNIVERSE;
+    // Route type.
+    req.m.rtm_type = RTA_UNSPEC;
+
+    // With strict checking the kernel filters the dump by table, protocol,
+    // type and output interface. Without it (or for the other fields)
+    // NLM_F_MATCH is not implemented, so we are receiving all routes from
+    // all tables and nlAddRouteToList filters them.
+    if(nlCtxGetSocket(ctx) != NL_OK) {
+        rc = NL_FAIL;
+        goto out;
+    }
+    if(ctx->sh->strictChk) {
+        if(ctx->rtFlt.table) {
+            req.m.rtm_table = (nlRtInfo->table < 256) ?
+                nlRtInfo->table : RT_TABLE_COMPAT;
+            nlAddAttrToMsg32(&req.h, sizeof(req), RTA_TABLE,
+                             (uint32_t)(nlRtInfo->table));
+        }
+        if(ctx->rtFlt.protocol) {
+            req.m.rtm_protocol = nlRtInfo->protocol;
+        }
+        if(ctx->rtFlt.type) {
+            req.m.rtm_type = nlRtInfo->type;
+        }
+        // There is no interface 0: the kernel fails the dump with ENODEV.
+        // Routes without output interface (blackhole, unreachable...) are
+        // matched by nlAddRouteToList.
+        if(ctx->rtFlt.outputIf && (nlRtInfo->outputIf > 0)) {
+            nlAddAttrToMsg32(&req.h, sizeof(req), RTA_OIF,
+                             (uint32_t)(nlRtInfo->outputIf));
+        }
+    }
+
+    hArg.ctx      = ctx;
+    hArg.nlRtList = nlRtList;
+    hArg.head     = *nlRtList;
+    if(nlTalkDump(ctx, &req.h, nlRouteMsgHandler, nlRouteDumpReset,
+                  &hArg) != NL_OK) {
+        // A filtered dump fails when the table or the interface does not
+        // exist: no route matches.
+        if((ctx->sh != NULL) && (ctx->sh->strictChk) &&
+           ((errno == ENOENT) || (errno == ENODEV))) {
+            _OSBASE_TRACE(2, ("[INFO] - No route matches the filter. %s",
+                              strerror(errno)));
+            goto out;
+        }
+        _OSBASE_TRACE(1, ("[ERROR] - Unable to dump routes."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+ out:
+    if(rc != NL_OK) {
+        *nlRtList = NULL;
+    }
+
+    _OSBASE_TRACE(3, ("--- nlGetRoutes() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlGetRoute(struct nlContext *ctx, struct nlRouteList **nlRtList,
+               struct nlRouteInfo *nlRtInfo)
+{
+    _OSBASE_TRACE(3, ("--- nlGetRoute() called"));
+
+    struct nlRouteHandlerArg hArg;       // Route handler data.
+    int                      rc = NL_OK; // Result handler.
+
+    // Buffer to hold the RTNETLINK request.
+    struct {
+        struct nlmsghdr h;        // Netlink message header.
+        struct rtmsg    m;        // Message.
+        char            buf[64];  // Lookup attributes.
+    } req;
+
+    // Check received parameters.
+    if((ctx == NULL) || (ctx->arena == NULL) || (nlRtInfo == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Generate filter (also fixes the family of the filter addresses).
+    if(nlGenRouteFilter(ctx, nlRtInfo) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Problem generating route filter."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // A lookup needs a family and a destination (the unspecified address
+    // is resolved by the kernel as a local one, not as the default route).
+    if(((nlRtInfo->family != AF_INET) && (nlRtInfo->family != AF_INET6)) ||
+       (!ctx->rtFlt.dstAddr)) {
+        goto dump;
+    }
+
+    // Fill request message. Strict checking wants the header fields not
+    // used by a lookup zeroed.
+    memset(&req, 0, sizeof(req));
+    req.h.nlmsg_len   = NLMSG_LENGTH(sizeof(struct rtmsg));
+    req.h.nlmsg_type  = RTM_GETROUTE;
+    req.h.nlmsg_flags = NLM_F_REQUEST;
+    req.m.rtm_family  = nlRtInfo->family;
+    req.m.rtm_dst_len = (nlRtInfo->family == AF_INET) ? 32 : 128;
+    // Answer with the FIB entry used (not the resulting dst cache entry)
+    // and tell its table.
+    req.m.rtm_flags   = RTM_F_FIB_MATCH | RTM_F_LOOKUP_TABLE;
+    nlAddAttrToMsg(&req.h, sizeof(req), RTA_DST,
+                   ctx->rtFlt.dstAddrBin.data, ctx->rtFlt.dstAddrBin.len);
+
+    // The reply goes through the filter like a dumped route.
+    hArg.ctx      = ctx;
+    hArg.nlRtList = nlRtList;
+    hArg.head     = *nlRtList;
+    if(nlTalk(ctx, &req.h, nlRouteMsgHandler, &hArg) != NL_OK) {
+        _OSBASE_TRACE(2, ("[INFO] - Route lookup failed. %s",
+                          strerror(errno)));
+        *nlRtList = hArg.head;
+        goto dump;
+    }
+    if(*nlRtList != NULL) {
+        goto out;
+    }
+    _OSBASE_TRACE(2, ("[INFO] - Looked up route does not match the filter."));
+
+ dump:
+    // Filtered dump.
+    rc = nlGetRoutes(ctx, nlRtList, nlRtInfo);
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlGetRoute() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlModifyRoute(struct nlContext *ctx, struct nlRouteInfo *nlRtInfo,
+                  int hType, unsigned int hFlags)
+{
+    _OSBASE_TRACE(3, ("--- nlModifyRoute() called"));
+
+    int                  rc = NL_OK;  // Result handler.
+
+    // Buffer to hold the RTNETLINK request.
+    struct {
+        struct nlmsghdr h;         // Netlink message header.
+        struct rtmsg    m;         // Message.
+        char            buf[1024]; // Attributes buffer.
+    } req;
+
+    // Check received parameters.
+    if((ctx == NULL) || (nlRtInfo == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Check hType.
+    if((hType != RTM_NEWROUTE) && (hType != RTM_DELROUTE)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid message type."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Generate filter.
+    if(nlGenRouteFilter(ctx, nlRtInfo) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Problem generating filter."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Fill message.
+    memset(&req, 0, sizeof(req));
+    // Length of message including header.
+    req.h.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    // Type of message content.
+    req.h.nlmsg_type = hType;
+    // Flags.
+    req.h.nlmsg_flags = NLM_F_ACK | NLM_F_REQUEST | hFlags;
+    // Address family of route.
+    req.m.rtm_family = nlRtInfo->family;
+    // Length of source.
+    req.m.rtm_src_len = nlRtInfo->srcLen;
+    // Length of destination.
+    req.m.rtm_dst_len = nlRtInfo->dstLen;
+    // TOS filter.
+    req.m.rtm_tos = nlRtInfo->tos;
+    // Routing table.
+    req.m.rtm_table = nlRtInfo->table;
+    // Route origin.
+    req.m.rtm_protocol = nlRtInfo->protocol;
+    // Distance to the destination.
+    req.m.rtm_scope = nlRtInfo->scope;
+    // Route type.
+    req.m.rtm_type = nlRtInfo->type;
+
+    // Destination address to be reached.
+    if(ctx->rtFlt.dstAddr) {
+        nlAddAttrToMsg(&req.h, sizeof(req), RTA_DST,
+                       ctx->rtFlt.dstAddrBin.data, ctx->rtFlt.dstAddrBin.len);
+    }
+
+    // Source address.
+    if(ctx->rtFlt.srcAddr) {
+        nlAddAttrToMsg(&req.h, sizeof(req), RTA_SRC,
+                       ctx->rtFlt.srcAddrBin.data, ctx->rtFlt.srcAddrBin.len);
+    }
+
+    // Input interface index.
+    if(ctx->rtFlt.inputIf) {
+        nlAddAttrToMsg32(&req.h, sizeof(req), RTA_IIF,
+                         (uint32_t)(nlRtInfo->inputIf));
+    }
+
+    // Output interface index.
+    if(ctx->rtFlt.outputIf) {
+        nlAddAttrToMsg32(&req.h, sizeof(req), RTA_OIF,
+                         (uint32_t)(nlRtInfo->outputIf));
+    }
+
+    // Gateway of the route.
+    if(ctx->rtFlt.gw) {
+        nlAddAttrToMsg(&req.h, sizeof(req), RTA_GATEWAY,
+                       ctx->rtFlt.gwBin.data, ctx->rtFlt.gwBin.len);
+    }
+
+    // Priority of the route.
+    if(ctx->rtFlt.priority) {
+        nlAddAttrToMsg32(&req.h, sizeof(req), RTA_PRIORITY,
+                         (uint32_t)nlRtInfo->priority);
+    }
+
+    // Prefered source.
+    if(ctx->rtFlt.prefSrc) {
+        nlAddAttrToMsg(&req.h, sizeof(req), RTA_PREFSRC,
+                       ctx->rtFlt.prefSrcBin.data, ctx->rtFlt.prefSrcBin.len);
+    }
+
+    // Send request and wait for the ACK.
+    if(nlTalk(ctx, &req.h, NULL, NULL) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Unable to modify route."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlModifyRoute() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to compare an address attribute with a compiled filter address.
+ * @param addr [in] filter address.
+ * @param rAttr [in] received address attribute.
+ * @return 1=match | 0=no match
+ */
+static int nlFilterAddrMatch(const struct nlFilterAddr *addr,
+                             const struct rtattr *rAttr)
+{
+    return ((RTA_PAYLOAD(rAttr) == addr->len) &&
+            (memcmp(RTA_DATA(rAttr), addr->data, addr->len) == 0));
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlRtAttrMatchAddr(struct nlArena *arena,
+                             const struct nlAttrDesc *desc,
+                             const struct rtattr *rAttr,
+                             const void *flt, const void *fltInfo)
+{
+    (void)arena;
+    (void)fltInfo;
+
+    return nlFilterAddrMatch((const struct nlFilterAddr*)
+                             ((const char*)flt + desc->aux), rAttr);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlRtAttrCopyAddr(struct nlArena *arena,
+                            const struct nlAttrDesc *desc,
+                            const struct rtattr *rAttr, void *info)
+{
+    struct nlRoute *route = (struct nlRoute*)info; // Received route.
+    size_t          len   = RTA_PAYLOAD(rAttr);    // Copied length.
+
+    (void)arena;
+
+    if(len > desc->len) {
+        len = desc->len;
+    }
+    memcpy(NL_ATTR_FIELD(info, desc), RTA_DATA(rAttr), len);
+    route->addrs |= (1U << rAttr->rta_type);
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+static int nlRtAttrCopyNone(struct nlArena *arena,
+                            const struct nlAttrDesc *desc,
+                            const struct rtattr *rAttr, void *info)
+{
+    (void)arena;
+    (void)desc;
+    (void)rAttr;
+    (void)info;
+
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Route addresses are compared in network format against the compiled
+ * filter and stored as received.
+ */
+#define NL_ATTR_ADDR(I, F, f) nlRtAttrMatchAddr, nlRtAttrCopyAddr, 0,   \
+                              offsetof(F, f##Bin)
+
+/**
+ * Route attributes: X(kind, type, nlRoute field, description).
+ */
+#define NL_ROUTE_ATTRS(X)                                               \
+    X(ADDR, RTA_DST,      dstAddr,  "Destination address to be reached") \
+    X(U32,  RTA_IIF,      inputIf,  "Input interface index")            \
+    X(U32,  RTA_OIF,      outputIf, "Output interface index")           \
+    X(ADDR, RTA_GATEWAY,  gw,       "Gateway of the route")             \
+    X(U32,  RTA_PRIORITY, priority, "Priority of the route")            \
+    X(U32,  RTA_METRICS,  metrics,  "Route metrics")                    \
+    X(U32,  RTA_TABLE,    table,    "Route table")
+
+#define NL_ROUTE_ATTR(kind, type, f, name)                              \
+    NL_ATTR_DESC(struct nlRoute, struct nlRouteFilter, kind, type, f, name)
+
+/**
+ * Route addresses only compared with the filter (not kept in nlRoute).
+ */
+#define NL_ROUTE_ATTR_FLT(type, f, name)                                \
+    [type] = { nlRtAttrMatchAddr, nlRtAttrCopyNone, 0,                  \
+               offsetof(struct nlRouteFilter, f##Bin), 0, 0,            \
+               offsetof(struct nlRouteFilter, f), name },
+
+static const struct nlAttrDesc nlRouteAttrs[RTA_MAX + 1] = {
+    NL_ROUTE_ATTRS(NL_ROUTE_ATTR)
+    NL_ROUTE_ATTR_FLT(RTA_SRC,     srcAddr, "Source address")
+    NL_ROUTE_ATTR_FLT(RTA_PREFSRC, prefSrc, "Prefered source")
+};
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlAddRouteToList(struct nlContext *ctx, const struct nlmsghdr *rcvH,
+                     struct nlRouteList **nlRtList)
+{
+    _OSBASE_TRACE(3, ("--- nlAddRouteToList() called"));
+
+    struct nlRouteList   *nlRtListCurr = NULL;            // Current routes
+                                                          // list.
+    const struct nlRoute *fltVal       = &ctx->rtFlt.val; // Filter values.
+    struct nlRoute        route;                          // Received route.
+    struct rtmsg         *rMsg         = NULL;            // Message content.
+    struct rtattr        *rAttr        = NULL;            // Message
+                                                          // attributes.
+    int                   rAttrCount   = 0;               // Number of message
+                                                          // attributes.
+    int                   rc           = NL_OK;           // Result handler.
+
+    // Check netlink message header.
+    if(rcvH == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid netlink message."));
         rc = NL_FAIL;
         goto out;
     }
@@ -756,81 +2552,72 @@ int nlAddRouteToList(const struct nlmsghdr *rcvH,
         goto out;
     }
 
-    // Create routes list entry.
-    nlRtInfoListCurr = malloc(sizeof(*nlRtInfoListCurr));
-    if(nlRtInfoListCurr == NULL) {
-        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for "       \
-                          "\'nlRtInfoListCurr\'."));
-        rc = NL_FAIL;
-        goto out;
-    }
-    memset(nlRtInfoListCurr, 0, sizeof(*nlRtInfoListCurr));
+    // The route is parsed on the stack, only the routes that pass the
+    // filter take arena memory.
+    memset(&route, 0, sizeof(route));
 
-    // Alloc first entry.
-    nlRtInfoListCurr->sptr = malloc(sizeof(*(nlRtInfoListCurr->sptr)));
-    if(nlRtInfoListCurr->sptr == NULL) {
-        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for "       \
-                          "\'nlRtInfoListCurr->sptr\'."));
-        rc = NL_FAIL;
+    // Route family. An AF_UNSPEC dump also returns multicast (RTNL_FAMILY_*)
+    // and MPLS routes, only IP routes are handled.
+    if((rMsg->rtm_family != AF_INET) && (rMsg->rtm_family != AF_INET6)) {
+        _OSBASE_TRACE(2, ("[INFO] - Skip route of family %d.",
+                          rMsg->rtm_family));
+        rc = NL_SKIP;
         goto out;
     }
-    memset(nlRtInfoListCurr->sptr, 0, sizeof(*(nlRtInfoListCurr->sptr)));
-
-    // Route family.
-    if((rtFlt.family) && (rMsg->rtm_family != nlRtInfo->family)) {
+    if((ctx->rtFlt.family) && (rMsg->rtm_family != fltVal->family)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Route family\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlRtInfoListCurr->sptr->family = rMsg->rtm_family;
+    route.family = rMsg->rtm_family;
 
     // Route type.
-    if((rtFlt.type) && (rMsg->rtm_type != nlRtInfo->type)) {
+    if((ctx->rtFlt.type) && (rMsg->rtm_type != fltVal->type)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Route type\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlRtInfoListCurr->sptr->type = rMsg->rtm_type;
+    route.type = rMsg->rtm_type;
 
     // Route origin.
-    if((rtFlt.protocol) && (rMsg->rtm_protocol != nlRtInfo->protocol)) {
+    if((ctx->rtFlt.protocol) && (rMsg->rtm_protocol != fltVal->protocol)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Route origin\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlRtInfoListCurr->sptr->protocol = rMsg->rtm_protocol;
+    route.protocol = rMsg->rtm_protocol;
 
     // Distance to the destination.
-    if((rtFlt.scope) && (rMsg->rtm_scope != nlRtInfo->scope)) {
+    if((ctx->rtFlt.scope) && (rMsg->rtm_scope != fltVal->scope)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Distance to the destination\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlRtInfoListCurr->sptr->scope = rMsg->rtm_scope;
+    route.scope = rMsg->rtm_scope;
 
     // Source Route mask prefix.
-    if((rtFlt.srcLen) && (rMsg->rtm_src_len != nlRtInfo->srcLen)) {
+    if((ctx->rtFlt.srcLen) && (rMsg->rtm_src_len != fltVal->srcLen)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Source Route mask prefix\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlRtInfoListCurr->sptr->srcLen = rMsg->rtm_src_len;
+    route.srcLen = rMsg->rtm_src_len;
 
     // Destination Route mask prefix.
-    if((rtFlt.dstLen) && (rMsg->rtm_dst_len != nlRtInfo->dstLen)) {
+    if((ctx->rtFlt.dstLen) && (rMsg->rtm_dst_len != fltVal->dstLen)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Destination Route mask prefix\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlRtInfoListCurr->sptr->dstLen = rMsg->rtm_dst_len;
+    route.dstLen = rMsg->rtm_dst_len;
 
     // Type of service.
-    if((rtFlt.tos) && (rMsg->rtm_tos != nlRtInfo->tos)) {
+    if((ctx->rtFlt.tos) && (rMsg->rtm_tos != fltVal->tos)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Type of service\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlRtInfoListCurr->sptr->tos = rMsg->rtm_tos;
+    route.tos = rMsg->rtm_tos;
 
     // Parse attributes.
     rAttr = (struct rtattr*)RTM_RTA(rMsg);
@@ -840,162 +2627,113 @@ int nlAddRouteToList(const struct nlmsghdr *rcvH,
         goto out;
     }
     rAttrCount = RTM_PAYLOAD(rcvH);
-    for( ; RTA_OK(rAttr, rAttrCount) ; rAttr=RTA_NEXT(rAttr, rAttrCount)) {
-        switch(rAttr->rta_type) {
-        case RTA_DST: // Destination address to be reached.
-            if(inet_ntop(rMsg->rtm_family, RTA_DATA(rAttr),
-                         nlRtInfoListCurr->sptr->dstAddr,
-                         ((rMsg->rtm_family == AF_INET) ? (INET_ADDRSTRLEN) :
-                          (INET6_ADDRSTRLEN))) <= 0) {
-                _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from " \
-                                  "numeric format to presentation format."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            if((rtFlt.dstAddr) && (strcmp(nlRtInfoListCurr->sptr->dstAddr,
-                                          nlRtInfo->dstAddr) != 0)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Destination address to be " \
-                                  "reached\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            break;
-        case RTA_SRC: // Source address.
-            if(inet_ntop(rMsg->rtm_family, RTA_DATA(rAttr),
-                         nlRtInfoListCurr->sptr->srcAddr,
-                         ((rMsg->rtm_family == AF_INET) ? (INET_ADDRSTRLEN) :
-                          (INET6_ADDRSTRLEN))) <= 0) {
-                _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from " \
-                                  "numeric format to presentation format."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            if((rtFlt.srcAddr) && (strcmp(nlRtInfoListCurr->sptr->srcAddr,
-                                          nlRtInfo->srcAddr) != 0)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Source address\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            break;
-        case RTA_IIF: // Input interface index.
-            if((rtFlt.inputIf) &&
-               ((*((int*)RTA_DATA(rAttr))) != nlRtInfo->inputIf)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Input interface index\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlRtInfoListCurr->sptr->inputIf = *((int*)RTA_DATA(rAttr));
-            break;
-        case RTA_OIF: // Output interface index.
-            if((rtFlt.outputIf) &&
-               ((*((int*)RTA_DATA(rAttr))) != nlRtInfo->outputIf)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Output interface index\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlRtInfoListCurr->sptr->outputIf = *((int*)RTA_DATA(rAttr));
-            break;
-        case RTA_GATEWAY: // Gateway of the route.
-            if(inet_ntop(rMsg->rtm_family, RTA_DATA(rAttr),
-                         nlRtInfoListCurr->sptr->gw,
-                         ((rMsg->rtm_family == AF_INET) ? (INET_ADDRSTRLEN) :
-                          (INET6_ADDRSTRLEN))) <= 0) {
-                _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from " \
-                                  "numeric format to presentation format."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            if((rtFlt.gw) && (strcmp(nlRtInfoListCurr->sptr->gw,
-                                     nlRtInfo->gw) != 0)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Gateway of the route\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            break;
-        case RTA_PRIORITY: // Priority of the route.
-            if((rtFlt.priority) &&
-               ((*((int*)RTA_DATA(rAttr))) != nlRtInfo->priority)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Priority of the route\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlRtInfoListCurr->sptr->priority = *((int*)RTA_DATA(rAttr));
-            break;
-        case RTA_PREFSRC: // Prefered source.
-            if(inet_ntop(rMsg->rtm_family, RTA_DATA(rAttr),
-                         nlRtInfoListCurr->sptr->prefSrc,
-                         ((rMsg->rtm_family == AF_INET) ? (INET_ADDRSTRLEN) :
-                          (INET6_ADDRSTRLEN))) <= 0) {
-                _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from " \
-                                  "numeric format to presentation format."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            if((rtFlt.prefSrc) && (strcmp(nlRtInfoListCurr->sptr->prefSrc,
-                                          nlRtInfo->prefSrc) != 0)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Prefered source\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            break;
-        case RTA_METRICS: // Route metrics.
-            if((rtFlt.metrics) &&
-               ((*((int*)RTA_DATA(rAttr))) != nlRtInfo->metrics)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Route metrics\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlRtInfoListCurr->sptr->metrics = *((int*)RTA_DATA(rAttr));
-            break;
-        case RTA_TABLE: // Route table.
-            if((rtFlt.table) &&
-               ((*((int*)RTA_DATA(rAttr))) != nlRtInfo->table)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Route table\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlRtInfoListCurr->sptr->table = *((int*)RTA_DATA(rAttr));
-            break;
-        default:
-            break;
-        }
+    rc = nlDecodeAttrs(ctx, nlRouteAttrs, RTA_MAX + 1, ctx->rtAttrSkip,
+                       rAttr, rAttrCount, &ctx->rtFlt, fltVal, &route);
+    if(rc != NL_OK) {
+        goto out;
+    }
+
+    // Create routes list entry.
+    nlRtListCurr = nlArenaAlloc(ctx->arena, sizeof(*nlRtListCurr));
+    if(nlRtListCurr == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for "       \
+                          "\'nlRtListCurr\'."));
+        rc = NL_FAIL;
+        goto out;
+    }
+    nlRtListCurr->sptr = nlArenaAlloc(ctx->arena,
+                                      sizeof(*(nlRtListCurr->sptr)));
+    if(nlRtListCurr->sptr == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for "       \
+                          "\'nlRtListCurr->sptr\'."));
+        rc = NL_FAIL;
+        goto out;
     }
+    memcpy(nlRtListCurr->sptr, &route, sizeof(route));
 
     // Set next route.
-    nlRtInfoListCurr->next = *nlRtInfoList;
-    *nlRtInfoList = nlRtInfoListCurr;
+    nlRtListCurr->next = *nlRtList;
+    *nlRtList = nlRtListCurr;
 
  out:
-    if(rc != NL_OK) {
-        nlFreeRouteInfoList(nlRtInfoListCurr);
-    }
-
     _OSBASE_TRACE(3, ("--- nlAddRouteToList() exited"));
     return rc;
 }
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
+/**
+ * Used to get the family of an address string.
+ * @param addr [in] address.
+ * @return AF_INET | AF_INET6 | AF_UNSPEC=empty or invalid address
+ */
+static int nlAddrFamily(const char *addr)
+{
+    unsigned char bin[16]; // Address (not used).
+
+    return nlParseAddr(addr, strlen(addr), bin);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to compile a filter address. An address of the other family than
+ * the filter one fixes the filter family.
+ * @param addr [in] address (presentation format).
+ * @param bin [out] compiled address.
+ * @param family [in/out] filter family.
+ * @param name [in] address description.
+ * @return NL_OK=succesful | NL_FAIL=invalid address
+ */
+static int nlGenFilterAddr(const char *addr, struct nlFilterAddr *bin,
+                           int *family, const char *name)
+{
+    int addrFamily = AF_UNSPEC; // Family of the address.
+
+    memset(bin->data, 0, sizeof(bin->data));
+    addrFamily = nlParseAddr(addr, strlen(addr), bin->data);
+    if(addrFamily == AF_UNSPEC) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid %s: %s.", name, addr));
+        return NL_FAIL;
+    }
+    bin->len = (addrFamily == AF_INET6) ? (16) : (4);
+
+    // Fixing wrong route family.
+    *family = addrFamily;
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlGenRouteFilter(struct nlContext *ctx, struct nlRouteInfo *nlRtInfo)
 {
     _OSBASE_TRACE(3, ("--- nlGenRouteFilter() called"));
 
-    char dstAddrLoc[NL_ADDRESS_MAXLEN]; // Destination address tmp container.
-    char srcAddrLoc[NL_ADDRESS_MAXLEN]; // Source address tmp container.
-    char gwLoc[NL_ADDRESS_MAXLEN];      // Gateway address tmp container.
-    char prefSrcLoc[NL_ADDRESS_MAXLEN]; // Preferred source address tmp
-                                        // container.
-    int  newFamily;                     // Used in family address check
-                                        // process.
-    int  rc = NL_OK;                    // Result handler.
+    unsigned int addrLen = 0;     // Filter addresses length.
+    int          rc      = NL_OK; // Result handler.
 
     // Reset filter.
-    nlResetRouteFilter();
+    nlResetRouteFilter(ctx);
+
+    // An "any family" filter (AF_UNSPEC) takes the family of the first
+    // address it holds, if any.
+    if(nlRtInfo->family == AF_UNSPEC) {
+        nlRtInfo->family = nlAddrFamily(nlRtInfo->dstAddr);
+    }
+    if(nlRtInfo->family == AF_UNSPEC) {
+        nlRtInfo->family = nlAddrFamily(nlRtInfo->srcAddr);
+    }
+    if(nlRtInfo->family == AF_UNSPEC) {
+        nlRtInfo->family = nlAddrFamily(nlRtInfo->gw);
+    }
+    if(nlRtInfo->family == AF_UNSPEC) {
+        nlRtInfo->family = nlAddrFamily(nlRtInfo->prefSrc);
+    }
 
     // Address family.
     if((nlRtInfo->family == AF_INET) || (nlRtInfo->family == AF_INET6)) {
-        rtFlt.family = 1;
-    } else {
+        ctx->rtFlt.family = 1;
+    } else if(nlRtInfo->family != AF_UNSPEC) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid family: %d.", nlRtInfo->family));
         rc = NL_FAIL;
         goto out;
@@ -1003,7 +2741,7 @@ int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
 
     // Route type.
     if((nlRtInfo->type > RTN_UNSPEC) && (nlRtInfo->type < __RTN_MAX)) {
-        rtFlt.type = 1;
+        ctx->rtFlt.type = 1;
     } else if(nlRtInfo->type < RTN_UNSPEC) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid type: %d.", nlRtInfo->type));
         rc = NL_FAIL;
@@ -1013,7 +2751,7 @@ int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
     // Route origin.
     if((nlRtInfo->protocol > RTPROT_UNSPEC) &&
        (nlRtInfo->protocol <= RTPROT_NTK)) {
-        rtFlt.protocol = 1;
+        ctx->rtFlt.protocol = 1;
     } else if(nlRtInfo->protocol < RTPROT_UNSPEC) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid protocol: %d.",
                           nlRtInfo->protocol));
@@ -1024,7 +2762,7 @@ int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
     // Distance to the destination.
     if((nlRtInfo->scope > RT_SCOPE_UNIVERSE) &&
        (nlRtInfo->scope <= RT_SCOPE_NOWHERE)) {
-        rtFlt.scope = 1;
+        ctx->rtFlt.scope = 1;
     } else if(nlRtInfo->scope < RT_SCOPE_UNIVERSE) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid scope: %d.", nlRtInfo->scope));
         rc = NL_FAIL;
@@ -1033,7 +2771,7 @@ int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
 
     // Source Route mask prefix.
     if(nlRtInfo->srcLen > 0) {
-        rtFlt.srcLen = 1;
+        ctx->rtFlt.srcLen = 1;
     } else if(nlRtInfo->srcLen < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid srcLen: %d.", nlRtInfo->srcLen));
         rc = NL_FAIL;
@@ -1042,7 +2780,7 @@ int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
 
     // Destination Route mask prefix.
     if(nlRtInfo->dstLen > 0) {
-        rtFlt.dstLen = 1;
+        ctx->rtFlt.dstLen = 1;
     } else if(nlRtInfo->dstLen < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid dstLen: %d.", nlRtInfo->dstLen));
         rc = NL_FAIL;
@@ -1051,7 +2789,7 @@ int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
 
     // Type of service.
     if(nlRtInfo->tos > 0) {
-        rtFlt.tos = 1;
+        ctx->rtFlt.tos = 1;
     } else if(nlRtInfo->tos < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid tos: %d.", nlRtInfo->tos));
         rc = NL_FAIL;
@@ -1060,121 +2798,107 @@ int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
 
     // Destination address to be reached.
     if(strlen(nlRtInfo->dstAddr) > 0) {
-        memset(dstAddrLoc, 0, (NL_ADDRESS_MAXLEN)*sizeof(*dstAddrLoc));
-        if(inet_pton(nlRtInfo->family, nlRtInfo->dstAddr, dstAddrLoc) > 0) {
-            rtFlt.dstAddr = 1;
-        } else {
-            // Trying the other one.
-            newFamily = (nlRtInfo->family==AF_INET)?(AF_INET6):(AF_INET);
-            if(inet_pton(newFamily, nlRtInfo->dstAddr, dstAddrLoc) > 0) {
-                rtFlt.dstAddr = 1;
-
-                // Fixing wrong route family.
-                nlRtInfo->family = newFamily;
-            } else {
-                _OSBASE_TRACE(1, ("[ERROR] - Invalid dstAddr: %s.",
-                                  nlRtInfo->dstAddr));
-                rc = NL_FAIL;
-                goto out;
-            }
+        if(nlGenFilterAddr(nlRtInfo->dstAddr, &ctx->rtFlt.dstAddrBin,
+                           &nlRtInfo->family, "dstAddr") != NL_OK) {
+            rc = NL_FAIL;
+            goto out;
         }
+        ctx->rtFlt.dstAddr = 1;
     }
 
     // Source address.
     if(strlen(nlRtInfo->srcAddr) > 0) {
-        memset(srcAddrLoc, 0, (NL_ADDRESS_MAXLEN)*sizeof(*srcAddrLoc));
-        if(inet_pton(nlRtInfo->family, nlRtInfo->srcAddr, srcAddrLoc) > 0) {
-            rtFlt.srcAddr = 1;
-        } else {
-            // Trying the other one.
-            newFamily = (nlRtInfo->family==AF_INET)?(AF_INET6):(AF_INET);
-            if(inet_pton(newFamily, nlRtInfo->srcAddr, srcAddrLoc) > 0) {
-                rtFlt.srcAddr = 1;
-
-                // Fixing wrong route family.
-                nlRtInfo->family = newFamily;
-            } else {
-                _OSBASE_TRACE(1, ("[ERROR] - Invalid srcAddr: %s.",
-                                  nlRtInfo->srcAddr));
-                rc = NL_FAIL;
-                goto out;
-            }
+        if(nlGenFilterAddr(nlRtInfo->srcAddr, &ctx->rtFlt.srcAddrBin,
+                           &nlRtInfo->family, "srcAddr") != NL_OK) {
+            rc = NL_FAIL;
+            goto out;
         }
+        ctx->rtFlt.srcAddr = 1;
     }
 
     // Input interface index.
     if(nlRtInfo->inputIf >= 0) {
-        rtFlt.inputIf = 1;
+        ctx->rtFlt.inputIf = 1;
     }
 
     // Output interface index.
     if(nlRtInfo->outputIf >= 0) {
-        rtFlt.outputIf = 1;
+        ctx->rtFlt.outputIf = 1;
     }
 
     // Gateway of the route.
     if(strlen(nlRtInfo->gw) > 0) {
-        memset(gwLoc, 0, (NL_ADDRESS_MAXLEN)*sizeof(*gwLoc));
-        if(inet_pton(nlRtInfo->family, nlRtInfo->gw, gwLoc) > 0) {
-            rtFlt.gw = 1;
-        } else {
-            // Trying the other one.
-            newFamily = (nlRtInfo->family==AF_INET)?(AF_INET6):(AF_INET);
-            if(inet_pton(newFamily, nlRtInfo->gw, gwLoc) > 0) {
-                rtFlt.gw = 1;
-
-                // Fixing wrong route family.
-                nlRtInfo->family = newFamily;
-            } else {
-                _OSBASE_TRACE(1, ("[ERROR] - Invalid gw: %s.", nlRtInfo->gw));
-                rc = NL_FAIL;
-                goto out;
-            }
+        if(nlGenFilterAddr(nlRtInfo->gw, &ctx->rtFlt.gwBin,
+                           &nlRtInfo->family, "gw") != NL_OK) {
+            rc = NL_FAIL;
+            goto out;
         }
+        ctx->rtFlt.gw = 1;
     }
 
     // Priority of the route.
     if(nlRtInfo->priority >= 0) {
-        rtFlt.priority = 1;
+        ctx->rtFlt.priority = 1;
     }
 
     // Prefered source.
     if(strlen(nlRtInfo->prefSrc) > 0) {
-        memset(prefSrcLoc, 0, (NL_ADDRESS_MAXLEN)*sizeof(*prefSrcLoc));
-        if(inet_pton(nlRtInfo->family, nlRtInfo->prefSrc, prefSrcLoc) > 0) {
-            rtFlt.prefSrc = NL_FAIL;
-        } else {
-            // Trying the other one.
-            newFamily = (nlRtInfo->family==AF_INET)?(AF_INET6):(AF_INET);
-            if(inet_pton(newFamily, nlRtInfo->prefSrc, prefSrcLoc) > 0) {
-                rtFlt.prefSrc = NL_FAIL;
-
-                // Fixing wrong route family.
-                nlRtInfo->family = newFamily;
-            } else {
-                _OSBASE_TRACE(1, ("[ERROR] - Invalid prefered source: %s.",
-                                  nlRtInfo->prefSrc));
-                rc = NL_FAIL;
-                goto out;
-            }
+        if(nlGenFilterAddr(nlRtInfo->prefSrc, &ctx->rtFlt.prefSrcBin,
+                           &nlRtInfo->family, "prefered source") != NL_OK) {
+            rc = NL_FAIL;
+            goto out;
         }
+        ctx->rtFlt.prefSrc = NL_FAIL;
+    }
+
+    // Compiled address lengths. A route of another family is skipped
+    // before its addresses are compared, so every address of the filter
+    // must be of the (fixed) filter family.
+    addrLen = (nlRtInfo->family == AF_INET6) ? (16) : (4);
+    if((ctx->rtFlt.dstAddr && ctx->rtFlt.dstAddrBin.len != addrLen) ||
+       (ctx->rtFlt.srcAddr && ctx->rtFlt.srcAddrBin.len != addrLen) ||
+       (ctx->rtFlt.gw && ctx->rtFlt.gwBin.len != addrLen) ||
+       (ctx->rtFlt.prefSrc && ctx->rtFlt.prefSrcBin.len != addrLen)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Addresses of different families."));
+        rc = NL_FAIL;
+        goto out;
     }
+    ctx->rtFlt.dstAddrBin.len = addrLen;
+    ctx->rtFlt.srcAddrBin.len = addrLen;
+    ctx->rtFlt.gwBin.len      = addrLen;
+    ctx->rtFlt.prefSrcBin.len = addrLen;
 
     // Route metrics.
     if(nlRtInfo->metrics >= 0) {
-        rtFlt.metrics = 1;
+        ctx->rtFlt.metrics = 1;
     }
 
     // Route table.
     if((nlRtInfo->table > RT_TABLE_UNSPEC) &&
        (nlRtInfo->table <= RT_TABLE_MAX)) {
-        rtFlt.table = 1;
+        ctx->rtFlt.table = 1;
     } else if(nlRtInfo->table < RT_TABLE_UNSPEC) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid table: %d.", nlRtInfo->table));
         rc = NL_FAIL;
         goto out;
     }
 
+    // Values compared with the received routes (only the active ones are
+    // meaningful).
+    memset(&ctx->rtFlt.val, 0, sizeof(ctx->rtFlt.val));
+    ctx->rtFlt.val.family   = nlRtInfo->family;
+    ctx->rtFlt.val.type     = nlRtInfo->type;
+    ctx->rtFlt.val.protocol = nlRtInfo->protocol;
+    ctx->rtFlt.val.scope    = nlRtInfo->scope;
+    ctx->rtFlt.val.srcLen   = nlRtInfo->srcLen;
+    ctx->rtFlt.val.dstLen   = nlRtInfo->dstLen;
+    ctx->rtFlt.val.tos      = nlRtInfo->tos;
+    ctx->rtFlt.val.table    = nlRtInfo->table;
+    ctx->rtFlt.val.inputIf  = nlRtInfo->inputIf;
+    ctx->rtFlt.val.outputIf = nlRtInfo->outputIf;
+    ctx->rtFlt.val.priority = nlRtInfo->priority;
+    ctx->rtFlt.val.metrics  = nlRtInfo->metrics;
+
  out:
     _OSBASE_TRACE(3, ("--- nlGenRouteFilter() exited"));
     return rc;
@@ -1182,26 +2906,26 @@ int nlGenRouteFilter(struct nlRouteInfo *nlRtInfo)
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-void nlResetRouteFilter()
+void nlResetRouteFilter(struct nlContext *ctx)
 {
     _OSBASE_TRACE(3, ("--- nlResetRouteFilter() called"));
 
-    rtFlt.family   = 0;
-    rtFlt.type     = 0;
-    rtFlt.protocol = 0;
-    rtFlt.scope    = 0;
-    rtFlt.srcLen   = 0;
-    rtFlt.dstLen   = 0;
-    rtFlt.tos      = 0;
-    rtFlt.dstAddr  = 0;
-    rtFlt.srcAddr  = 0;
-    rtFlt.inputIf  = 0;
-    rtFlt.outputIf = 0;
-    rtFlt.gw       = 0;
-    rtFlt.priority = 0;
-    rtFlt.prefSrc  = 0;
-    rtFlt.metrics  = 0;
-    rtFlt.table    = 0;
+    ctx->rtFlt.family   = 0;
+    ctx->rtFlt.type     = 0;
+    ctx->rtFlt.protocol = 0;
+    ctx->rtFlt.scope    = 0;
+    ctx->rtFlt.srcLen   = 0;
+    ctx->rtFlt.dstLen   = 0;
+    ctx->rtFlt.tos      = 0;
+    ctx->rtFlt.dstAddr  = 0;
+    ctx->rtFlt.srcAddr  = 0;
+    ctx->rtFlt.inputIf  = 0;
+    ctx->rtFlt.outputIf = 0;
+    ctx->rtFlt.gw       = 0;
+    ctx->rtFlt.priority = 0;
+    ctx->rtFlt.prefSrc  = 0;
+    ctx->rtFlt.metrics  = 0;
+    ctx->rtFlt.table    = 0;
 
     _OSBASE_TRACE(3, ("--- nlResetRouteFilter() exited"));
 }
@@ -1245,31 +2969,22 @@ int nlCreateDefaultRtInfo(struct nlRouteInfo *nlRtInfo)
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlFreeRouteInfoList(struct nlRouteInfoList *nlRtInfoList)
+int nlRtAddr_n2a(const struct nlRoute *route, int type, char *buf, int blen)
 {
-    _OSBASE_TRACE(3, ("--- nlFreeRouteInfoList() called"));
+    const unsigned char *addr = NULL; // Address to convert.
 
-    struct nlRouteInfoList* nlRtInfoListTmp = NULL;  // Temporary list
-                                                     // container.
-    int                    rc               = NL_OK; // Result handler.
-
-    // Check received parameters.
-    if(nlRtInfoList == NULL) {
-        _OSBASE_TRACE(2, ("[INFO] - NULL route info list, nothing to free."));
-        goto out;
+    buf[0] = '\0';
+    if(!NL_RT_HAS_ADDR(route, type)) {
+        return NL_OK;
     }
-
-    // Clean.
-    while(nlRtInfoList != NULL) {
-        FREE_SAFE(nlRtInfoList->sptr);
-        nlRtInfoListTmp = nlRtInfoList;
-        nlRtInfoList = nlRtInfoList->next;
-        FREE_SAFE(nlRtInfoListTmp);
+    addr = (type == RTA_GATEWAY) ? (route->gw) : (route->dstAddr);
+    if(nlFmtAddr(route->family, addr, buf, blen) < 0) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not convert address from " \
+                          "numeric format to presentation format."));
+        buf[0] = '\0';
+        return NL_FAIL;
     }
-
- out:
-    _OSBASE_TRACE(3, ("--- nlFreeRouteInfoList() exited"));
-    return rc;
+    return NL_OK;
 }
 //------------------------------------------------------------------------------
 
@@ -1281,42 +2996,112 @@ int nlFreeRouteInfoList(struct nlRouteInfoList *nlRtInfoList)
 ////////////////////////////////////////////////////////////////////////////////
 
 //------------------------------------------------------------------------------
-int nlGetLinks(struct nlLinkInfoList **nlLinkInfoList,
+/**
+ * Data handed to nlLinkMsgHandler and nlLinkDumpReset by nlGetLinks.
+ */
+struct nlLinkHandlerArg {
+    struct nlContext        *ctx;            /**< Request context. */
+    struct nlLinkInfoList  **nlLinkInfoList; /**< List where links are added. */
+    const struct nlLinkInfo *nlLinkInfo;     /**< Link info used as filter. */
+    struct nlLinkInfoList   *head;           /**< List head before the dump. */
+};
+
+/**
+ * nlTalk callback used to add every received link to a list.
+ * @param rcvH [in] link message header.
+ * @param arg [in] nlLinkHandlerArg.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlLinkMsgHandler(const struct nlmsghdr *rcvH, void *arg)
+{
+    struct nlLinkHandlerArg *hArg = (struct nlLinkHandlerArg*)arg;
+
+    if(rcvH->nlmsg_type != RTM_NEWLINK) {
+        _OSBASE_TRACE(2, ("[INFO] - Skip unexpected message type %d.",
+                          rcvH->nlmsg_type));
+        return NL_OK;
+    }
+
+    if(nlAddLinkToList(hArg->ctx, rcvH, hArg->nlLinkInfoList,
+                       hArg->nlLinkInfo) == NL_FAIL) {
+        return NL_FAIL;
+    }
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * nlTalkDump callback used to drop the links added by an interrupted dump
+ * (they were added at the head of the list). Their memory stays in the
+ * arena until the request is over.
+ * @param arg [in] nlLinkHandlerArg.
+ */
+static void nlLinkDumpReset(void *arg)
+{
+    struct nlLinkHandlerArg *hArg = (struct nlLinkHandlerArg*)arg;
+
+    *(hArg->nlLinkInfoList) = hArg->head;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to add the extended info mask to a link request. VF info is only
+ * sent when RTEXT_FILTER_VF is asked for, so it is never included. When
+ * the context does not want statistics, RTEXT_FILTER_SKIP_STATS drops the
+ * per VF counters (IFLA_STATS/IFLA_STATS64 are always sent by the kernel,
+ * nlAddLinkToList just does not copy them).
+ * @param ctx [in] request context.
+ * @param h [in|out] request message.
+ * @param maxlen [in] request buffer length.
+ * @return NL_OK=succesful | NL_FAIL=fail
+ */
+static int nlAddLinkExtMask(const struct nlContext *ctx, struct nlmsghdr *h,
+                            int maxlen)
+{
+    uint32_t extMask = 0; // Extended info mask.
+
+#ifdef RTEXT_FILTER_SKIP_STATS
+    if(ctx->noStats) {
+        extMask |= RTEXT_FILTER_SKIP_STATS;
+    }
+#endif
+    if(extMask == 0) {
+        return NL_OK;
+    }
+    return nlAddAttrToMsg32(h, maxlen, IFLA_EXT_MASK, extMask);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlGetLinks(struct nlContext *ctx,
+               struct nlLinkInfoList **nlLinkInfoList,
                const struct nlLinkInfo *nlLinkInfo)
 {
     _OSBASE_TRACE(3, ("--- nlGetLinks() called"));
 
-    struct sockaddr_nl nlSockAddrKern;                  // Netlink client in
-                                                        // kernel.
-    struct iovec       iov;                             // Scatter-and-gather
-                                                        // buffer.
-    struct msghdr      msg;                             // Final message
-                                                        // structure.
-    char               rcvBuffer[NL_SOCK_SND_BUFF_LEN]; // Received message
-                                                        // buffer.
-    struct nlmsghdr   *rcvH   = NULL;                   // Received Netlink
-                                                        // message header.
-    struct nlmsgerr   *errmsg = NULL;                   // Netlink errors
-                                                        // container.
-    int                status = 0;                      // Send/Receive message
-                                                        // status.
-    int                rc     = NL_OK;                  // Result handler.
+    struct nlLinkHandlerArg hArg;         // Link handler data.
+    struct rtattr          *nest = NULL;  // IFLA_LINKINFO attribute.
+    const char             *kind = NULL;  // Link kind filter.
+    int                     rc   = NL_OK; // Result handler.
 
     // Buffer to hold the RTNETLINK request.
     struct {
-        struct nlmsghdr  h; // Netlink message header.
-        struct ifinfomsg m; // Message.
+        struct nlmsghdr  h;        // Netlink message header.
+        struct ifinfomsg m;        // Message.
+        char             buf[128]; // Filter attributes.
     } req;
 
     // Check received parameters.
-    if(nlLinkInfo == NULL) {
+    if((ctx == NULL) || (ctx->arena == NULL) || (nlLinkInfo == NULL)) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters (filter)."));
         rc = NL_FAIL;
         goto out;
     }
 
     // Generate link filter.
-    if(nlGenLinkFilter(nlLinkInfo) != NL_OK) {
+    if(nlGenLinkFilter(ctx, nlLinkInfo) != NL_OK) {
         _OSBASE_TRACE(1, ("[ERROR] - Problem generating link filter."));
         rc = NL_FAIL;
         goto out;
@@ -1330,10 +3115,6 @@ int nlGetLinks(struct nlLinkInfoList **nlLinkInfoList,
     req.h.nlmsg_type = RTM_GETLINK;
     // Return the complete table matching criteria passed in message content.
     req.h.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
-    // Sequence number (opaque for netlink core).
-    req.h.nlmsg_seq = time(NULL);
-    // PID of the sending process (opaque for netlink core).
-    req.h.nlmsg_pid = getpid();
     // Always AF_UNSPEC.
     req.m.ifi_family = AF_UNSPEC;
     // Link type - ARPHRD_*.
@@ -1345,117 +3126,147 @@ int nlGetLinks(struct nlLinkInfoList **nlLinkInfoList,
     // Reserved for future use.
     req.m.ifi_change = 0xFFFFFFFF;
 
-    // Setup kernel address. Address where we will send messages.
-    memset(&nlSockAddrKern, 0, sizeof(nlSockAddrKern));
-    nlSockAddrKern.nl_family = AF_NETLINK; // Netlink family.
-    nlSockAddrKern.nl_pid    = 0;          // Destination kernel.
-    nlSockAddrKern.nl_groups = 0;          // Not multicast will be received.
+    // A strictly checked link dump request must have a zeroed header.
+    if(nlCtxGetSocket(ctx) != NL_OK) {
+        rc = NL_FAIL;
+        goto out;
+    }
+    if(ctx->sh->strictChk) {
+        req.m.ifi_type   = 0;
+        req.m.ifi_change = 0;
 
-    // Init iovec structure.
-    iov.iov_base = (void*)&(req.h);
-    iov.iov_len  = req.h.nlmsg_len;
+        // The kernel filters the dump by master device and link kind.
+        if(ctx->linkFlt.master) {
+            nlAddAttrToMsg32(&req.h, sizeof(req), IFLA_MASTER,
+                             (uint32_t)(nlLinkInfo->master));
+        }
+        if(ctx->linkFlt.kind) {
+            kind = nlStrGet(ctx->arena, nlLinkInfo->kind);
+            nest = nlAddNestToMsg(&req.h, sizeof(req), IFLA_LINKINFO);
+            if((nest == NULL) ||
+               (nlAddAttrToMsg(&req.h, sizeof(req), IFLA_INFO_KIND, kind,
+                               strlen(kind)+1) != NL_OK) ||
+               (nlEndNestInMsg(&req.h, nest) != NL_OK)) {
+                _OSBASE_TRACE(1, ("[ERROR] - Could not add link kind " \
+                                  "filter."));
+                rc = NL_FAIL;
+                goto out;
+            }
+        }
+    }
 
-    // Init final message structure.
-    msg.msg_name       = &nlSockAddrKern;        // Socket name.
-    msg.msg_namelen    = sizeof(nlSockAddrKern); // Length of name.
-    msg.msg_iov        = &iov;                   // Data blocks.
-    msg.msg_iovlen     = 1;                      // Number of blocks.
-    msg.msg_control    = NULL;                   // Ancillary data.
-    msg.msg_controllen = 0;                      // Ancillary data buffer len.
-    msg.msg_flags      = 0;                      // Flags on received message.
+    // Extended info wanted in the replies.
+    if(nlAddLinkExtMask(ctx, &req.h, sizeof(req)) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not add extended info mask."));
+        rc = NL_FAIL;
+        goto out;
+    }
 
-    // Send request message to kernel.
-    if(sendmsg(nlSH.fd, &msg, 0) < 0) {
-        _OSBASE_TRACE(1, ("[ERROR] - Cannot talk to rtnetlink. %s",
-                          strerror(errno)));
+    // We need to pass link info to filter links because
+    // NLM_F_MATCH is not implemented yet (in kernel), so we are
+    // receiving all links.
+    hArg.ctx            = ctx;
+    hArg.nlLinkInfoList = nlLinkInfoList;
+    hArg.nlLinkInfo     = nlLinkInfo;
+    hArg.head           = *nlLinkInfoList;
+    if(nlTalkDump(ctx, &req.h, nlLinkMsgHandler, nlLinkDumpReset,
+                  &hArg) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Unable to dump links."));
         rc = NL_FAIL;
         goto out;
     }
 
-    // Receive kernel messages (link).
-    memset(rcvBuffer, 0, NL_SOCK_SND_BUFF_LEN*sizeof(*rcvBuffer));
-    iov.iov_base = rcvBuffer;
-    while(1) {
-        rcvH        = NULL; // Received Netlink message header.
-        iov.iov_len = sizeof(rcvBuffer);
-        status      = recvmsg(nlSH.fd, &msg, 0);
+ out:
+    if(rc != NL_OK) {
+        *nlLinkInfoList = NULL;
+    }
 
-        // Check if received message is correct.
-        if(status < 0) {
-            // EINTR  = Was interrupted by a signal before any data was
-            //          available.
-            // EAGAIN = The socket's file descriptor is marked O_NONBLOCK
-            //          and no data is waiting to be received.
-            if(errno == EINTR || errno == EAGAIN) {
-                continue;
-            }
-            _OSBASE_TRACE(1, ("[ERROR] - Netlink receive error - %s (%d).",
-                              strerror(errno), errno));
-            rc = NL_FAIL;
-            goto out;
-        }
-        if(status == 0) {
-            _OSBASE_TRACE(1, ("[ERROR] - No messages are available to be "
-                              "received. %s", strerror(errno)));
-            rc = NL_FAIL;
-            goto out;
-        }
+    _OSBASE_TRACE(3, ("--- nlGetLinks() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
 
-        // Parse message.
-        rcvH = (struct nlmsghdr*)rcvBuffer;
-        while(NLMSG_OK(rcvH, status)) {
-            // Check pid and seq.
-            if((nlSockAddrKern.nl_pid != 0) ||
-               (rcvH->nlmsg_pid != nlSH.local.nl_pid) ||
-               (rcvH->nlmsg_seq != req.h.nlmsg_seq)) {
-                rcvH = NLMSG_NEXT(rcvH, status);
-                continue;
-            }
+//------------------------------------------------------------------------------
+int nlGetLink(struct nlContext *ctx,
+              struct nlLinkInfoList **nlLinkInfoList,
+              const struct nlLinkInfo *nlLinkInfo)
+{
+    _OSBASE_TRACE(3, ("--- nlGetLink() called"));
 
-            // If done, exit.
-            if(rcvH->nlmsg_type == NLMSG_DONE) {
-                goto out;
-            }
+    struct nlLinkHandlerArg hArg;          // Link handler data.
+    const char             *ifname = NULL;  // Link name.
+    int                     rc     = NL_OK; // Result handler.
 
-            // Error received.
-            if(rcvH->nlmsg_type == NLMSG_ERROR) {
-                errmsg = (struct nlmsgerr*)NLMSG_DATA(rcvH);
-                if(rcvH->nlmsg_len < NLMSG_LENGTH(sizeof(*errmsg))) {
-                    _OSBASE_TRACE(1, ("[ERROR] - Truncated."));
-                } else {
-                    _OSBASE_TRACE(1, ("[ERROR] - RTNETLINK answers."));
-                }
-                rc = NL_FAIL;
-                goto out;
-            }
+    // Buffer to hold the RTNETLINK request.
+    struct {
+        struct nlmsghdr  h;       // Netlink message header.
+        struct ifinfomsg m;       // Message.
+        char             buf[64]; // Link name.
+    } req;
 
-            // We need to pass link info to filter links because
-            // NLM_F_MATCH is not implemented yet (in kernel), so we are
-            // receiving all links.
-            if(nlAddLinkToList(rcvH, nlLinkInfoList, nlLinkInfo) == NL_FAIL) {
-                rc = NL_FAIL;
-                goto out;
-            }
+    // Check received parameters.
+    if((ctx == NULL) || (ctx->arena == NULL) || (nlLinkInfo == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters (filter)."));
+        rc = NL_FAIL;
+        goto out;
+    }
 
-            // Next link.
-            rcvH = NLMSG_NEXT(rcvH, status);
-        }
+    // Nothing identifies a single link.
+    if((nlLinkInfo->index <= 0) && (nlLinkInfo->ifname == NL_STR_EMPTY)) {
+        rc = nlGetLinks(ctx, nlLinkInfoList, nlLinkInfo);
+        goto out;
+    }
+
+    // Generate link filter.
+    if(nlGenLinkFilter(ctx, nlLinkInfo) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Problem generating link filter."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Fill request message. The kernel looks the link up by index, or by
+    // name when no index is given.
+    memset(&req, 0, sizeof(req));
+    req.h.nlmsg_len   = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    req.h.nlmsg_type  = RTM_GETLINK;
+    req.h.nlmsg_flags = NLM_F_REQUEST;
+    req.m.ifi_family  = AF_UNSPEC;
+    ifname = nlStrGet(ctx->arena, nlLinkInfo->ifname);
+    if(nlLinkInfo->index > 0) {
+        req.m.ifi_index = nlLinkInfo->index;
+    } else if(nlAddAttrToMsg(&req.h, sizeof(req), IFLA_IFNAME, ifname,
+                             strlen(ifname)+1) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not add link name."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // Extended info wanted in the reply.
+    if(nlAddLinkExtMask(ctx, &req.h, sizeof(req)) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not add extended info mask."));
+        rc = NL_FAIL;
+        goto out;
+    }
 
-        // MSG_TRUNC = Normal data truncated.
-        if(msg.msg_flags & MSG_TRUNC) {
-            _OSBASE_TRACE(2, ("[INFO] - Message truncated."));
-            continue;
-        }
-        if(status) {
-            _OSBASE_TRACE(1, ("[ERROR] - Remnant of size %d.", status));
-            rc = NL_FAIL;
+    // The reply goes through the filter like a dumped link.
+    hArg.ctx            = ctx;
+    hArg.nlLinkInfoList = nlLinkInfoList;
+    hArg.nlLinkInfo     = nlLinkInfo;
+    hArg.head           = *nlLinkInfoList;
+    if(nlTalk(ctx, &req.h, nlLinkMsgHandler, &hArg) != NL_OK) {
+        if(errno == ENODEV) {
+            _OSBASE_TRACE(2, ("[INFO] - Link does not exist."));
             goto out;
         }
+        _OSBASE_TRACE(1, ("[ERROR] - Unable to get link. %s",
+                          strerror(errno)));
+        rc = NL_FAIL;
+        goto out;
     }
 
  out:
     if(rc != NL_OK) {
-        nlFreeLinkInfoList(*nlLinkInfoList);
+        *nlLinkInfoList = NULL;
     }
 
     _OSBASE_TRACE(3, ("--- nlGetLink() exited"));
@@ -1464,28 +3275,15 @@ int nlGetLinks(struct nlLinkInfoList **nlLinkInfoList,
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlModifyLink(const struct nlLinkInfo *nlLinkInfo, int hType,
+int nlModifyLink(struct nlContext *ctx,
+                 const struct nlLinkInfo *nlLinkInfo, int hType,
                  unsigned int hFlags)
 {
     _OSBASE_TRACE(3, ("--- nlModifyLink() called"));
 
-    struct sockaddr_nl nlSockAddrKern;                  // Netlink client in
-                                                        // kernel.
-    struct iovec       iov;                             // Scatter-and-gather
-                                                        // buffer.
-    struct msghdr      msg;                             // Final message
-                                                        // structure.
-    char               rcvBuffer[NL_SOCK_SND_BUFF_LEN]; // Received message
-                                                        // buffer.
-    struct nlmsghdr   *rcvH   = NULL;                   // Received Netlink
-                                                        // message header.
-    struct nlmsgerr   *errmsg = NULL;                   // Netlink errors
-                                                        // container.
-    uint8_t            attrBytelen;                     // Attribute byte
-                                                        // length.
-    int                status = 0;                      // Send/Receive message
-                                                        // status.
-    int                rc     = NL_OK;                  // Result handler.
+    const char          *ifname = NULL;  // Link name.
+    uint8_t              attrBytelen;    // Attribute byte length.
+    int                  rc     = NL_OK; // Result handler.
 
     // Buffer to hold the RTNETLINK request.
     struct {
@@ -1495,7 +3293,7 @@ int nlModifyLink(const struct nlLinkInfo *nlLinkInfo, int hType,
     } req;
 
     // Check received parameters.
-    if(nlLinkInfo == NULL) {
+    if((ctx == NULL) || (nlLinkInfo == NULL)) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
         rc = NL_FAIL;
         goto out;
@@ -1509,7 +3307,7 @@ int nlModifyLink(const struct nlLinkInfo *nlLinkInfo, int hType,
     }
 
     // Generate Link filter.
-    if(nlGenLinkFilter(nlLinkInfo) != NL_OK) {
+    if(nlGenLinkFilter(ctx, nlLinkInfo) != NL_OK) {
         _OSBASE_TRACE(1, ("[ERROR] - Problem generating filter."));
         rc = NL_FAIL;
         goto out;
@@ -1523,10 +3321,6 @@ int nlModifyLink(const struct nlLinkInfo *nlLinkInfo, int hType,
     req.h.nlmsg_type = hType;
     // Flags.
     req.h.nlmsg_flags = NLM_F_ACK | NLM_F_REQUEST | hFlags;
-    // Sequence number (opaque for netlink core).
-    req.h.nlmsg_seq = time(NULL);
-    // PID of the sending process (opaque for netlink core).
-    req.h.nlmsg_pid = getpid();
     // Always AF_UNSPEC.
     req.m.ifi_family = nlLinkInfo->family;
     // Link type - ARPHRD_*.
@@ -1539,8 +3333,9 @@ int nlModifyLink(const struct nlLinkInfo *nlLinkInfo, int hType,
     req.m.ifi_change = nlLinkInfo->change;
 
     // IFLA_IFNAME.
-    if(linkFlt.ifname) {
-        attrBytelen = strlen(nlLinkInfo->ifname) + 1;
+    if(ctx->linkFlt.ifname) {
+        ifname      = nlStrGet(ctx->arena, nlLinkInfo->ifname);
+        attrBytelen = strlen(ifname) + 1;
         if(attrBytelen == 1) {
             _OSBASE_TRACE(1, ("[ERROR] - Not a valid device identifier."));
             rc = NL_FAIL;
@@ -1552,159 +3347,121 @@ int nlModifyLink(const struct nlLinkInfo *nlLinkInfo, int hType,
             goto out;
         }
         nlAddAttrToMsg(&req.h, sizeof(req), IFLA_IFNAME,
-                       nlLinkInfo->ifname, attrBytelen);
+                       ifname, attrBytelen);
     }
 
     // IFLA_OPERSTATE.
-    if(linkFlt.operstate) {
+    if(ctx->linkFlt.operstate) {
         nlAddAttrToMsg32(&req.h, sizeof(req), IFLA_OPERSTATE,
                          (uint32_t)(nlLinkInfo->operstate));
     }
 
-    // Setup kernel address. Address where we will send messages.
-    memset(&nlSockAddrKern, 0, sizeof(nlSockAddrKern));
-    nlSockAddrKern.nl_family = AF_NETLINK; // Netlink family.
-    nlSockAddrKern.nl_pid    = 0;          // Destination kernel.
-    nlSockAddrKern.nl_groups = 0;          // Not multicast will be received.
-
-    // Init iovec structure.
-    iov.iov_base = (void*)&(req.h);
-    iov.iov_len  = req.h.nlmsg_len;
-
-    // Init final message structure.
-    msg.msg_name       = &nlSockAddrKern;        // Socket name.
-    msg.msg_namelen    = sizeof(nlSockAddrKern); // Length of name.
-    msg.msg_iov        = &iov;                   // Data blocks.
-    msg.msg_iovlen     = 1;                      // Number of blocks.
-    msg.msg_control    = NULL;                   // Ancillary data.
-    msg.msg_controllen = 0;                      // Ancillary data buffer len.
-    msg.msg_flags      = 0;                      // Flags on received message.
-
-    // Send request message to kernel.
-    if(sendmsg(nlSH.fd, &msg, 0) < 0) {
-        _OSBASE_TRACE(1, ("[ERROR] - Cannot talk to rtnetlink. %s",
-                          strerror(errno)));
+    // Send request and wait for the ACK.
+    if(nlTalk(ctx, &req.h, NULL, NULL) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Unable to modify link."));
         rc = NL_FAIL;
         goto out;
     }
 
-    // Receive kernel messages.
-    memset(rcvBuffer, 0, NL_SOCK_SND_BUFF_LEN*sizeof(*rcvBuffer));
-    iov.iov_base = rcvBuffer;
-    while(1) {
-        rcvH = NULL; // Received Netlink message header.
-        iov.iov_len = sizeof(rcvBuffer);
-        status = recvmsg(nlSH.fd, &msg, 0);
+ out:
+    _OSBASE_TRACE(3, ("--- nlModifyLink() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
 
-        // Check if received message is correct.
-        if(status < 0) {
-            // EINTR  = Was interrupted by a signal before any data was
-            //          available.
-            // EAGAIN = The socket's file descriptor is marked O_NONBLOCK
-            //          and no data is waiting to be received.
-            if(errno == EINTR || errno == EAGAIN) {
-                continue;
-            }
-            _OSBASE_TRACE(1, ("[ERROR] - Netlink receive error - %s (%d).",
-                              strerror(errno), errno));
-            rc = NL_FAIL;
-            goto out;
-        }
-        if(status == 0) {
-            _OSBASE_TRACE(1, ("[ERROR] - No messages are available to be "
-                              "received. %s", strerror(errno)));
-            rc = NL_FAIL;
-            goto out;
-        }
+//------------------------------------------------------------------------------
+/**
+ * Used to get the link kind out of an IFLA_LINKINFO attribute.
+ * @param arena [in] arena where the kind is interned.
+ * @param linkInfo [in] IFLA_LINKINFO attribute.
+ * @return link kind (NL_STR_EMPTY if not present) | NL_STR_INVALID=fail
+ */
+static nlStrId nlParseLinkKind(struct nlArena *arena,
+                               const struct rtattr *linkInfo)
+{
+    const struct rtattr *rAttr      = NULL; // Nested attributes.
+    int                  rAttrCount = 0;    // Nested attributes length.
 
-        // Check sender address.
-        if(msg.msg_namelen != sizeof(nlSockAddrKern)) {
-            _OSBASE_TRACE(1, ("[ERROR] - Wrong sender address length == %d.",
-                              msg.msg_namelen));
-            rc = NL_FAIL;
-            goto out;
+    rAttr      = (const struct rtattr*)RTA_DATA(linkInfo);
+    rAttrCount = RTA_PAYLOAD(linkInfo);
+    for( ; RTA_OK(rAttr, rAttrCount) ; rAttr=RTA_NEXT(rAttr, rAttrCount)) {
+        if(rAttr->rta_type == IFLA_INFO_KIND) {
+            return nlStrIntern(arena, (const char*)RTA_DATA(rAttr),
+                               RTA_PAYLOAD(rAttr));
         }
+    }
+    return NL_STR_EMPTY;
+}
+//------------------------------------------------------------------------------
 
-        // Parse receive message.
-        for(rcvH=(struct nlmsghdr*)rcvBuffer ; status>=sizeof(*rcvH) ; ) {
-            int len = rcvH->nlmsg_len;
-            int l = len - sizeof(*rcvH);
-
-            // Check message length.
-            if((l<0) || (len>status)) {
-                // MSG_TRUNC = Normal data truncated.
-                if(msg.msg_flags & MSG_TRUNC) {
-                    _OSBASE_TRACE(1, ("[ERROR] - Truncated message."));
-                    rc = NL_FAIL;
-                    goto out;
-                }
-                _OSBASE_TRACE(1, ("[ERROR] - Malformed message: len=%d.", len));
-                rc = NL_FAIL;
-                goto out;
-            }
-
-            // Check pid and seq.
-            if((nlSockAddrKern.nl_pid != 0) ||
-               (rcvH->nlmsg_pid != req.h.nlmsg_pid) ||
-               (rcvH->nlmsg_seq != req.h.nlmsg_seq)) {
-                // Don't forget to skip that message.
-                status -= NLMSG_ALIGN(len);
-                rcvH = (struct nlmsghdr*)((char*)rcvH + NLMSG_ALIGN(len));
-                continue;
-            }
+//------------------------------------------------------------------------------
+static int nlLinkAttrCopyKind(struct nlArena *arena,
+                              const struct nlAttrDesc *desc,
+                              const struct rtattr *rAttr, void *info)
+{
+    nlStrId id = nlParseLinkKind(arena, rAttr); // Link kind.
 
-            // Error / ACK received.
-            if(rcvH->nlmsg_type == NLMSG_ERROR) {
-                errmsg = (struct nlmsgerr*)NLMSG_DATA(rcvH);
-                if(l < sizeof(struct nlmsgerr)) {
-                    _OSBASE_TRACE(1, ("[ERROR] - Truncated message."));
-                    rc = NL_FAIL;
-                    goto out;
-                } else { // ACK
-                    errno = -errmsg->error;
-                    goto out;
-                }
-            }
+    if(id == NL_STR_INVALID) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not intern \'%s\'.", desc->name));
+        return NL_SKIP;
+    }
+    *((nlStrId*)NL_ATTR_FIELD(info, desc)) = id;
+    return NL_OK;
+}
+//------------------------------------------------------------------------------
 
-            _OSBASE_TRACE(1, ("[ERROR] - Unexpected reply!!!"));
-            status -= NLMSG_ALIGN(len);
-            rcvH = (struct nlmsghdr*)((char*)rcvH + NLMSG_ALIGN(len));
-        }
+//------------------------------------------------------------------------------
+#define NL_ATTR_KIND(I, F, f) NULL, nlLinkAttrCopyKind, 0, 0
 
-        // MSG_TRUNC = Normal data truncated.
-        if(msg.msg_flags & MSG_TRUNC) {
-            _OSBASE_TRACE(2, ("[INFO] - Message truncated."));
-            continue;
-        }
-        if(status) {
-            _OSBASE_TRACE(1, ("[ERROR] - Remnant of size %d.", status));
-            rc = NL_FAIL;
-            goto out;
-        }
-    }
+#ifdef IFLA_IFALIAS
+#define NL_LINK_ATTRS_IFALIAS(X)                                        \
+    X(STR_ID,   IFLA_IFALIAS,   ifalias,   "Interface alias")
+#else
+#define NL_LINK_ATTRS_IFALIAS(X)
+#endif //IFLA_IFALIAS
 
- out:
-    _OSBASE_TRACE(3, ("--- nlModifyLink() exited"));
-    return rc;
-}
+/**
+ * Link attributes: X(kind, type, nlLinkInfo field, description). Master
+ * and kind are missing on links without them, nlAddLinkToList checks them
+ * once every attribute has been seen.
+ */
+#define NL_LINK_ATTRS(X)                                                \
+    X(BIN,      IFLA_ADDRESS,   address,   "Interface L2 address")      \
+    X(BIN,      IFLA_BROADCAST, broadcast, "L2 broadcast address")      \
+    X(STR_ID,   IFLA_IFNAME,    ifname,    "Device name")               \
+    X(U32,      IFLA_MTU,       mtu,       "MTU of the device")         \
+    X(U32,      IFLA_LINK,      link,      "Link type")                 \
+    X(STR_ID,   IFLA_QDISC,     qdisc,     "Queueing discipline")       \
+    X(STATS,    IFLA_STATS,     stats,     "Interface statistics")      \
+    X(U32_COPY, IFLA_MASTER,    master,    "Master device")             \
+    X(U32,      IFLA_TXQLEN,    txqlen,    "Tx queue length")           \
+    X(MEM,      IFLA_MAP,       map,       "Device mapping structure")  \
+    X(U8,       IFLA_OPERSTATE, operstate, "Operational state")         \
+    X(U8,       IFLA_LINKMODE,  linkmode,  "Link mode")                 \
+    X(KIND,     IFLA_LINKINFO,  kind,      "Link kind")                 \
+    NL_LINK_ATTRS_IFALIAS(X)
+
+#define NL_LINK_ATTR(kind, type, f, name)                               \
+    NL_ATTR_DESC(struct nlLinkInfo, struct nlLinkFilter, kind, type, f, name)
+
+static const struct nlAttrDesc nlLinkAttrs[IFLA_MAX + 1] = {
+    NL_LINK_ATTRS(NL_LINK_ATTR)
+};
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlAddLinkToList(const struct nlmsghdr *rcvH,
+int nlAddLinkToList(struct nlContext *ctx, const struct nlmsghdr *rcvH,
                     struct nlLinkInfoList **nlLinkInfoList,
                     const struct nlLinkInfo *nlLinkInfo)
 {
     _OSBASE_TRACE(3, ("--- nlAddLinkToList() called"));
 
     struct nlLinkInfoList *nlLinkInfoListCurr = NULL;  // Current list position.
+    struct nlLinkInfo      linkInfo;                   // Received link.
     struct ifinfomsg      *rMsg               = NULL;  // Message content.
     struct rtattr         *rAttr              = NULL;  // Message attributes.
     int                    rAttrCount         = 0;     // Number of message
                                                        // attributes.
-    char                   convAddrNew[32];            // Converted address
-                                                       // (new).
-    char                   convAddrOld[32];            // Converted address
-                                                       // (old).
     int                    rc                 = NL_OK; // Result handler.
 
     // Check netlink message header.
@@ -1729,66 +3486,50 @@ int nlAddLinkToList(const struct nlmsghdr *rcvH,
         goto out;
     }
 
-    // Create link list entry.
-    nlLinkInfoListCurr = malloc(sizeof(*nlLinkInfoListCurr));
-    if(nlLinkInfoListCurr == NULL) {
-        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for "       \
-                          "\'nlLinkInfoListCurr\'."));
-        rc = NL_FAIL;
-        goto out;
-    }
-    memset(nlLinkInfoListCurr, 0, sizeof(*nlLinkInfoListCurr));
-
-    // Alloc first entry.
-    nlLinkInfoListCurr->sptr = malloc(sizeof(*(nlLinkInfoListCurr->sptr)));
-    if(nlLinkInfoListCurr->sptr == NULL) {
-        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for "       \
-                          "\'nlLinkInfoListCurr->sptr\'."));
-        rc = NL_FAIL;
-        goto out;
-    }
-    memset(nlLinkInfoListCurr->sptr, 0, sizeof(*(nlLinkInfoListCurr->sptr)));
+    // The link is parsed on the stack, only the links that pass the
+    // filter take arena memory.
+    memset(&linkInfo, 0, sizeof(linkInfo));
 
     // Link family (should be AF_UNSPEC).
-    if((linkFlt.family) && (rMsg->ifi_family != nlLinkInfo->family)) {
+    if((ctx->linkFlt.family) && (rMsg->ifi_family != nlLinkInfo->family)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Link family\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlLinkInfoListCurr->sptr->family = rMsg->ifi_family;
+    linkInfo.family = rMsg->ifi_family;
 
     // Link type (ARPHRD_*).
-    if((linkFlt.type) && (rMsg->ifi_type != nlLinkInfo->type)) {
+    if((ctx->linkFlt.type) && (rMsg->ifi_type != nlLinkInfo->type)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Link type\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlLinkInfoListCurr->sptr->type = rMsg->ifi_type;
+    linkInfo.type = rMsg->ifi_type;
 
     // Link index.
-    if((linkFlt.index) && (rMsg->ifi_index != nlLinkInfo->index)) {
+    if((ctx->linkFlt.index) && (rMsg->ifi_index != nlLinkInfo->index)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Link index\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlLinkInfoListCurr->sptr->index = rMsg->ifi_index;
+    linkInfo.index = rMsg->ifi_index;
 
     // Link flags (see netdevice(7)).
     // Here we check all flags.
-    if((linkFlt.flags) && (rMsg->ifi_flags != nlLinkInfo->flags)) {
+    if((ctx->linkFlt.flags) && (rMsg->ifi_flags != nlLinkInfo->flags)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Link flags\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlLinkInfoListCurr->sptr->flags = rMsg->ifi_flags;
+    linkInfo.flags = rMsg->ifi_flags;
 
     // Link change (should be 0xFFFFFFFF).
-    if((linkFlt.change) && (rMsg->ifi_change != nlLinkInfo->change)) {
+    if((ctx->linkFlt.change) && (rMsg->ifi_change != nlLinkInfo->change)) {
         _OSBASE_TRACE(2, ("[INFO] - Skip \'Link change\'."));
         rc = NL_SKIP;
         goto out;
     }
-    nlLinkInfoListCurr->sptr->change = rMsg->ifi_change;
+    linkInfo.change = rMsg->ifi_change;
 
     // Parse attributes.
     rAttr = (struct rtattr*)IFLA_RTA(rMsg);
@@ -1798,187 +3539,66 @@ int nlAddLinkToList(const struct nlmsghdr *rcvH,
         goto out;
     }
     rAttrCount = IFLA_PAYLOAD(rcvH);
-    for( ; RTA_OK(rAttr, rAttrCount) ; rAttr=RTA_NEXT(rAttr, rAttrCount)) {
-        switch(rAttr->rta_type) {
-        case IFLA_ADDRESS: // Interface L2 address.
-            nlLinkInfoListCurr->sptr->addressLen = RTA_PAYLOAD(rAttr);
-            memcpy(nlLinkInfoListCurr->sptr->address, RTA_DATA(rAttr),
-                   nlLinkInfoListCurr->sptr->addressLen);
-            if(linkFlt.address) {
-                nlAddr_n2a(nlLinkInfoListCurr->sptr->address,
-                           nlLinkInfoListCurr->sptr->addressLen,
-                           nlLinkInfoListCurr->sptr->type,
-                           convAddrNew, 32);
-                nlAddr_n2a(nlLinkInfo->address, nlLinkInfo->addressLen,
-                           nlLinkInfo->type, convAddrOld, 32);
-                // Compare if received address is the same established in the
-                // filter.
-                if(strcmp(convAddrNew, convAddrOld) != 0) {
-                    _OSBASE_TRACE(2,
-                                  ("[INFO] - Skip \'Interface L2 address\'."));
-                    rc = NL_SKIP;
-                    goto out;
-                }
-            }
-            break;
-        case IFLA_BROADCAST: // L2 broadcast address.
-            nlLinkInfoListCurr->sptr->broadcastLen = RTA_PAYLOAD(rAttr);
-            memcpy(nlLinkInfoListCurr->sptr->broadcast, RTA_DATA(rAttr),
-                   nlLinkInfoListCurr->sptr->broadcastLen);
-            if(linkFlt.broadcast) {
-                nlAddr_n2a(nlLinkInfoListCurr->sptr->broadcast,
-                           nlLinkInfoListCurr->sptr->broadcastLen,
-                           nlLinkInfoListCurr->sptr->type,
-                           convAddrNew, 32);
-                nlAddr_n2a(nlLinkInfo->broadcast, nlLinkInfo->broadcastLen,
-                           nlLinkInfo->type, convAddrOld, 32);
-                // Compare if received address is the same established in the
-                // filter.
-                if(strcmp(convAddrNew, convAddrOld) != 0) {
-                    _OSBASE_TRACE(2,
-                                  ("[INFO] - Skip \'L2 broadcast address\'."));
-                    rc = NL_SKIP;
-                    goto out;
-                }
-            }
-            break;
-        case IFLA_IFNAME: // Device name.
-            if((linkFlt.ifname) && (strcmp((char*)RTA_DATA(rAttr),
-                                           nlLinkInfo->ifname) != 0)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Device name\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            snprintf(nlLinkInfoListCurr->sptr->ifname, IFNAMSIZ, "%s",
-                     (char*)RTA_DATA(rAttr));
-            break;
-        case IFLA_MTU: // MTU of the device.
-            if((linkFlt.mtu) && ((*((unsigned int*)RTA_DATA(rAttr))) !=
-                                 nlLinkInfo->mtu)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'MTU of the device\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlLinkInfoListCurr->sptr->mtu = *((unsigned int*)RTA_DATA(rAttr));
-            break;
-        case IFLA_LINK: // Link type.
-            if((linkFlt.link) && ((*((int*)RTA_DATA(rAttr))) !=
-                                  nlLinkInfo->link)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Link type\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlLinkInfoListCurr->sptr->link = *((int*)RTA_DATA(rAttr));
-            break;
-        case IFLA_QDISC: // Queueing discipline.
-            if((linkFlt.qdisc) && (strcmp((char*)RTA_DATA(rAttr),
-                                          nlLinkInfo->qdisc) != 0)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Queueing discipline\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            snprintf(nlLinkInfoListCurr->sptr->qdisc, 64, "%s",
-                     (char*)RTA_DATA(rAttr));
-            break;
-        case IFLA_STATS: // Interface statistics
-            nlLinkInfoListCurr->sptr->stats =
-                *((struct net_device_stats*)RTA_DATA(rAttr));
-            break;
-        case IFLA_COST:
-            // @todo implement.
-            break;
-        case IFLA_PRIORITY:
-            // @todo implement.
-            break;
-        case IFLA_MASTER:
-            // @todo implement.
-            break;
-        case IFLA_WIRELESS:
-            // @todo implement.
-            break;
-        case IFLA_PROTINFO:
-            // @todo implement.
-            break;
-        case IFLA_TXQLEN: // Tx queue length.
-            if((linkFlt.txqlen) && ((*((int*)RTA_DATA(rAttr))) !=
-                                    nlLinkInfo->txqlen)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Tx queue length\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlLinkInfoListCurr->sptr->txqlen = *((int*)RTA_DATA(rAttr));
-            break;
-        case IFLA_MAP: // Device mapping structure.
-            nlLinkInfoListCurr->sptr->map = *((struct ifmap*)RTA_DATA(rAttr));
-            break;
-        case IFLA_WEIGHT:
-            // @todo implement.
-            break;
-        case IFLA_OPERSTATE: // Operational state.
-            if((linkFlt.operstate) && ((*((unsigned char*)RTA_DATA(rAttr))) !=
-                                       nlLinkInfo->operstate)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Operational state\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlLinkInfoListCurr->sptr->operstate =
-                *((unsigned char*)RTA_DATA(rAttr));
-            break;
-        case IFLA_LINKMODE: // Link mode.
-            if((linkFlt.linkmode) && ((*((unsigned char*)RTA_DATA(rAttr))) !=
-                                      nlLinkInfo->linkmode)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Link mode\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            nlLinkInfoListCurr->sptr->linkmode =
-                *((unsigned char*)RTA_DATA(rAttr));
-            break;
-        case IFLA_LINKINFO:
-            break;
-        case IFLA_NET_NS_PID:
-            // @todo implement.
-            break;
-#ifdef IFLA_IFALIAS
-        case IFLA_IFALIAS: // Interface alias.
-            if((linkFlt.ifalias) && (strcmp((char*)RTA_DATA(rAttr),
-                                            nlLinkInfo->ifalias) != 0)) {
-                _OSBASE_TRACE(2, ("[INFO] - Skip \'Interface alias\'."));
-                rc = NL_SKIP;
-                goto out;
-            }
-            snprintf(nlLinkInfoListCurr->sptr->ifalias, IFALIASZ, "%s",
-                     (char*)RTA_DATA(rAttr));
-            break;
-#endif //IFLA_IFALIAS
-        default:
-            break;
-        }
+    rc = nlDecodeAttrs(ctx, nlLinkAttrs, IFLA_MAX + 1, ctx->linkAttrSkip,
+                       rAttr, rAttrCount, &ctx->linkFlt, nlLinkInfo,
+                       &linkInfo);
+    if(rc != NL_OK) {
+        goto out;
+    }
+
+    // Master and kind attributes are missing on links without them, so they
+    // are checked once every attribute has been seen.
+    if((ctx->linkFlt.master) &&
+       (linkInfo.master != nlLinkInfo->master)) {
+        _OSBASE_TRACE(2, ("[INFO] - Skip \'Master device\'."));
+        rc = NL_SKIP;
+        goto out;
+    }
+    if((ctx->linkFlt.kind) && (linkInfo.kind != nlLinkInfo->kind)) {
+        _OSBASE_TRACE(2, ("[INFO] - Skip \'Link kind\'."));
+        rc = NL_SKIP;
+        goto out;
+    }
+
+    // Create link list entry.
+    nlLinkInfoListCurr = nlArenaAlloc(ctx->arena,
+                                      sizeof(*nlLinkInfoListCurr));
+    if(nlLinkInfoListCurr == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for "       \
+                          "\'nlLinkInfoListCurr\'."));
+        rc = NL_FAIL;
+        goto out;
+    }
+    nlLinkInfoListCurr->sptr =
+        nlArenaAlloc(ctx->arena, sizeof(*(nlLinkInfoListCurr->sptr)));
+    if(nlLinkInfoListCurr->sptr == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for "       \
+                          "\'nlLinkInfoListCurr->sptr\'."));
+        rc = NL_FAIL;
+        goto out;
     }
+    memcpy(nlLinkInfoListCurr->sptr, &linkInfo, sizeof(linkInfo));
 
     // Add link to list.
     nlLinkInfoListCurr->next = *nlLinkInfoList;
     *nlLinkInfoList = nlLinkInfoListCurr;
 
  out:
-    if(rc != NL_OK) {
-        nlFreeLinkInfoList(nlLinkInfoListCurr);
-    }
-
     _OSBASE_TRACE(3, ("--- nlAddLinkToList() exited"));
     return rc;
 }
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
+int nlGenLinkFilter(struct nlContext *ctx,
+                    const struct nlLinkInfo *nlLinkInfo)
 {
     _OSBASE_TRACE(3, ("--- nlGenLinkFilter() called"));
 
     int rc = NL_OK; // Result handler.
 
     // Reset filter.
-    nlResetLinkFilter();
+    nlResetLinkFilter(ctx);
 
     // family.
     // MUST ALWAYS BE AF_UNSPEC. Check kernel documentation for more info.
@@ -1991,7 +3611,7 @@ int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
     // type.
     if(nlLinkInfo->type <= ARPHRD_VOID) {
         if(nlLinkInfo->type != ARPHRD_VOID) {
-            linkFlt.type = 1;
+            ctx->linkFlt.type = 1;
         }
     } else {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid type: %d.", nlLinkInfo->type));
@@ -2001,7 +3621,7 @@ int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
 
     // index.
     if(nlLinkInfo->index > 0) {
-        linkFlt.index = 1;
+        ctx->linkFlt.index = 1;
     } else if(nlLinkInfo->index < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid index: %d.", nlLinkInfo->index));
         rc = NL_FAIL;
@@ -2010,37 +3630,49 @@ int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
 
     // flags.
     if(nlLinkInfo->flags > 0) {
-        linkFlt.flags = 1;
+        ctx->linkFlt.flags = 1;
     }
 
     // change.
     if(nlLinkInfo->change != 0xFFFFFFFF) {
-        linkFlt.change = 1;
+        ctx->linkFlt.change = 1;
     }
 
-    // address.
-    if(strlen(nlLinkInfo->address) > 0) {
-        linkFlt.address = 1;
+    // address (raw bytes, compared as received).
+    if((nlLinkInfo->addressLen > 0) &&
+       (nlLinkInfo->addressLen <= (int)sizeof(nlLinkInfo->address))) {
+        ctx->linkFlt.address = 1;
+    } else if(nlLinkInfo->addressLen != 0) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid addressLen: %d.",
+                          nlLinkInfo->addressLen));
+        rc = NL_FAIL;
+        goto out;
     }
 
-    // broadcast.
-    if(strlen(nlLinkInfo->broadcast) > 0) {
-        linkFlt.broadcast = 1;
+    // broadcast (raw bytes, compared as received).
+    if((nlLinkInfo->broadcastLen > 0) &&
+       (nlLinkInfo->broadcastLen <= (int)sizeof(nlLinkInfo->broadcast))) {
+        ctx->linkFlt.broadcast = 1;
+    } else if(nlLinkInfo->broadcastLen != 0) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid broadcastLen: %d.",
+                          nlLinkInfo->broadcastLen));
+        rc = NL_FAIL;
+        goto out;
     }
 
     // ifname.
-    if(strlen(nlLinkInfo->ifname) > 0) {
-        linkFlt.ifname = 1;
+    if(nlLinkInfo->ifname != NL_STR_EMPTY) {
+        ctx->linkFlt.ifname = 1;
     }
 
     // mtu.
     if(nlLinkInfo->mtu > 0) {
-        linkFlt.mtu = 1;
+        ctx->linkFlt.mtu = 1;
     }
 
     // link.
     if(nlLinkInfo->link > 0) {
-        linkFlt.link = 1;
+        ctx->linkFlt.link = 1;
     } else if(nlLinkInfo->link < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid link: %d.", nlLinkInfo->link));
         rc = NL_FAIL;
@@ -2048,13 +3680,13 @@ int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
     }
 
     // qdisc.
-    if(strlen(nlLinkInfo->qdisc) > 0) {
-        linkFlt.qdisc = 1;
+    if(nlLinkInfo->qdisc != NL_STR_EMPTY) {
+        ctx->linkFlt.qdisc = 1;
     }
 
     // txqlen.
     if(nlLinkInfo->txqlen > 0) {
-        linkFlt.txqlen = 1;
+        ctx->linkFlt.txqlen = 1;
     } else if(nlLinkInfo->txqlen < 0) {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid txqlen: %d.", nlLinkInfo->txqlen));
         rc = NL_FAIL;
@@ -2064,7 +3696,7 @@ int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
     // operstate.
     if(nlLinkInfo->operstate <= IF_OPER_UP) {
         if(nlLinkInfo->operstate != IF_OPER_UNKNOWN) {
-            linkFlt.operstate = 1;
+            ctx->linkFlt.operstate = 1;
         }
     } else {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid operstate: %d.",
@@ -2076,7 +3708,7 @@ int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
     // linkmode.
     if(nlLinkInfo->linkmode <= IF_LINK_MODE_DORMANT) {
         if(nlLinkInfo->linkmode != IF_LINK_MODE_DEFAULT) {
-            linkFlt.linkmode = 1;
+            ctx->linkFlt.linkmode = 1;
         }
     } else {
         _OSBASE_TRACE(1, ("[ERROR] - Invalid linkmode: %d.",
@@ -2087,11 +3719,25 @@ int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
 
 #ifdef IFLA_IFALIAS
     // ifalias.
-    if(strlen(nlLinkInfo->ifalias) > 0) {
-        linkFlt.ifalias = 1;
+    if(nlLinkInfo->ifalias != NL_STR_EMPTY) {
+        ctx->linkFlt.ifalias = 1;
     }
 #endif //IFLA_IFALIAS
 
+    // master.
+    if(nlLinkInfo->master > 0) {
+        ctx->linkFlt.master = 1;
+    } else if(nlLinkInfo->master < 0) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid master: %d.", nlLinkInfo->master));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // kind.
+    if(nlLinkInfo->kind != NL_STR_EMPTY) {
+        ctx->linkFlt.kind = 1;
+    }
+
  out:
     _OSBASE_TRACE(3, ("--- nlGenLinkFilter() exited"));
     return rc;
@@ -2099,29 +3745,31 @@ int nlGenLinkFilter(const struct nlLinkInfo *nlLinkInfo)
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-void nlResetLinkFilter()
+void nlResetLinkFilter(struct nlContext *ctx)
 {
     _OSBASE_TRACE(3, ("--- nlResetLinkFilter() called"));
 
-    linkFlt.family    = 0;
-    linkFlt.type      = 0;
-    linkFlt.index     = 0;
-    linkFlt.flags     = 0;
-    linkFlt.change    = 0;
-    linkFlt.address   = 0;
-    linkFlt.broadcast = 0;
-    linkFlt.ifname    = 0;
-    linkFlt.mtu       = 0;
-    linkFlt.link      = 0;
-    linkFlt.qdisc     = 0;
-    linkFlt.stats     = 0;
-    linkFlt.txqlen    = 0;
-    linkFlt.map       = 0;
-    linkFlt.operstate = 0;
-    linkFlt.linkmode  = 0;
+    ctx->linkFlt.family    = 0;
+    ctx->linkFlt.type      = 0;
+    ctx->linkFlt.index     = 0;
+    ctx->linkFlt.flags     = 0;
+    ctx->linkFlt.change    = 0;
+    ctx->linkFlt.address   = 0;
+    ctx->linkFlt.broadcast = 0;
+    ctx->linkFlt.ifname    = 0;
+    ctx->linkFlt.mtu       = 0;
+    ctx->linkFlt.link      = 0;
+    ctx->linkFlt.qdisc     = 0;
+    ctx->linkFlt.stats     = 0;
+    ctx->linkFlt.txqlen    = 0;
+    ctx->linkFlt.map       = 0;
+    ctx->linkFlt.operstate = 0;
+    ctx->linkFlt.linkmode  = 0;
 #ifdef IFLA_IFALIAS
-    linkFlt.ifalias   = 0;
+    ctx->linkFlt.ifalias   = 0;
 #endif //IFLA_IFALIAS
+    ctx->linkFlt.master    = 0;
+    ctx->linkFlt.kind      = 0;
 
     _OSBASE_TRACE(3, ("--- nlResetLinkFilter() exited"));
 }
@@ -2150,16 +3798,18 @@ int nlCreateDefaultLinkInfo(struct nlLinkInfo *nlLinkInfo)
     nlLinkInfo->addressLen   = 0;
     snprintf(nlLinkInfo->broadcast, 32, "");
     nlLinkInfo->broadcastLen = 0;
-    snprintf(nlLinkInfo->ifname, IFNAMSIZ, "");
+    nlLinkInfo->ifname       = NL_STR_EMPTY;
     nlLinkInfo->mtu          = 0;
     nlLinkInfo->link         = 0;
-    snprintf(nlLinkInfo->qdisc, 64, "");
+    nlLinkInfo->qdisc        = NL_STR_EMPTY;
     nlLinkInfo->txqlen       = 0;
     nlLinkInfo->operstate    = IF_OPER_UNKNOWN;
     nlLinkInfo->linkmode     = IF_LINK_MODE_DEFAULT;
 #ifdef IFLA_IFALIAS
-    snprintf(nlLinkInfo->ifalias, IFALIASZ, "");
+    nlLinkInfo->ifalias      = NL_STR_EMPTY;
 #endif //IFLA_IFALIAS
+    nlLinkInfo->master       = 0;
+    nlLinkInfo->kind         = NL_STR_EMPTY;
 
  out:
     _OSBASE_TRACE(3, ("--- nlCreateDefaultLinkInfo() exited"));
@@ -2167,64 +3817,23 @@ int nlCreateDefaultLinkInfo(struct nlLinkInfo *nlLinkInfo)
 }
 //------------------------------------------------------------------------------
 
-//------------------------------------------------------------------------------
-int nlFreeLinkInfoList(struct nlLinkInfoList *nlLinkInfoList)
-{
-    _OSBASE_TRACE(3, ("--- nlFreeLinkInfoList() called"));
-
-    struct nlLinkInfoList *nlLinkInfoListTmp = NULL;  // Temporary list
-                                                      // container.
-    int                    rc                = NL_OK; // Result handler.
-
-    // Check received parameters.
-    if(nlLinkInfoList == NULL) {
-        _OSBASE_TRACE(2, ("[INFO] - NULL link info list, nothing to free."));
-        goto out;
-    }
-
-    // Clean.
-    while(nlLinkInfoList != NULL) {
-        FREE_SAFE(nlLinkInfoList->sptr);
-        nlLinkInfoListTmp = nlLinkInfoList;
-        nlLinkInfoList = nlLinkInfoList->next;
-        FREE_SAFE(nlLinkInfoListTmp);
-    }
-
- out:
-    _OSBASE_TRACE(3, ("--- nlFreeLinkInfoList() exited"));
-    return rc;
-}
-//------------------------------------------------------------------------------
-
 //------------------------------------------------------------------------------
 void nlAddr_n2a(const unsigned char *addr, int alen, int type,
                 char *buf, int blen)
 {
     _OSBASE_TRACE(3, ("--- nlAddr_n2a() called"));
 
-    int i = 0;
-    int l = 0;
-
     if(alen == 4 &&
        (type == ARPHRD_TUNNEL || type == ARPHRD_SIT || type == ARPHRD_IPGRE)) {
-        inet_ntop(AF_INET, addr, buf, blen);
-        return;
-    }
-    if(alen == 16 && type == ARPHRD_TUNNEL6) {
-        inet_ntop(AF_INET6, addr, buf, blen);
-        return;
-    }
-
-    for(i=0 ; i<alen ; i++) {
-        if(i==0) {
-            snprintf(buf+l, blen, "%02x", addr[i]);
-            blen -= 2;
-            l += 2;
-        } else {
-            snprintf(buf+l, blen, ":%02x", addr[i]);
-            blen -= 3;
-            l += 3;
+        if(nlFmtAddr(AF_INET, addr, buf, blen) < 0) {
+            buf[0] = '\0';
         }
+    } else if(alen == 16 && type == ARPHRD_TUNNEL6) {
+        if(nlFmtAddr(AF_INET6, addr, buf, blen) < 0) {
+            buf[0] = '\0';
+        }
+    } else {
+        nlFmtMAC(addr, alen, buf, blen);
     }
 
     _OSBASE_TRACE(3, ("--- nlAddr_n2a() exited"));
@@ -2250,3 +3859,68 @@ unsigned short nlGetLinkTypePos(unsigned short devType)
 //------------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// CONTEXT
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+int nlCtxInit(struct nlContext *ctx)
+{
+    _OSBASE_TRACE(3, ("--- nlCtxInit() called"));
+
+    int rc = NL_OK; // Result handler.
+
+    // Check received parameters.
+    if(ctx == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NL_FAIL;
+        goto out;
+    }
+
+    // The socket and the buffers are taken on first use.
+    memset(ctx, 0, sizeof(*ctx));
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlCtxInit() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void nlCtxRelease(struct nlContext *ctx)
+{
+    _OSBASE_TRACE(3, ("--- nlCtxRelease() called"));
+
+    int status = NL_OK; // Socket status.
+
+    if(ctx == NULL) {
+        goto out;
+    }
+
+    if(ctx->sh != NULL) {
+        if((ctx->sh->nPending > 0) || (ctx->sh->dumpHead != NULL)) {
+            _OSBASE_TRACE(2, ("[INFO] - Releasing context with requests " \
+                              "in flight."));
+            nlFailAll(ctx);
+        } else {
+#ifdef NL_USE_IO_URING
+            status = nlUringDrain(ctx);
+#endif
+            nlSockPoolPut(ctx->sh, status);
+            ctx->sh = NULL;
+        }
+    }
+#ifdef NL_USE_IO_URING
+    nlUringExit(ctx);
+#endif
+    FREE_SAFE(ctx->rcvBuf);
+    ctx->rcvBufLen = 0;
+
+ out:
+    _OSBASE_TRACE(3, ("--- nlCtxRelease() exited"));
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
@@ -21,22 +21,137 @@
 
 #include "OSBase_Common.h"
 #include "OSBase_NextHopIPRoute.h"
+#include "OSBase_Parse.h"
+#include "OSBase_AddrFmt.h"
 
+#include <limits.h>
 #include <linux/rtnetlink.h>
-#include <errno.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // COMMON
 ////////////////////////////////////////////////////////////////////////////////
 
 //------------------------------------------------------------------------------
-int getIPRoutes(struct nextHopIPList **nHopIPList,
+/**
+ * Route attributes skipped while decoding (NL_ATTR_BIT). Every property
+ * comes from the rtmsg header or from the destination, the table, the
+ * output interface, the gateway and the priority.
+ */
+#define NH_RT_ATTR_SKIP                                                 \
+    (~(NL_ATTR_BIT(RTA_DST) | NL_ATTR_BIT(RTA_TABLE) |                  \
+       NL_ATTR_BIT(RTA_OIF) | NL_ATTR_BIT(RTA_GATEWAY) |                \
+       NL_ATTR_BIT(RTA_PRIORITY)))
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to put a routes list back in kernel order (nlAddRouteToList adds
+ * every route at the head).
+ * @param nlRtList [in/out] routes list.
+ */
+static void nhReverseList(struct nlRouteList **nlRtList)
+{
+    struct nlRouteList *prev = NULL; // Reversed part of the list.
+    struct nlRouteList *curr = NULL; // Current entry.
+    struct nlRouteList *next = NULL; // Next entry.
+
+    for(curr = *nlRtList ; curr != NULL ; curr = next) {
+        next = curr->next;
+        curr->next = prev;
+        prev = curr;
+    }
+    *nlRtList = prev;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to store a 32 bits field of a route key.
+ * @param p [out] field.
+ * @param val [in] value.
+ */
+static void nhKeyPut32(unsigned char *p, uint32_t val)
+{
+    p[0] = (unsigned char)(val >> 24);
+    p[1] = (unsigned char)(val >> 16);
+    p[2] = (unsigned char)(val >> 8);
+    p[3] = (unsigned char)val;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to keep the routes of a list whose key is the given one. The
+ * filter built from a key leaves out the fields it can not express, the
+ * key comparison makes the InstanceID resolution exact.
+ * @param nlRtList [in/out] routes list.
+ * @param key [in] route key.
+ * @param legacy [in] the key comes from a legacy InstanceID (see
+ *        nhLegacyKey): it has no TOS nor priority and a scope 0 matches
+ *        any scope.
+ */
+static void nhKeepKey(struct nlRouteList **nlRtList, const unsigned char *key,
+                      int legacy)
+{
+    struct nlRouteList **curr = nlRtList;       // Current entry link.
+    unsigned char        rtKey[NH_IID_KEY_LEN]; // Key of the entry.
+
+    while(*curr != NULL) {
+        nhRouteKey((*curr)->sptr, rtKey);
+        if(legacy) {
+            rtKey[2] = 0;
+            memset(rtKey + 12, 0, 4);
+            if(key[3] == 0) {
+                rtKey[3] = 0;
+            }
+        }
+        if(memcmp(rtKey, key, NH_IID_KEY_LEN) == 0) {
+            curr = &((*curr)->next);
+        } else {
+            *curr = (*curr)->next;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to build the route key of a legacy InstanceID from the filter
+ * nhParseInstanceId filled. TOS and priority are not part of it, absent
+ * addresses are zeroed like nhRouteKey does.
+ * @param nlRtInfo [in] route filter of a legacy InstanceID.
+ * @param key [out] route key.
+ */
+static void nhLegacyKey(const struct nlRouteInfo *nlRtInfo,
+                        unsigned char *key)
+{
+    memset(key, 0, NH_IID_KEY_LEN);
+    key[0] = nlRtInfo->family;
+    key[1] = nlRtInfo->dstLen;
+    key[3] = nlRtInfo->scope;
+    nhKeyPut32(key + 4, nlRtInfo->table);
+    nhKeyPut32(key + 8, nlRtInfo->outputIf);
+    if(nlRtInfo->dstAddr[0] != '\0') {
+        nlParseAddr(nlRtInfo->dstAddr, strlen(nlRtInfo->dstAddr), key + 16);
+    }
+    if(nlRtInfo->gw[0] != '\0') {
+        nlParseAddr(nlRtInfo->gw, strlen(nlRtInfo->gw), key + 32);
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int getIPRoutes(struct nlArena *arena, struct nlRouteList **nlRtList,
                 struct nlRouteInfo *nlRtInfo)
 {
     _OSBASE_TRACE(3, ("--- getIPRoutes() called"));
 
-    struct nlRouteInfoList *list = NULL;  // Netlink routes list.
-    int                     rc   = NH_OK; // Result handler.
+    struct nlContext ctx;        // Netlink request context.
+    int              rc = NH_OK; // Result handler.
+
+    nlCtxInit(&ctx);
+    ctx.arena      = arena;
+    ctx.rtAttrSkip = NH_RT_ATTR_SKIP;
 
     // Check route info (used as filter).
     if(nlRtInfo == NULL) {
@@ -45,41 +160,19 @@ int getIPRoutes(struct nextHopIPList **nHopIPList,
         goto out;
     }
 
-    // Open netlink socket.
-    if(nlOpenSocket() != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Unable to open netlink socket."));
-        rc = NH_FAIL;
-        goto out;
-    }
-
-    // Get routes.
-    if(nlGetRoutes(&list, nlRtInfo) != NL_OK) {
-        nlCloseSocket();
+    // Get routes. They are kept as nlRoute records, the CIM strings are
+    // rendered when the instances are built.
+    if(nlGetRoutes(&ctx, nlRtList, nlRtInfo) != NL_OK) {
         _OSBASE_TRACE(1, ("[ERROR] - Unable to get NextHopIPRoutes."));
         rc = NH_FAIL;
         goto out;
     }
-
-    // Close netlink socket.
-    if(nlCloseSocket() != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Unable to close netlink socket."));
-        rc = NH_FAIL;
-        goto out;
-    }
-
-    // Convert list.
-    if(nlListTOnhList(&list, nHopIPList) != NH_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Could not convert netlink routes list " \
-                          "to NextHopIPRoute routes list."));
-        rc = NH_FAIL;
-        goto out;
-    }
+    nhReverseList(nlRtList);
 
  out:
-    nlFreeRouteInfoList(list);
+    nlCtxRelease(&ctx);
     if(rc == NH_FAIL) {
-        freeNextHopIPList(*nHopIPList);
-        FREE_SAFE(nHopIPList);
+        *nlRtList = NULL;
     }
 
     _OSBASE_TRACE(3, ("--- getIPRoutes() exited"));
@@ -88,7 +181,7 @@ int getIPRoutes(struct nextHopIPList **nHopIPList,
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int getAllIPRoutes(struct nextHopIPList **nHopIPList)
+int getAllIPRoutes(struct nlArena *arena, struct nlRouteList **nlRtList)
 {
     _OSBASE_TRACE(3, ("--- getAllIPRoutes() called"));
 
@@ -102,17 +195,10 @@ int getAllIPRoutes(struct nextHopIPList **nHopIPList)
         goto out;
     }
 
-    // Get IPv4 routes.
-    if(getIPRoutes(nHopIPList, &nlRtInfo) != NH_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Could not get IPv4 routes."));
-        rc = NH_FAIL;
-        goto out;
-    }
-
-    // Get IPv6 routes.
-    nlRtInfo.family = AF_INET6;
-    if(getIPRoutes(nHopIPList, &nlRtInfo) != NH_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Could not get IPv6 routes."));
+    // Get IPv4 and IPv6 routes with a single dump.
+    nlRtInfo.family = AF_UNSPEC;
+    if(getIPRoutes(arena, nlRtList, &nlRtInfo) != NH_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not get IP routes."));
         rc = NH_FAIL;
         goto out;
     }
@@ -124,13 +210,20 @@ int getAllIPRoutes(struct nextHopIPList **nHopIPList)
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int getIPRouteIId(struct nextHopIPList **nHopIPList, const char *instanceId)
+int getIPRouteIId(struct nlArena *arena, struct nlRouteList **nlRtList,
+                  const char *instanceId)
 {
     _OSBASE_TRACE(3, ("--- getIPRouteIId() called"));
 
-    char               hostName[MAXHOSTNAMELEN]; // HostName of the system.
-    struct nlRouteInfo nlRtInfo;                 // Filter.
-    int                rc = NH_OK;               // Result handler.
+    struct nlContext   ctx;                 // Netlink request context.
+    struct nlRouteInfo nlRtInfo;            // Filter.
+    unsigned char      key[NH_IID_KEY_LEN]; // InstanceID key.
+    int                legacy = 0;          // Legacy InstanceID.
+    int                rc     = NH_OK;      // Result handler.
+
+    nlCtxInit(&ctx);
+    ctx.arena      = arena;
+    ctx.rtAttrSkip = NH_RT_ATTR_SKIP;
 
     // Generic route info.
     if(nlCreateDefaultRtInfo(&nlRtInfo) != NH_OK) {
@@ -140,17 +233,46 @@ int getIPRouteIId(struct nextHopIPList **nHopIPList, const char *instanceId)
     }
 
     // Parse InstanceId.
-    sscanf(instanceId, INSTANCEID_FORMAT_PARSE,
-           hostName, nlRtInfo.dstAddr, &(nlRtInfo.dstLen),
-           &(nlRtInfo.table), &(nlRtInfo.outputIf), &(nlRtInfo.scope),
-           nlRtInfo.gw);
-    if(getIPRoutes(nHopIPList, &nlRtInfo) != NH_OK) {
+    if(nhParseInstanceId(instanceId, &nlRtInfo) != NH_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid InstanceID: %s.", instanceId));
+        rc = NH_FAIL;
+        goto out;
+    }
+
+    // A legacy InstanceID has no TOS nor priority: the lookup would only
+    // give the preferred of the routes it may name, the filtered dump gives
+    // all of them. A compact one names the route, so the prefix is looked
+    // up instead of dumping every table.
+    if(nhDecodeInstanceId(instanceId, key) != NH_OK) {
+        legacy = 1;
+        nhLegacyKey(&nlRtInfo, key);
+        rc = (nlGetRoutes(&ctx, nlRtList, &nlRtInfo) == NL_OK) ?
+            NH_OK : NH_FAIL;
+    } else {
+        rc = (nlGetRoute(&ctx, nlRtList, &nlRtInfo) == NL_OK) ?
+            NH_OK : NH_FAIL;
+    }
+    if(rc != NH_OK) {
         _OSBASE_TRACE(1, ("[ERROR] - Could not get IP route."));
+        goto out;
+    }
+    nhReverseList(nlRtList);
+
+    // Exact match of the key, an InstanceID naming several routes names
+    // none of them.
+    nhKeepKey(nlRtList, key, legacy);
+    if((*nlRtList != NULL) && ((*nlRtList)->next != NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - InstanceID %s names several routes.",
+                          instanceId));
         rc = NH_FAIL;
         goto out;
     }
 
  out:
+    nlCtxRelease(&ctx);
+    if(rc == NH_FAIL) {
+        *nlRtList = NULL;
+    }
     _OSBASE_TRACE(3, ("--- getIPRouteIId() exited"));
     return rc;
 }
@@ -161,9 +283,12 @@ int addIPRoute(struct nextHopIP *nHopIP)
 {
     _OSBASE_TRACE(3, ("--- addIPRoute() called"));
 
+    struct nlContext   ctx;        // Netlink request context.
     struct nlRouteInfo nlRtInfo;   // Filter.
     int                rc = NH_OK; // Result handler.
 
+    nlCtxInit(&ctx);
+
     // Generic route info.
     if(nlCreateDefaultRtInfo(&nlRtInfo) != NH_OK) {
         _OSBASE_TRACE(1, ("[ERROR] - Could not create default route filter."));
@@ -179,30 +304,16 @@ int addIPRoute(struct nextHopIP *nHopIP)
         goto out;
     }
 
-    // Open netlink socket.
-    if(nlOpenSocket() != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Unable to open netlink socket."));
-        rc = NH_FAIL;
-        goto out;
-    }
-
     // Add route.
-    if(nlModifyRoute(&nlRtInfo, RTM_NEWROUTE,
+    if(nlModifyRoute(&ctx, &nlRtInfo, RTM_NEWROUTE,
                      (NLM_F_CREATE | NLM_F_EXCL)) != NL_OK) {
-        nlCloseSocket();
         _OSBASE_TRACE(1, ("[ERROR] - Could not add desired route."));
         rc = NH_FAIL;
         goto out;
     }
 
-    // Close netlink socket.
-    if(nlCloseSocket() != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Unable to close netlink socket."));
-        rc = NH_FAIL;
-        goto out;
-    }
-
  out:
+    nlCtxRelease(&ctx);
     _OSBASE_TRACE(3, ("--- addIPRoute() exited"));
     return rc;
 }
@@ -213,9 +324,16 @@ int delIPRoute(const struct nextHopIP *nHopIP)
 {
     _OSBASE_TRACE(3, ("--- delIPRoute() called"));
 
-    char               hostName[MAXHOSTNAMELEN];   // System hostname.
-    struct nlRouteInfo nlRtInfo;                   // Filter.
-    int                rc = NH_OK;                 // Result handler.
+    struct nlContext    ctx;                 // Netlink request context.
+    struct nlArena      arena;               // Resolved route.
+    struct nlRouteInfo  nlRtInfo;            // Filter.
+    struct nlRouteList *list = NULL;         // Route named by the IId.
+    unsigned char       key[NH_IID_KEY_LEN]; // Key of the route.
+    char                iid[NH_IID_LEN+1];   // Compact IId of the route.
+    int                 rc   = NH_OK;        // Result handler.
+
+    nlCtxInit(&ctx);
+    nlArenaInit(&arena);
 
     // Generic route info.
     if(nlCreateDefaultRtInfo(&nlRtInfo) != NH_OK) {
@@ -224,96 +342,39 @@ int delIPRoute(const struct nextHopIP *nHopIP)
         goto out;
     }
 
-    // Parse InstanceId.
-    sscanf(nHopIP->instanceID, INSTANCEID_FORMAT_PARSE,
-           hostName, nlRtInfo.dstAddr, &(nlRtInfo.dstLen),
-           &(nlRtInfo.table), &(nlRtInfo.outputIf), &(nlRtInfo.scope),
-           nlRtInfo.gw);
-
-    // Open netlink socket.
-    if(nlOpenSocket() != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Unable to open netlink socket."));
+    // Resolve the InstanceID first (the kernel deletes the first route
+    // matching the fields it is given), then delete that route by its
+    // whole key.
+    if((getIPRouteIId(&arena, &list, nHopIP->instanceID) != NH_OK) ||
+       (list == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - No single route for InstanceID: %s.",
+                          nHopIP->instanceID));
         rc = NH_FAIL;
         goto out;
     }
-
-    // Del route.
-    if(nlModifyRoute(&nlRtInfo, RTM_DELROUTE, 0) != NL_OK) {
-        nlCloseSocket();
-        _OSBASE_TRACE(1, ("[ERROR] - Could not remove desired route."));
+    nhRouteKey(list->sptr, key);
+    nhEncodeInstanceId(key, iid);
+    if(nhParseInstanceId(iid, &nlRtInfo) != NH_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid InstanceID: %s.", iid));
         rc = NH_FAIL;
         goto out;
     }
 
-    // Close netlink socket.
-    if(nlCloseSocket() != NL_OK) {
-        _OSBASE_TRACE(1, ("[ERROR] - Unable to close netlink socket."));
+    // Del route.
+    if(nlModifyRoute(&ctx, &nlRtInfo, RTM_DELROUTE, 0) != NL_OK) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not remove desired route."));
         rc = NH_FAIL;
         goto out;
     }
 
  out:
+    nlCtxRelease(&ctx);
+    nlArenaRelease(&arena);
     _OSBASE_TRACE(3, ("--- delIPRoute() exited"));
     return rc;
 }
 //------------------------------------------------------------------------------
 
-//------------------------------------------------------------------------------
-int nlListTOnhList(struct nlRouteInfoList **nlRtInfoList,
-                   struct nextHopIPList **nHopIPList)
-{
-    _OSBASE_TRACE(3, ("--- nlListTOnhList() called"));
-
-    struct nextHopIPList   *nHopIPListCurr   = NULL;  // Current next-hop route.
-    struct nlRouteInfoList *nlRtInfoListCurr = NULL;  // Current netlink route.
-    int                     rc               = NH_OK; // Result handler.
-
-    nlRtInfoListCurr = *nlRtInfoList;
-    while(nlRtInfoListCurr != NULL) {
-        if(nlRtInfoListCurr->sptr != NULL) {
-            // Create new route struct and temp containers variables.
-            nHopIPListCurr = malloc(sizeof(*nHopIPListCurr));
-            if(nHopIPListCurr == NULL) {
-                _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
-                                  "\'nHopIPListCurr\'."));
-                rc = NH_FAIL;
-                goto out;
-            }
-            memset(nHopIPListCurr, 0, sizeof(*nHopIPListCurr));
-            
-            nHopIPListCurr->sptr = malloc(sizeof(*(nHopIPListCurr->sptr)));
-            if(nHopIPListCurr->sptr == NULL) {
-                FREE_SAFE(nHopIPListCurr);
-                _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
-                                  "\'nHopIPListCurr->sptr\'."));
-                rc = NH_FAIL;
-                goto out;
-            }
-            memset(nHopIPListCurr->sptr, 0, sizeof(*(nHopIPListCurr->sptr)));
-
-            // Convert from nl to nh.
-            if(nlInfoTOnh(nlRtInfoListCurr->sptr,
-                          nHopIPListCurr->sptr) != NH_OK) {
-                freeNextHopIPList(nHopIPListCurr);
-                _OSBASE_TRACE(1, ("[ERROR] - Could not convert structure " \
-                                  "from nl to nh."));
-                rc = NH_FAIL;
-                goto out;
-            }
-
-            // Set next Next-hop.
-            nHopIPListCurr->next = *nHopIPList;
-            *nHopIPList = nHopIPListCurr;
-        }
-        nlRtInfoListCurr = nlRtInfoListCurr->next;
-    }
-
- out:
-    _OSBASE_TRACE(3, ("--- nlListTOnhList() exited"));
-    return rc;
-}
-//------------------------------------------------------------------------------
-
 //------------------------------------------------------------------------------
 int nhTOnlInfo(struct nextHopIP *nHopIP, struct nlRouteInfo *nlRtInfo)
 {
@@ -424,35 +485,179 @@ int nhTOnlInfo(struct nextHopIP *nHopIP, struct nlRouteInfo *nlRtInfo)
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int nlInfoTOnh(const struct nlRouteInfo *nlRtInfo, struct nextHopIP *nHopIP)
+int nhConvInit(struct nhConv *conv, struct nlArena *arena,
+               unsigned int props)
+{
+    _OSBASE_TRACE(3, ("--- nhConvInit() called"));
+
+    struct nlContext       ctx;           // Netlink request context.
+    struct nlLinkInfo      nlLinkInfo;    // Filter.
+    struct nlLinkInfoList *list = NULL;   // Links list.
+    struct nlLinkInfoList *curr = NULL;   // Current link.
+    int                    rc   = NH_OK;  // Result handler.
+
+    nlCtxInit(&ctx);
+
+    // Check received parameters.
+    if((conv == NULL) || (arena == NULL)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Invalid received parameters."));
+        rc = NH_FAIL;
+        goto out;
+    }
+    memset(conv, 0, sizeof(*conv));
+    conv->arena = arena;
+
+    // Interface names (Description), from a single link dump instead of
+    // an if_indextoname call per route.
+    if(!(props & NH_P_DESCRIPTION)) {
+        goto out;
+    }
+    ctx.arena        = arena;
+    ctx.linkAttrSkip = ~NL_ATTR_BIT(IFLA_IFNAME);
+    ctx.noStats      = 1;
+    if((nlCreateDefaultLinkInfo(&nlLinkInfo) != NL_OK) ||
+       (nlGetLinks(&ctx, &list, &nlLinkInfo) != NL_OK)) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not get interface names."));
+        rc = NH_FAIL;
+        goto out;
+    }
+    for(curr = list ; curr != NULL ; curr = curr->next) {
+        if(curr->sptr->index >= (int)conv->ifCount) {
+            conv->ifCount = curr->sptr->index + 1;
+        }
+    }
+    if(conv->ifCount == 0) {
+        goto out;
+    }
+    conv->ifNames = nlArenaAlloc(arena,
+                                 conv->ifCount * sizeof(*(conv->ifNames)));
+    if(conv->ifNames == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
+                          "\'conv->ifNames\'."));
+        conv->ifCount = 0;
+        rc = NH_FAIL;
+        goto out;
+    }
+    for(curr = list ; curr != NULL ; curr = curr->next) {
+        if(curr->sptr->index > 0) {
+            conv->ifNames[curr->sptr->index] = curr->sptr->ifname;
+        }
+    }
+
+ out:
+    nlCtxRelease(&ctx);
+    _OSBASE_TRACE(3, ("--- nhConvInit() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nhConvIIdFormat(struct nhConv *conv, const char *instanceId)
+{
+    _OSBASE_TRACE(3, ("--- nhConvIIdFormat() called"));
+
+    unsigned char key[NH_IID_KEY_LEN]; // Compact InstanceID key.
+    int           rc = NH_OK;          // Result handler.
+
+    // Compact InstanceIDs are rendered by default.
+    if(nhDecodeInstanceId(instanceId, key) == NH_OK) {
+        goto out;
+    }
+
+    conv->hostName = nlArenaAlloc(conv->arena, MAXHOSTNAMELEN);
+    if(conv->hostName == NULL) {
+        _OSBASE_TRACE(1, ("[ERROR] - Could not alloc memory for " \
+                          "\'conv->hostName\'."));
+        rc = NH_FAIL;
+        goto out;
+    }
+    if(gethostname(conv->hostName, MAXHOSTNAMELEN) != 0) {
+        _OSBASE_TRACE(1, ("[ERROR] - Cannot get hostname."));
+        conv->hostName = NULL;
+        rc = NH_FAIL;
+        goto out;
+    }
+    conv->hostName[MAXHOSTNAMELEN - 1] = '\0';
+
+ out:
+    _OSBASE_TRACE(3, ("--- nhConvIIdFormat() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+const char* nhConvIfName(const struct nhConv *conv, unsigned int ifindex)
+{
+    if(ifindex >= conv->ifCount) {
+        return "";
+    }
+    return nlStrGet(conv->arena, conv->ifNames[ifindex]);
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to render the legacy InstanceID (INSTANCEID_FORMAT) of a route.
+ * @param hostName [in] host name.
+ * @param route [in] route.
+ * @param instanceId [out] InstanceID.
+ * @param len [in] InstanceID buffer length.
+ * @return NH_OK=succesful | NH_FAIL=fail
+ */
+static int nhLegacyInstanceId(const char *hostName,
+                              const struct nlRoute *route,
+                              char *instanceId, size_t len)
+{
+    char dstAddr[NL_ADDRESS_MAXLEN+1]; // Destination address.
+    char gw[NL_ADDRESS_MAXLEN+1];      // Gateway.
+
+    if((nlRtAddr_n2a(route, RTA_DST, dstAddr, sizeof(dstAddr)) != NL_OK) ||
+       (nlRtAddr_n2a(route, RTA_GATEWAY, gw, sizeof(gw)) != NL_OK)) {
+        return NH_FAIL;
+    }
+    snprintf(instanceId, len, INSTANCEID_FORMAT, hostName, dstAddr,
+             route->dstLen, (int)route->table, (int)route->outputIf,
+             route->scope, gw);
+    return NH_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlRouteTOnh(const struct nhConv *conv, const struct nlRoute *route,
+                struct nextHopIP *nHopIP, unsigned int props)
 {
-    _OSBASE_TRACE(3, ("--- nlInfoTOnh() called"));
+    _OSBASE_TRACE(3, ("--- nlRouteTOnh() called"));
 
-    char addrTypeStr[ADDR_TYPE_STR_MAXLEN];  // Temporary string.
-    char tmpStr[256];                        // Used to store strings
-                                             // temporarily.
-    int  rc = NH_OK;                         // Result handler.
+    char          addrTypeStr[ADDR_TYPE_STR_MAXLEN]; // Temporary string.
+    unsigned char key[NH_IID_KEY_LEN];               // Route key.
+    const char   *ifName = NULL;                     // Output interface name.
+    int           rc     = NH_OK;                    // Result handler.
 
     // addressType.
-    if(nlRtInfo->family == AF_INET) {
+    if(route->family == AF_INET) {
         nHopIP->addressType = NH_AT_IPV4;
-    } else if(nlRtInfo->family == AF_INET6) {
+    } else if(route->family == AF_INET6) {
         nHopIP->addressType = NH_AT_IPV6;
     } else {
         nHopIP->addressType = NH_AT_UNKNOWN;
     }
-    if(getAddrTypeStr(nHopIP->addressType, addrTypeStr) != NH_OK) {
+    if((props & (NH_P_CAPTION | NH_P_ELEMENT_NAME)) &&
+       (getAddrTypeStr(nHopIP->addressType, addrTypeStr) != NH_OK)) {
         _OSBASE_TRACE(1, ("[ERROR] - Could not get address type as string."));
         rc = NH_FAIL;
         goto out;
     }
 
-    // dstAddress.
-    snprintf(nHopIP->dstAddress, 64, "%s", nlRtInfo->dstAddr);
+    // dstAddress (description and elementName include it).
+    if((props & (NH_P_DST_ADDRESS | NH_P_DESCRIPTION | NH_P_ELEMENT_NAME)) &&
+       (nlRtAddr_n2a(route, RTA_DST, nHopIP->dstAddress, 64) != NL_OK)) {
+        rc = NH_FAIL;
+        goto out;
+    }
 
     // dstMask.
     if(nHopIP->addressType == NH_AT_IPV4) {
-        snprintf(nHopIP->dstMask, 64, "%d", nlRtInfo->dstLen);
+        snprintf(nHopIP->dstMask, 64, "%d", route->dstLen);
     } else {
         // Not used in IPv6.
         snprintf(nHopIP->dstMask, 64, "");
@@ -460,14 +665,14 @@ int nlInfoTOnh(const struct nlRouteInfo *nlRtInfo, struct nextHopIP *nHopIP)
 
     // prefixLength.
     if(nHopIP->addressType == NH_AT_IPV6) {
-        nHopIP->prefixLength = nlRtInfo->dstLen;
+        nHopIP->prefixLength = route->dstLen;
     } else {
         // Not used in IPv4.
         nHopIP->prefixLength = 0;
     }
 
     // isStatic.
-    if(nlRtInfo->protocol > RTPROT_STATIC) {
+    if(route->protocol > RTPROT_STATIC) {
         // false.
         nHopIP->isStatic = 0;
     } else {
@@ -476,15 +681,17 @@ int nlInfoTOnh(const struct nlRouteInfo *nlRtInfo, struct nextHopIP *nHopIP)
     }
 
     // otherDerivation.
-    snprintf(nHopIP->otherDerivation, 64, "");
+    if(props & NH_P_OTHER_DERIVATION) {
+        snprintf(nHopIP->otherDerivation, 64, "");
+    }
 
     // routeDerivation.
     // @todo obtain from Quagga.
-    if((nlRtInfo->protocol > RTPROT_STATIC) ||
-       ((nlRtInfo->protocol > RTPROT_UNSPEC) &&
-        (nlRtInfo->protocol < RTPROT_STATIC))) {
+    if((route->protocol > RTPROT_STATIC) ||
+       ((route->protocol > RTPROT_UNSPEC) &&
+        (route->protocol < RTPROT_STATIC))) {
         nHopIP->routeDerivation = NH_RTD_OTHER;
-    } else if(nlRtInfo->protocol == RTPROT_STATIC) {
+    } else if(route->protocol == RTPROT_STATIC) {
         nHopIP->routeDerivation = NH_RTD_USER_DEFINED;
     } else {
         nHopIP->routeDerivation = NH_RTD_UNKNOWN;
@@ -495,103 +702,434 @@ int nlInfoTOnh(const struct nlRouteInfo *nlRtInfo, struct nextHopIP *nHopIP)
     nHopIP->adminDistance = 1;
 
     // routeMetric.
-    nHopIP->routeMetric = nlRtInfo->priority;
+    nHopIP->routeMetric = route->priority;
 
     // typeOfRoute.
-    if(nlRtInfo->protocol == RTPROT_STATIC) {
+    if(route->protocol == RTPROT_STATIC) {
         nHopIP->typeOfRoute = NH_TOR_ADMINISTRATOR;
     } else {
         nHopIP->typeOfRoute = NH_TOR_COMPUTED;
     }
 
     // routeGateway.
-    snprintf(nHopIP->routeGateway, 64, "%s", nlRtInfo->gw);
+    if((props & NH_P_ROUTE_GATEWAY) &&
+       (nlRtAddr_n2a(route, RTA_GATEWAY, nHopIP->routeGateway, 64) != NL_OK)) {
+        rc = NH_FAIL;
+        goto out;
+    }
 
     // routeOutputIf.
-    nHopIP->routeOutputIf = nlRtInfo->outputIf;
+    nHopIP->routeOutputIf = route->outputIf;
 
     // routeScope.
-    nHopIP->routeScope = nlRtInfo->scope;
+    nHopIP->routeScope = route->scope;
 
     // routeTable.
-    nHopIP->routeTable = nlRtInfo->table;
+    nHopIP->routeTable = route->table;
 
     // routeType.
-    nHopIP->routeType = nlRtInfo->type;
+    nHopIP->routeType = route->type;
 
     // caption.
-    snprintf(nHopIP->caption, 64, "NextHop %s route.", addrTypeStr);
+    if(props & NH_P_CAPTION) {
+        snprintf(nHopIP->caption, 64, "NextHop %s route.", addrTypeStr);
+    }
 
     // description.
-    if_indextoname(nHopIP->routeOutputIf, tmpStr);
-    if(tmpStr == NULL) {
-        _OSBASE_TRACE(1, ("[ERROR] - Cannot get ifname. %s",
-                          strerror(errno)));
-        rc = NH_FAIL;
-        goto out;
-    }
-    if(nHopIP->addressType == NH_AT_IPV4) {
-        snprintf(nHopIP->description, 256,
-                 "NextHop to %s/%s through \"%s\" interface.",
-                 nHopIP->dstAddress, nHopIP->dstMask, tmpStr);
-    } else if(nHopIP->addressType == NH_AT_IPV6) {
-        snprintf(nHopIP->description, 256,
-                 "NextHop to %s/%d through \"%s\" interface.",
-                 nHopIP->dstAddress, nHopIP->prefixLength, tmpStr);
-    } else {
-        snprintf(nHopIP->description, 256,
-                 "NextHop through \"%s\" interface.", tmpStr);
+    if(props & NH_P_DESCRIPTION) {
+        // Routes without output interface (blackhole, unreachable...)
+        // have no ifname.
+        ifName = nhConvIfName(conv, route->outputIf);
+        if(nHopIP->addressType == NH_AT_IPV4) {
+            snprintf(nHopIP->description, 256,
+                     "NextHop to %s/%s through \"%s\" interface.",
+                     nHopIP->dstAddress, nHopIP->dstMask, ifName);
+        } else if(nHopIP->addressType == NH_AT_IPV6) {
+            snprintf(nHopIP->description, 256,
+                     "NextHop to %s/%d through \"%s\" interface.",
+                     nHopIP->dstAddress, nHopIP->prefixLength, ifName);
+        } else {
+            snprintf(nHopIP->description, 256,
+                     "NextHop through \"%s\" interface.", ifName);
+        }
     }
 
     // elementName.
-    if(nHopIP->addressType == NH_AT_IPV4) {
-        snprintf(nHopIP->elementName, 64, "%s-%s/%s",
-                 addrTypeStr, nHopIP->dstAddress, nHopIP->dstMask);
-    } else if(nHopIP->addressType == NH_AT_IPV6) {
-        snprintf(nHopIP->elementName, 64, "%s-%s/%d",
-                 addrTypeStr, nHopIP->dstAddress, nHopIP->prefixLength);
+    if(props & NH_P_ELEMENT_NAME) {
+        if(nHopIP->addressType == NH_AT_IPV4) {
+            snprintf(nHopIP->elementName, 64, "%s-%s/%s",
+                     addrTypeStr, nHopIP->dstAddress, nHopIP->dstMask);
+        } else if(nHopIP->addressType == NH_AT_IPV6) {
+            snprintf(nHopIP->elementName, 64, "%s-%s/%d",
+                     addrTypeStr, nHopIP->dstAddress, nHopIP->prefixLength);
+        } else {
+            snprintf(nHopIP->elementName, 64, "%s", addrTypeStr);
+        }
+    }
+
+    // instanceID (legacy one when the client sent a legacy one).
+    if(conv->hostName != NULL) {
+        if(nhLegacyInstanceId(conv->hostName, route, nHopIP->instanceID,
+                              sizeof(nHopIP->instanceID)) != NH_OK) {
+            rc = NH_FAIL;
+            goto out;
+        }
     } else {
-        snprintf(nHopIP->elementName, 64, "%s", addrTypeStr);
+        nhRouteKey(route, key);
+        nhEncodeInstanceId(key, nHopIP->instanceID);
     }
 
-    // instanceID.
-    if(gethostname(tmpStr, MAXHOSTNAMELEN) != 0) {
-        _OSBASE_TRACE(1, ("[ERROR] - Cannot get hostname."));
+ out:
+    _OSBASE_TRACE(3, ("--- nlRouteTOnh() exited"));
+    return rc;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * base64url alphabet (RFC 4648) of the compact InstanceID.
+ */
+static const char nhB64[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get the value of a base64url character.
+ * @param c [in] character.
+ * @return value | -1=not a base64url character
+ */
+static int nhB64Val(unsigned char c)
+{
+    if(c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    }
+    if(c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    }
+    if(c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    }
+    if(c == '-') {
+        return 62;
+    }
+    if(c == '_') {
+        return 63;
+    }
+    return -1;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to get a 32 bits field of a route key as filter value.
+ * @param p [in] field.
+ * @return value | -1=out of the filter range (not filtered)
+ */
+static int nhKeyGet32(const unsigned char *p)
+{
+    uint32_t val = 0; // Value.
+
+    val = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+          ((uint32_t)p[2] << 8) | p[3];
+    return (val > INT_MAX) ? -1 : (int)val;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to know if a part of a route key is zeroed.
+ * @param p [in] key part.
+ * @param len [in] key part length.
+ * @return 1=zeroed | 0=not zeroed
+ */
+static int nhKeyZero(const unsigned char *p, int len)
+{
+    int i = 0; // Current byte.
+
+    for(i=0 ; i<len ; i++) {
+        if(p[i] != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to fill a route filter from a route key (see nhDecodeInstanceId).
+ * The values out of the filter range are left out.
+ * @param key [in] route key.
+ * @param nlRtInfo [in/out] route filter (see nlCreateDefaultRtInfo).
+ */
+static void nhKeyTOnlInfo(const unsigned char *key,
+                          struct nlRouteInfo *nlRtInfo)
+{
+    int table = nhKeyGet32(key + 4); // Routing table.
+
+    nlRtInfo->family   = key[0];
+    nlRtInfo->dstLen   = key[1];
+    nlRtInfo->tos      = key[2];
+    nlRtInfo->scope    = key[3];
+    nlRtInfo->table    = (table < 0) ? RT_TABLE_UNSPEC : table;
+    nlRtInfo->outputIf = nhKeyGet32(key + 8);
+    nlRtInfo->priority = nhKeyGet32(key + 12);
+
+    // The default route has no destination, most of the routes have no
+    // gateway.
+    if((key[1] > 0) || !nhKeyZero(key + 16, 16)) {
+        nlFmtAddr(key[0], key + 16, nlRtInfo->dstAddr,
+                  sizeof(nlRtInfo->dstAddr));
+    }
+    if(!nhKeyZero(key + 32, 16)) {
+        nlFmtAddr(key[0], key + 32, nlRtInfo->gw, sizeof(nlRtInfo->gw));
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/**
+ * Used to parse an address field of an InstanceID.
+ * @param p [in] field.
+ * @param end [in] end of the field.
+ * @param addr [out] address (presentation format, validated).
+ * @param family [in/out] family of the previous address field (AF_UNSPEC
+ *        if none), set to the family of this one.
+ * @return NH_OK=succesful | NH_FAIL=invalid address
+ */
+static int nhParseIIdAddr(const char *p, const char *end, char *addr,
+                          int *family)
+{
+    unsigned char bin[16];    // Address (validation only).
+    int           addrFamily; // Family of the address.
+
+    // An empty address is not part of the key.
+    if(p == end) {
+        return NH_OK;
+    }
+    if(end - p > NL_ADDRESS_MAXLEN) {
+        return NH_FAIL;
+    }
+    addrFamily = nlParseAddr(p, end - p, bin);
+    if((addrFamily == AF_UNSPEC) ||
+       ((*family != AF_UNSPEC) && (*family != addrFamily))) {
+        return NH_FAIL;
+    }
+    memcpy(addr, p, end - p);
+    addr[end - p] = '\0';
+    *family = addrFamily;
+    return NH_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nhParseInstanceId(const char *instanceId, struct nlRouteInfo *nlRtInfo)
+{
+    _OSBASE_TRACE(3, ("--- nhParseInstanceId() called"));
+
+    const char    *p      = instanceId;                      // Current field.
+    const char    *end    = instanceId + strlen(instanceId); // End of the IId.
+    const char    *sep    = NULL;                            // Field end.
+    unsigned char  key[NH_IID_KEY_LEN];                      // Compact key.
+    int            family = AF_UNSPEC;                       // Address family.
+    int           *num[4];                                   // Numeric fields.
+    int            i      = 0;                               // Current field.
+    int            rc     = NH_OK;                           // Result handler.
+
+    // Compact InstanceID.
+    if(nhDecodeInstanceId(instanceId, key) == NH_OK) {
+        nhKeyTOnlInfo(key, nlRtInfo);
+        goto out;
+    }
+
+    // Legacy InstanceID.
+    num[0] = &(nlRtInfo->dstLen);
+    num[1] = &(nlRtInfo->table);
+    num[2] = &(nlRtInfo->outputIf);
+    num[3] = &(nlRtInfo->scope);
+
+    // hostName (not part of the filter).
+    sep = memchr(p, '|', end - p);
+    if(sep == NULL) {
         rc = NH_FAIL;
         goto out;
     }
-    if(nHopIP->addressType == NH_AT_IPV6) {
-        snprintf(nHopIP->instanceID, 64, INSTANCEID_FORMAT,
-                 tmpStr, nHopIP->dstAddress, nHopIP->prefixLength,
-                 nHopIP->routeTable, nHopIP->routeOutputIf, nHopIP->routeScope,
-                 nHopIP->routeGateway);
-    } else {
-        snprintf(nHopIP->instanceID, 64, INSTANCEID_FORMAT,
-                 tmpStr, nHopIP->dstAddress, atoi(nHopIP->dstMask),
-                 nHopIP->routeTable, nHopIP->routeOutputIf, nHopIP->routeScope,
-                 nHopIP->routeGateway);
+    p = sep + 1;
+
+    // dstAddr.
+    sep = memchr(p, '|', end - p);
+    if((sep == NULL) ||
+       (nhParseIIdAddr(p, sep, nlRtInfo->dstAddr, &family) != NH_OK)) {
+        rc = NH_FAIL;
+        goto out;
+    }
+    p = sep + 1;
+
+    // dstLen, table, outputIf and scope.
+    for(i=0 ; i<4 ; i++) {
+        p = nlParseInt(p, end, num[i]);
+        if((p == NULL) || (p == end) || (*p != '|')) {
+            rc = NH_FAIL;
+            goto out;
+        }
+        p++;
+    }
+
+    // gw (the rest of the InstanceID).
+    if((memchr(p, '|', end - p) != NULL) ||
+       (nhParseIIdAddr(p, end, nlRtInfo->gw, &family) != NH_OK)) {
+        rc = NH_FAIL;
+        goto out;
+    }
+
+    // The addresses tell the family (a default route without gateway
+    // keeps the filter one).
+    if(family != AF_UNSPEC) {
+        nlRtInfo->family = family;
     }
 
  out:
-    _OSBASE_TRACE(3, ("--- nlInfoTOnh() exited"));
+    _OSBASE_TRACE(3, ("--- nhParseInstanceId() exited"));
     return rc;
 }
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+void nhRouteKey(const struct nlRoute *route, unsigned char *key)
+{
+    int addrLen = (route->family == AF_INET6) ? 16 : 4; // Address length.
+
+    memset(key, 0, NH_IID_KEY_LEN);
+    key[0] = route->family;
+    key[1] = route->dstLen;
+    key[2] = route->tos;
+    key[3] = route->scope;
+    nhKeyPut32(key + 4, route->table);
+    nhKeyPut32(key + 8, route->outputIf);
+    nhKeyPut32(key + 12, route->priority);
+    if(NL_RT_HAS_ADDR(route, RTA_DST)) {
+        memcpy(key + 16, route->dstAddr, addrLen);
+    }
+    if(NL_RT_HAS_ADDR(route, RTA_GATEWAY)) {
+        memcpy(key + 32, route->gw, addrLen);
+    }
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nhNextHopKey(const struct nextHopIP *nHopIP, unsigned char *key)
+{
+    int family = AF_UNSPEC; // Address family.
+
+    memset(key, 0, NH_IID_KEY_LEN);
+    if(nHopIP->addressType == NH_AT_IPV4) {
+        family = AF_INET;
+        key[1] = atoi(nHopIP->dstMask);
+    } else if(nHopIP->addressType == NH_AT_IPV6) {
+        family = AF_INET6;
+        key[1] = nHopIP->prefixLength;
+    } else {
+        return NH_FAIL;
+    }
+    key[0] = family;
+    key[3] = nHopIP->routeScope;
+    nhKeyPut32(key + 4, nHopIP->routeTable);
+    nhKeyPut32(key + 8, nHopIP->routeOutputIf);
+    nhKeyPut32(key + 12, nHopIP->routeMetric);
+    if((nHopIP->dstAddress[0] != '\0') &&
+       (nlParseAddr(nHopIP->dstAddress, strlen(nHopIP->dstAddress),
+                    key + 16) != family)) {
+        return NH_FAIL;
+    }
+    if((nHopIP->routeGateway[0] != '\0') &&
+       (nlParseAddr(nHopIP->routeGateway, strlen(nHopIP->routeGateway),
+                    key + 32) != family)) {
+        return NH_FAIL;
+    }
+    return NH_OK;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+void nhEncodeInstanceId(const unsigned char *key, char *instanceId)
+{
+    char     *out = instanceId; // Current output position.
+    uint32_t  val = 0;          // Current group of 3 bytes.
+    int       i   = 0;          // Current key byte.
+
+    *out++ = NH_IID_VERSION;
+    for(i=0 ; i<NH_IID_KEY_LEN ; i+=3) {
+        val = ((uint32_t)key[i] << 16) | ((uint32_t)key[i+1] << 8) | key[i+2];
+        *out++ = nhB64[val >> 18];
+        *out++ = nhB64[(val >> 12) & 0x3F];
+        *out++ = nhB64[(val >> 6) & 0x3F];
+        *out++ = nhB64[val & 0x3F];
+    }
+    *out = '\0';
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nhDecodeInstanceId(const char *instanceId, unsigned char *key)
+{
+    const char *p       = instanceId + 1; // Current character.
+    uint32_t    val     = 0;              // Current group of 3 bytes.
+    int         addrLen = 0;              // Address length.
+    int         d       = 0;              // Current character value.
+    int         i       = 0;              // Current key byte.
+    int         j       = 0;              // Current character of the group.
+
+    if((instanceId[0] != NH_IID_VERSION) ||
+       (strlen(instanceId) != NH_IID_LEN)) {
+        return NH_FAIL;
+    }
+    for(i=0 ; i<NH_IID_KEY_LEN ; i+=3) {
+        val = 0;
+        for(j=0 ; j<4 ; j++) {
+            d = nhB64Val(*p++);
+            if(d < 0) {
+                return NH_FAIL;
+            }
+            val = (val << 6) | d;
+        }
+        key[i]   = (unsigned char)(val >> 16);
+        key[i+1] = (unsigned char)(val >> 8);
+        key[i+2] = (unsigned char)val;
+    }
+
+    // Only the keys nhRouteKey builds (IPv4 addresses use 4 bytes).
+    if(key[0] == AF_INET) {
+        addrLen = 4;
+    } else if(key[0] == AF_INET6) {
+        addrLen = 16;
+    } else {
+        return NH_FAIL;
+    }
+    if((key[1] > addrLen * 8) ||
+       !nhKeyZero(key + 16 + addrLen, 16 - addrLen) ||
+       !nhKeyZero(key + 32 + addrLen, 16 - addrLen)) {
+        return NH_FAIL;
+    }
+    return NH_OK;
+}
+//------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------------
 int getAddrType(const char *addr)
 {
     _OSBASE_TRACE(3, ("--- getAddrType() called"));
 
-    char tmp[64];            // Used for temporal storage.
-    int  rc = NH_AT_UNKNOWN; // Result.
+    unsigned char tmp[16];            // Used for temporal storage.
+    int           rc = NH_AT_UNKNOWN; // Result.
 
-    if(inet_pton(AF_INET, addr, tmp) == 1) {
-        // IPv4.
+    switch(nlParseAddr(addr, strlen(addr), tmp)) {
+    case AF_INET:
         rc = NH_AT_IPV4;
-    } else if(inet_pton(AF_INET6, addr, tmp) == 1) {
-        // IPv6.
+        break;
+    case AF_INET6:
         rc = NH_AT_IPV6;
+        break;
     }
 
     _OSBASE_TRACE(3, ("--- getAddrType() exited"));
@@ -620,30 +1158,13 @@ int getAddrTypeStr(int addressType, char *addrTypeStr)
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-int freeNextHopIPList(struct nextHopIPList *lptr)
+void cleanupIPRoutes()
 {
-    _OSBASE_TRACE(3, ("--- freeNextHopIPList() called"));
-
-    struct nextHopIPList *ls = NULL;  // Temporary list container.
-    int                   rc = NH_OK; // Result handler.
+    _OSBASE_TRACE(3, ("--- cleanupIPRoutes() called"));
 
-    // Check received parameters.
-    if(lptr == NULL) {
-        _OSBASE_TRACE(2, ("[INFO] - NULL nextHopIPList, nothing to free."));
-        goto out;
-    }
+    nlSockPoolDestroy();
 
-    // Clean.
-    while(lptr != NULL) {
-        FREE_SAFE(lptr->sptr);
-        ls = lptr;
-        lptr = lptr->next;
-        FREE_SAFE(ls);
-    }
-
- out:
-    _OSBASE_TRACE(3, ("--- freeNextHopIPList() exited"));
-    return rc;
+    _OSBASE_TRACE(3, ("--- cleanupIPRoutes() exited"));
 }
 //------------------------------------------------------------------------------
 
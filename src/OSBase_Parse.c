@@ -0,0 +1,235 @@
+/**
+ * @file
+ * OSBase_Parse.c
+ *
+ * THIS FILE IS PROVIDED UNDER THE TERMS OF THE ECLIPSE PUBLIC LICENSE
+ * ("AGREEMENT"). ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS FILE
+ * CONSTITUTES RECIPIENTS ACCEPTANCE OF THE AGREEMENT.
+ *
+ * You can obtain a current copy of the Eclipse Public License from
+ * http://www.opensource.org/licenses/eclipse-1.0.php
+ *
+ * @author       Federico Martin Casares (warptrosse@gmail.com)
+ *
+ * @contributors
+ *
+ * @description Text parsing.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <limits.h>
+#include <sys/socket.h>
+
+#include "OSBase_Parse.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TABLES
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Value plus one of every hex digit (0 = not a hex digit).
+ */
+static const unsigned char nlParseHex[256] = {
+    ['0'] = 1,  ['1'] = 2,  ['2'] = 3,  ['3'] = 4,  ['4'] = 5,
+    ['5'] = 6,  ['6'] = 7,  ['7'] = 8,  ['8'] = 9,  ['9'] = 10,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TEXT PARSING
+////////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------------------
+int nlParseIPv4(const char *s, size_t len, unsigned char *addr)
+{
+    const char   *end    = s + len; // End of the text.
+    unsigned int  val    = 0;       // Current octet value.
+    int           digits = 0;       // Digits of the current octet.
+    int           octets = 0;       // Octets seen.
+
+    for( ; s < end ; s++) {
+        if(*s >= '0' && *s <= '9') {
+            // No leading zeros, as inet_pton.
+            if(digits > 0 && val == 0) {
+                return 0;
+            }
+            val = val * 10 + (*s - '0');
+            if(val > 255) {
+                return 0;
+            }
+            if(digits++ == 0 && ++octets > 4) {
+                return 0;
+            }
+        } else if(*s == '.' && digits > 0 && octets < 4) {
+            addr[octets-1] = (unsigned char)val;
+            val = 0;
+            digits = 0;
+        } else {
+            return 0;
+        }
+    }
+    if(octets < 4 || digits == 0) {
+        return 0;
+    }
+    addr[3] = (unsigned char)val;
+    return 1;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlParseIPv6(const char *s, size_t len, unsigned char *addr)
+{
+    const char    *end    = s + len;   // End of the text.
+    const char    *tok    = NULL;      // Start of the current group.
+    unsigned char *tp     = addr;      // Current output position.
+    unsigned char *endp   = addr + 16; // End of the output.
+    unsigned char *colonp = NULL;      // Position of "::".
+    unsigned int   val    = 0;         // Current group value.
+    int            digits = 0;         // Digits of the current group.
+    int            d      = 0;         // Current digit value.
+    size_t         n      = 0;         // Bytes after "::".
+
+    if(s == end) {
+        return 0;
+    }
+    // A leading ':' must be part of "::".
+    if(*s == ':') {
+        s++;
+        if(s == end || *s != ':') {
+            return 0;
+        }
+    }
+
+    tok = s;
+    while(s < end) {
+        d = nlParseHex[(unsigned char)*s++] - 1;
+        if(d >= 0) {
+            if(digits == 4) {
+                return 0;
+            }
+            val = (val << 4) | d;
+            digits++;
+            continue;
+        }
+        if(s[-1] == ':') {
+            tok = s;
+            if(digits == 0) {
+                if(colonp != NULL) {
+                    return 0;
+                }
+                colonp = tp;
+                continue;
+            } else if(s == end) {
+                return 0;
+            }
+            if(tp + 2 > endp) {
+                return 0;
+            }
+            *tp++ = (unsigned char)(val >> 8);
+            *tp++ = (unsigned char)val;
+            digits = 0;
+            val = 0;
+            continue;
+        }
+        // IPv4 tail: the rest of the text from the current group.
+        if(s[-1] == '.' && tp + 4 <= endp &&
+           nlParseIPv4(tok, end - tok, tp)) {
+            tp += 4;
+            digits = 0;
+            break;
+        }
+        return 0;
+    }
+    if(digits > 0) {
+        if(tp + 2 > endp) {
+            return 0;
+        }
+        *tp++ = (unsigned char)(val >> 8);
+        *tp++ = (unsigned char)val;
+    }
+    if(colonp != NULL) {
+        // "::" must stand for one group at least.
+        if(tp == endp) {
+            return 0;
+        }
+        n = tp - colonp;
+        memmove(endp - n, colonp, n);
+        memset(colonp, 0, endp - n - colonp);
+        tp = endp;
+    }
+    return (tp == endp) ? 1 : 0;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlParseAddr(const char *s, size_t len, unsigned char *addr)
+{
+    size_t i = 0; // Current character.
+
+    // An IPv6 literal has a ':' within its first five characters (a group
+    // has four digits at most), an IPv4 one has none.
+    for(i=0 ; i<len && i<5 ; i++) {
+        if(s[i] == ':') {
+            return nlParseIPv6(s, len, addr) ? AF_INET6 : AF_UNSPEC;
+        }
+    }
+    if(len > 0 && nlParseIPv4(s, len, addr)) {
+        memset(addr + 4, 0, 12);
+        return AF_INET;
+    }
+    return AF_UNSPEC;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+const char* nlParseInt(const char *s, const char *end, int *val)
+{
+    long long v   = 0; // Value.
+    int       neg = 0; // Negative value.
+
+    if(s < end && *s == '-') {
+        neg = 1;
+        s++;
+    }
+    if(s == end || *s < '0' || *s > '9') {
+        return NULL;
+    }
+    for( ; s < end && *s >= '0' && *s <= '9' ; s++) {
+        v = v * 10 + (*s - '0');
+        if(v > (long long)INT_MAX + neg) {
+            return NULL;
+        }
+    }
+    *val = (int)(neg ? -v : v);
+    return s;
+}
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+int nlParseIfIndex(const char *elementName, int *ifindex)
+{
+    const char *sep = NULL; // Last '_'.
+    const char *end = NULL; // End of the ElementName.
+
+    sep = strrchr(elementName, '_');
+    if(sep == NULL || sep == elementName) {
+        return 0;
+    }
+    end = sep + 1 + strlen(sep + 1);
+    if(nlParseInt(sep + 1, end, ifindex) != end) {
+        return 0;
+    }
+    return 1;
+}
+//------------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
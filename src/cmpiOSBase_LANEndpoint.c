@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 
 #include "cmpidt.h"
 #include "cmpimacs.h"
@@ -69,7 +70,7 @@ CMPIObjectPath* _makePath_LANEndpoint(const CMPIBroker *_broker,
     }
 
     CMAddKey(op, "Name", LANEP->name, CMPI_chars);
-    CMAddKey(op, "CreationClassName", LANEP->creationClassName, CMPI_chars);
+    CMAddKey(op, "CreationClassName", CREATION_CLASS_NAME, CMPI_chars);
     CMAddKey(op, "SystemCreationClassName", CSCreationClassName,
              CMPI_chars);
     CMAddKey(op, "SystemName", LANEP->systemName, CMPI_chars);
@@ -80,11 +81,72 @@ CMPIObjectPath* _makePath_LANEndpoint(const CMPIBroker *_broker,
 }
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+/**
+ * CIM properties and their LEP_P_* bit.
+ */
+static const struct {
+    const char   *name; /**< Property name. */
+    unsigned int  prop; /**< LEP_P_* bit. */
+} _propNames[] = {
+    {"AliasAddresses",           LEP_P_ALIAS_ADDRESSES},
+    {"AvailableRequestedStates", LEP_P_AVAIL_REQ_STATES},
+    {"Caption",                  LEP_P_CAPTION},
+    {"CommunicationStatus",      LEP_P_COMMUNICATION_STATUS},
+    {"Description",              LEP_P_DESCRIPTION},
+    {"DetailedStatus",           LEP_P_DETAILED_STATUS},
+    {"ElementName",              LEP_P_ELEMENT_NAME},
+    {"EnabledDefault",           LEP_P_ENABLED_DEFAULT},
+    {"EnabledState",             LEP_P_ENABLED_STATE},
+    {"GroupAddresses",           LEP_P_GROUP_ADDRESSES},
+    {"HealthState",              LEP_P_HEALTH_STATE},
+    {"InstanceID",               LEP_P_INSTANCE_ID},
+    {"LANID",                    LEP_P_LAN_ID},
+    {"MACAddress",               LEP_P_MAC_ADDRESS},
+    {"MaxDataSize",              LEP_P_MAX_DATA_SIZE},
+    {"NameFormat",               LEP_P_NAME_FORMAT},
+    {"OperatingStatus",          LEP_P_OPERATING_STATUS},
+    {"OperationalStatus",        LEP_P_OPERATIONAL_STATUS},
+    {"OtherEnabledState",        LEP_P_OTHER_ENABLED_STATE},
+    {"OtherTypeDescription",     LEP_P_OTHER_TYPE_DESC},
+    {"PrimaryStatus",            LEP_P_PRIMARY_STATUS},
+    {"ProtocolIFType",           LEP_P_PROTOCOL_IF_TYPE},
+    {"RequestedState",           LEP_P_REQUESTED_STATE},
+    {"StatusDescriptions",       LEP_P_STATUS_DESCRIPTIONS},
+    {"TransitioningToState",     LEP_P_TRANSITIONING_STATE},
+};
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+unsigned int _propMask_LANEndpoint(const char **properties)
+{
+    unsigned int props = LEP_P_NONE; // Requested properties.
+    int          i     = 0;          // Property index.
+    unsigned int j     = 0;          // Name index.
+
+    // No property list means every property.
+    if(properties == NULL) {
+        return LEP_P_ALL;
+    }
+
+    for(i=0 ; properties[i]!=NULL ; i++) {
+        for(j=0 ; j<ARRAY_SIZE(_propNames) ; j++) {
+            if(strcasecmp(properties[i], _propNames[j].name) == 0) {
+                props |= _propNames[j].prop;
+                break;
+            }
+        }
+    }
+    return props;
+}
+//------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------------
 CMPIInstance* _makeInst_LANEndpoint(const CMPIBroker *_broker,
                                     const CMPIContext *ctx,
                                     const CMPIObjectPath *cop,
                                     const char **properties,
+                                    unsigned int props,
                                     const struct LANEndpoint *LANEP,
                                     CMPIStatus *rc)
 {
@@ -100,6 +162,9 @@ CMPIInstance* _makeInst_LANEndpoint(const CMPIBroker *_broker,
     CMPIArray       *groupAddr  = NULL; // GroupAddresses.
     CMPIArray       *aliasAddr  = NULL; // AliasAddresses.
     CMPIArray       *avalRS     = NULL; // AvailableRequestedStates.
+    int              i          = 0;    // Array index.
+    char             mac[32];           // MACAddress.
+    char             buf[64];           // ElementName | InstanceID.
 
     // The sblim-cmpi-base package offers some tool methods to get common
     // system datas
@@ -144,88 +209,134 @@ CMPIInstance* _makeInst_LANEndpoint(const CMPIBroker *_broker,
     }
     FREE_SAFE(keys);
 
-    aliasAddr = CMNewArray(_broker, 1, CMPI_chars, rc);
-    if(aliasAddr == NULL) {
-        CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
-                             "Could not create AliasAddresses CMPIArray." );
-        _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
-                          CMGetCharPtr(rc->msg)));
-        goto out;
-    } else {
-        CMSetArrayElementAt(aliasAddr, 0, LANEP->aliasAddresses,
-                            CMPI_chars);
+    // Only the requested properties are set (the keys always are). The
+    // properties that are the same for every LANEndpoint are supplied here,
+    // the others are rendered from the LANEndpoint data.
+    if(props & (LEP_P_MAC_ADDRESS | LEP_P_INSTANCE_ID)) {
+        nlAddr_n2a(LANEP->address, LANEP->addressLen, LANEP->type,
+                   mac, sizeof(mac));
+    }
+
+    // @todo implement. Is this supported on linux?
+    if(props & LEP_P_ALIAS_ADDRESSES) {
+        aliasAddr = CMNewArray(_broker, 1, CMPI_chars, rc);
+        if(aliasAddr == NULL) {
+            CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
+                                 "Could not create AliasAddresses "
+                                 "CMPIArray." );
+            _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
+                              CMGetCharPtr(rc->msg)));
+            goto out;
+        }
+        CMSetArrayElementAt(aliasAddr, 0, "", CMPI_chars);
         CMSetProperty(ci, "AliasAddresses",
                       (CMPIValue*)&(aliasAddr), CMPI_charsA);
     }
 
-    avalRS = CMNewArray(_broker, ARRAY_SIZE(LANEP->availReqStates), CMPI_uint16, rc);
-    if(avalRS == NULL) {
-        CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
-                             "Could not create AvailableRequestedStates CMPIArray." );
-        _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
-                          CMGetCharPtr(rc->msg)));
-        goto out;
-    } else {
-        int i;
-        for(i=0 ; i<ARRAY_SIZE(LANEP->availReqStates) ; i++) {
+    if(props & LEP_P_AVAIL_REQ_STATES) {
+        avalRS = CMNewArray(_broker, LEP_AVAIL_REQ_STATES_MAX,
+                            CMPI_uint16, rc);
+        if(avalRS == NULL) {
+            CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
+                                 "Could not create AvailableRequestedStates "
+                                 "CMPIArray." );
+            _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
+                              CMGetCharPtr(rc->msg)));
+            goto out;
+        }
+        for(i=0 ; i<LEP_AVAIL_REQ_STATES_MAX ; i++) {
             CMSetArrayElementAt(avalRS, i,
-                                (CMPIValue*)&(LANEP->availReqStates[i]),
+                                (CMPIValue*)&(lepAvailReqStates[i]),
                                 CMPI_uint16);
         }
         CMSetProperty(ci, "AvailableRequestedStates",
                       (CMPIValue*)&(avalRS), CMPI_uint16A);
     }
 
-    CMSetProperty(ci, "Caption", LANEP->caption, CMPI_chars);
-    CMSetProperty(ci, "CommunicationStatus",
-                  (CMPIValue*)&(LANEP->communicationStatus), CMPI_uint16);
-    CMSetProperty(ci, "CreationClassName", LANEP->creationClassName,
-                  CMPI_chars);
-    CMSetProperty(ci, "Description", LANEP->description, CMPI_chars);
-    CMSetProperty(ci, "DetailedStatus", (CMPIValue*)&(LANEP->detailedStatus),
-                  CMPI_uint16);
-    CMSetProperty(ci, "ElementName", LANEP->elementName, CMPI_chars);
-    CMSetProperty(ci, "EnabledDefault", (CMPIValue*)&(LANEP->enabledDefault),
-                  CMPI_uint16);
-    CMSetProperty(ci, "EnabledState", (CMPIValue*)&(LANEP->enabledState),
-                  CMPI_uint16);
-
-    groupAddr = CMNewArray(_broker, 1, CMPI_chars, rc);
-    if(groupAddr == NULL) {
-        CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
-                             "Could not create GroupAddresses CMPIArray." );
-        _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
-                          CMGetCharPtr(rc->msg)));
-        goto out;
-    } else {
-        CMSetArrayElementAt(groupAddr, 0, LANEP->groupAddresses,
-                            CMPI_chars);
+    if(props & LEP_P_CAPTION) {
+        CMSetProperty(ci, "Caption", LANENDPOINT_CAPTION, CMPI_chars);
+    }
+    if(props & LEP_P_COMMUNICATION_STATUS) {
+        CMSetProperty(ci, "CommunicationStatus",
+                      (CMPIValue*)&(LANEP->communicationStatus), CMPI_uint16);
+    }
+    CMSetProperty(ci, "CreationClassName", CREATION_CLASS_NAME, CMPI_chars);
+    if(props & LEP_P_DESCRIPTION) {
+        CMSetProperty(ci, "Description", LANENDPOINT_DESC, CMPI_chars);
+    }
+    if(props & LEP_P_DETAILED_STATUS) {
+        CMSetProperty(ci, "DetailedStatus",
+                      (CMPIValue*)&(LANEP->detailedStatus), CMPI_uint16);
+    }
+    if(props & LEP_P_ELEMENT_NAME) {
+        snprintf(buf, sizeof(buf), "%s_%d", LANEP->name, LANEP->index);
+        CMSetProperty(ci, "ElementName", buf, CMPI_chars);
+    }
+    if(props & LEP_P_ENABLED_DEFAULT) {
+        CMSetProperty(ci, "EnabledDefault",
+                      (CMPIValue*)&(LANEP->enabledDefault), CMPI_uint16);
+    }
+    if(props & LEP_P_ENABLED_STATE) {
+        CMSetProperty(ci, "EnabledState", (CMPIValue*)&(LANEP->enabledState),
+                      CMPI_uint16);
+    }
+
+    // @todo implement (use CTRL_ATTR_MCAST_GROUPS).
+    if(props & LEP_P_GROUP_ADDRESSES) {
+        groupAddr = CMNewArray(_broker, 1, CMPI_chars, rc);
+        if(groupAddr == NULL) {
+            CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
+                                 "Could not create GroupAddresses "
+                                 "CMPIArray." );
+            _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
+                              CMGetCharPtr(rc->msg)));
+            goto out;
+        }
+        CMSetArrayElementAt(groupAddr, 0, "", CMPI_chars);
         CMSetProperty(ci, "GroupAddresses",
                       (CMPIValue*)&(groupAddr), CMPI_charsA);
     }
 
-    CMSetProperty(ci, "HealthState", (CMPIValue*)&(LANEP->healthState),
-                  CMPI_uint16);
+    if(props & LEP_P_HEALTH_STATE) {
+        CMSetProperty(ci, "HealthState", (CMPIValue*)&(LANEP->healthState),
+                      CMPI_uint16);
+    }
     // @todo how can obtain installation date form a device?
     // CMSetProperty(ci, "InstallDate", LANEP->, );
-    CMSetProperty(ci, "InstanceID", LANEP->instanceID, CMPI_chars);
-    CMSetProperty(ci, "LANID", LANEP->lanID, CMPI_chars);
-    CMSetProperty(ci, "MACAddress", LANEP->macAddress, CMPI_chars);
-    CMSetProperty(ci, "MaxDataSize", (CMPIValue*)&(LANEP->maxDataSize),
-                  CMPI_uint32);
+    if(props & LEP_P_INSTANCE_ID) {
+        snprintf(buf, sizeof(buf), "%s-%s", LANEP->name, mac);
+        CMSetProperty(ci, "InstanceID", buf, CMPI_chars);
+    }
+    if(props & LEP_P_LAN_ID) {
+        CMSetProperty(ci, "LANID", LANENDPOINT_LAN_ID, CMPI_chars);
+    }
+    if(props & LEP_P_MAC_ADDRESS) {
+        CMSetProperty(ci, "MACAddress", mac, CMPI_chars);
+    }
+    if(props & LEP_P_MAX_DATA_SIZE) {
+        CMSetProperty(ci, "MaxDataSize", (CMPIValue*)&(LANEP->maxDataSize),
+                      CMPI_uint32);
+    }
     CMSetProperty(ci, "Name", LANEP->name, CMPI_chars);
-    CMSetProperty(ci, "NameFormat", LANEP->nameFormat, CMPI_chars);
-    CMSetProperty(ci, "OperatingStatus",
-                  (CMPIValue*)&(LANEP->operatingStatus), CMPI_uint16);
+    if(props & LEP_P_NAME_FORMAT) {
+        CMSetProperty(ci, "NameFormat",
+                      linkTypeName[nlGetLinkTypePos(LANEP->type)], CMPI_chars);
+    }
+    if(props & LEP_P_OPERATING_STATUS) {
+        CMSetProperty(ci, "OperatingStatus",
+                      (CMPIValue*)&(LANEP->operatingStatus), CMPI_uint16);
+    }
 
-    opstatus = CMNewArray(_broker, 1, CMPI_uint16, rc);
-    if(opstatus == NULL) {
-        CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
-                             "Could not create OperationalStatus CMPIArray." );
-        _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
-                          CMGetCharPtr(rc->msg)));
-        goto out;
-    } else {
+    if(props & LEP_P_OPERATIONAL_STATUS) {
+        opstatus = CMNewArray(_broker, 1, CMPI_uint16, rc);
+        if(opstatus == NULL) {
+            CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
+                                 "Could not create OperationalStatus "
+                                 "CMPIArray." );
+            _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
+                              CMGetCharPtr(rc->msg)));
+            goto out;
+        }
         CMSetArrayElementAt(opstatus, 0,
                             (CMPIValue*)&(LANEP->operationalStatus),
                             CMPI_uint16);
@@ -233,27 +344,36 @@ CMPIInstance* _makeInst_LANEndpoint(const CMPIBroker *_broker,
                       (CMPIValue*)&(opstatus), CMPI_uint16A);
     }
 
-    CMSetProperty(ci, "OtherEnabledState", LANEP->otherEnabledState,
-                  CMPI_chars);
-    CMSetProperty(ci, "OtherTypeDescription", LANEP->otherTypeDescription,
-                  CMPI_chars);
-    CMSetProperty(ci, "PrimaryStatus", (CMPIValue*)&(LANEP->primaryStatus),
-                  CMPI_uint16);
-    CMSetProperty(ci, "ProtocolIFType", (CMPIValue*)&(LANEP->protocolIFType),
-                  CMPI_uint16);
-    CMSetProperty(ci, "RequestedState", (CMPIValue*)&(LANEP->requestedState),
-                  CMPI_uint16);
-
-    statusDesc = CMNewArray(_broker, 1, CMPI_chars, rc);
-    if(statusDesc == NULL) {
-        CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
-                             "Could not create StatusDescriptions CMPIArray." );
-        _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
-                          CMGetCharPtr(rc->msg)));
-        goto out;
-    } else {
-        CMSetArrayElementAt(statusDesc, 0, LANEP->statusDescriptions,
-                            CMPI_chars);
+    if(props & LEP_P_OTHER_ENABLED_STATE) {
+        CMSetProperty(ci, "OtherEnabledState", "", CMPI_chars);
+    }
+    if(props & LEP_P_OTHER_TYPE_DESC) {
+        CMSetProperty(ci, "OtherTypeDescription", "", CMPI_chars);
+    }
+    if(props & LEP_P_PRIMARY_STATUS) {
+        CMSetProperty(ci, "PrimaryStatus",
+                      (CMPIValue*)&(LANEP->primaryStatus), CMPI_uint16);
+    }
+    if(props & LEP_P_PROTOCOL_IF_TYPE) {
+        CMSetProperty(ci, "ProtocolIFType",
+                      (CMPIValue*)&(LANEP->protocolIFType), CMPI_uint16);
+    }
+    if(props & LEP_P_REQUESTED_STATE) {
+        CMSetProperty(ci, "RequestedState",
+                      (CMPIValue*)&(LANEP->requestedState), CMPI_uint16);
+    }
+
+    if(props & LEP_P_STATUS_DESCRIPTIONS) {
+        statusDesc = CMNewArray(_broker, 1, CMPI_chars, rc);
+        if(statusDesc == NULL) {
+            CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
+                                 "Could not create StatusDescriptions "
+                                 "CMPIArray." );
+            _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() failed: %s",
+                              CMGetCharPtr(rc->msg)));
+            goto out;
+        }
+        CMSetArrayElementAt(statusDesc, 0, "", CMPI_chars);
         CMSetProperty(ci, "StatusDescriptions",
                       (CMPIValue*)&(statusDesc), CMPI_charsA);
     }
@@ -263,8 +383,10 @@ CMPIInstance* _makeInst_LANEndpoint(const CMPIBroker *_broker,
     CMSetProperty(ci, "SystemName", LANEP->systemName, CMPI_chars);
     // @todo How can obtain device last change?.
     // CMSetProperty(ci, "TimeOfLastStateChange", LANEP->, );
-    CMSetProperty(ci, "TransitioningToState",
-                  (CMPIValue*)&(LANEP->transitioningToState), CMPI_uint16);
+    if(props & LEP_P_TRANSITIONING_STATE) {
+        CMSetProperty(ci, "TransitioningToState",
+                      (CMPIValue*)&(LANEP->transitioningToState), CMPI_uint16);
+    }
 
  out:
     _OSBASE_TRACE(2, ("--- _makeInst_LANEndpoint() exited"));
@@ -57,6 +57,8 @@ CMPIStatus OSBase_LANEndpointProviderCleanup(CMPIInstanceMI *mi,
 {
     _OSBASE_TRACE(1, ("--- %s CMPI Cleanup() called", _ClassName));
 
+    cleanupLANEndpoints();
+
     CMReturn(CMPI_RC_OK);
 
     _OSBASE_TRACE(1, ("--- %s CMPI Cleanup() exited", _ClassName));
@@ -72,14 +74,17 @@ CMPIStatus OSBase_LANEndpointProviderEnumInstanceNames(CMPIInstanceMI *mi,
     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstanceNames() called", _ClassName));
 
     CMPIObjectPath         *op    = NULL;               // Object path instance.
+    struct nlArena          arena;                      // Request memory.
     struct LANEndpointList *list  = NULL;               // LANEndpoint list.
     struct LANEndpointList *lptr  = NULL;               // Current position in
                                                         // the list.
     CMPIStatus              rc    = {CMPI_RC_OK, NULL}; // Return status of
                                                         // CIM operations.
 
+    nlArenaInit(&arena);
+
     // Get links.
-    if(getALLLANEndpoints(&list) != LEP_OK) {
+    if(getALLLANEndpoints(&arena, &list, LEP_P_NONE) != LEP_OK) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
                              "Could not list LANEndpoints.");
         _OSBASE_TRACE(1, ("--- %s CMPI EnumInstanceNames() failed: %s",
@@ -114,8 +119,7 @@ CMPIStatus OSBase_LANEndpointProviderEnumInstanceNames(CMPIInstanceMI *mi,
     }
 
  out:
-    freeLANEndpointList(lptr);
-    freeLANEndpointList(list);
+    nlArenaRelease(&arena);
     CMReturnDone(rslt);
 
     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstanceNames() exited", _ClassName));
@@ -133,14 +137,20 @@ CMPIStatus OSBase_LANEndpointProviderEnumInstances(CMPIInstanceMI *mi,
     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() called", _ClassName));
 
     CMPIInstance           *ci    = NULL;               // Class instance.
+    struct nlArena          arena;                      // Request memory.
     struct LANEndpointList *list  = NULL;               // LANEndpoint list.
+    unsigned int            props = LEP_P_ALL;          // Requested
+                                                        // properties.
     struct LANEndpointList *lptr  = NULL;               // Current position in
                                                         // the list.
     CMPIStatus              rc    = {CMPI_RC_OK, NULL}; // Return status of
                                                         // CIM operations.
 
+    nlArenaInit(&arena);
+    props = _propMask_LANEndpoint(properties);
+
     // Get links.
-    if(getALLLANEndpoints(&list) != LEP_OK) {
+    if(getALLLANEndpoints(&arena, &list, props) != LEP_OK) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
                              "Could not list LANEndpoints.");
         _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() failed: %s",
@@ -155,7 +165,7 @@ CMPIStatus OSBase_LANEndpointProviderEnumInstances(CMPIInstanceMI *mi,
     while(lptr != NULL && rc.rc == CMPI_RC_OK) {
         if(lptr->sptr != NULL) {
             ci = _makeInst_LANEndpoint(_broker, ctx, ref, properties,
-                                       lptr->sptr, &rc);
+                                       props, lptr->sptr, &rc);
             if((ci == NULL) || (rc.rc != CMPI_RC_OK)) {
                 if(rc.msg != NULL) {
                     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() failed: %s",
@@ -175,8 +185,7 @@ CMPIStatus OSBase_LANEndpointProviderEnumInstances(CMPIInstanceMI *mi,
     }
 
  out:
-    freeLANEndpointList(lptr);
-    freeLANEndpointList(list);
+    nlArenaRelease(&arena);
     CMReturnDone(rslt);
 
     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() exited", _ClassName));
@@ -196,10 +205,16 @@ CMPIStatus OSBase_LANEndpointProviderGetInstance(CMPIInstanceMI *mi,
     CMPIInstance           *ci    = NULL;               // Class instance.
     CMPIData                data;                       // CIM datum to extract
                                                         // property values.
+    struct nlArena          arena;                      // Request memory.
     struct LANEndpointList *list  = NULL;               // LANEndpoint list.
+    unsigned int            props = LEP_P_ALL;          // Requested
+                                                        // properties.
     CMPIStatus              rc    = {CMPI_RC_OK, NULL}; // Return status of
                                                         // CIM operations.
 
+    nlArenaInit(&arena);
+    props = _propMask_LANEndpoint(properties);
+
     // Get Name.
     data = CMGetKey(cop, "Name", &rc);
     if((rc.rc != CMPI_RC_OK) || (CMIsNullValue(data)) ||
@@ -212,7 +227,9 @@ CMPIStatus OSBase_LANEndpointProviderGetInstance(CMPIInstanceMI *mi,
     }
 
     // Get link info.
-    if((getLANEndpoint(&list, CMGetCharPtr(data.value.string)) != LEP_OK) ||
+    if((getLANEndpoint(&arena, &list,
+                       CMGetCharPtr(data.value.string),
+                       props) != LEP_OK) ||
        (list == NULL)) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_NOT_FOUND,
                              "LANEndpoint does not exist.");
@@ -222,7 +239,7 @@ CMPIStatus OSBase_LANEndpointProviderGetInstance(CMPIInstanceMI *mi,
     }
 
     // Create new instance.
-    ci = _makeInst_LANEndpoint(_broker, ctx, cop, properties,
+    ci = _makeInst_LANEndpoint(_broker, ctx, cop, properties, props,
                                list->sptr, &rc);
     if(ci == NULL) {
         if(rc.msg != NULL) {
@@ -237,7 +254,7 @@ CMPIStatus OSBase_LANEndpointProviderGetInstance(CMPIInstanceMI *mi,
     CMReturnInstance(rslt, ci);
 
  out:
-    freeLANEndpointList(list);
+    nlArenaRelease(&arena);
     CMReturnDone(rslt);
 
     _OSBASE_TRACE(1, ("--- %s CMPI GetInstance() exited", _ClassName));
@@ -340,6 +357,8 @@ CMPIStatus OSBase_LANEndpointProviderMethodCleanup(CMPIMethodMI *mi,
 {
     _OSBASE_TRACE(1, ("--- %s CMPI MethodCleanup() called", _ClassName));
 
+    cleanupLANEndpoints();
+
     CMReturn(CMPI_RC_OK);
 
     _OSBASE_TRACE(1, ("--- %s CMPI MethodCleanup() exited", _ClassName));
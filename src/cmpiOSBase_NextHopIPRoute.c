@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 
 #include "cmpidt.h"
 #include "cmpimacs.h"
@@ -40,12 +41,14 @@
 CMPIObjectPath* _makePath_NextHopIPRoute(const CMPIBroker *_broker,
                                          const CMPIContext *ctx,
                                          const CMPIObjectPath *cop,
-                                         const struct nextHopIP *pNHop,
+                                         const struct nhConv *conv,
+                                         const struct nlRoute *route,
                                          CMPIStatus *rc)
 {
     _OSBASE_TRACE(2, ("--- _makePath_NextHopIPRoute() called"));
 
-    CMPIObjectPath *op = NULL; // ObjectPath to return.
+    CMPIObjectPath   *op = NULL; // ObjectPath to return.
+    struct nextHopIP  nHop;      // Route in CIM format.
 
     // The sblim-cmpi-base package offers some tool methods to get common
     // system datas
@@ -68,7 +71,16 @@ CMPIObjectPath* _makePath_NextHopIPRoute(const CMPIBroker *_broker,
         goto out;
     }
 
-    CMAddKey(op, "InstanceID", pNHop->instanceID, CMPI_chars);
+    // Only the key is rendered.
+    if(nlRouteTOnh(conv, route, &nHop, NH_P_NONE) != NH_OK) {
+        CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
+                             "Could not render route.");
+        _OSBASE_TRACE(2, ("--- _makePath_NextHopIPRoute() failed: %s",
+                          CMGetCharPtr(rc->msg)));
+        op = NULL;
+        goto out;
+    }
+    CMAddKey(op, "InstanceID", nHop.instanceID, CMPI_chars);
 
  out:
     _OSBASE_TRACE(2, ("--- _makePath_NextHopIPRoute() exited"));
@@ -76,21 +88,77 @@ CMPIObjectPath* _makePath_NextHopIPRoute(const CMPIBroker *_broker,
 }
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+/**
+ * CIM properties and their NH_P_* bit.
+ */
+static const struct {
+    const char   *name; /**< Property name. */
+    unsigned int  prop; /**< NH_P_* bit. */
+} _propNames[] = {
+    {"AddressType",         NH_P_ADDRESS_TYPE},
+    {"AdminDistance",       NH_P_ADMIN_DISTANCE},
+    {"Caption",             NH_P_CAPTION},
+    {"Description",         NH_P_DESCRIPTION},
+    {"DestinationAddress",  NH_P_DST_ADDRESS},
+    {"DestinationMask",     NH_P_DST_MASK},
+    {"ElementName",         NH_P_ELEMENT_NAME},
+    {"IsStatic",            NH_P_IS_STATIC},
+    {"OtherDerivation",     NH_P_OTHER_DERIVATION},
+    {"PrefixLength",        NH_P_PREFIX_LENGTH},
+    {"RouteDerivation",     NH_P_ROUTE_DERIVATION},
+    {"RouteGateway",        NH_P_ROUTE_GATEWAY},
+    {"RouteMetric",         NH_P_ROUTE_METRIC},
+    {"RouteOutputIf",       NH_P_ROUTE_OUTPUT_IF},
+    {"RouteScope",          NH_P_ROUTE_SCOPE},
+    {"RouteTable",          NH_P_ROUTE_TABLE},
+    {"RouteType",           NH_P_ROUTE_TYPE},
+    {"TypeOfRoute",         NH_P_TYPE_OF_ROUTE},
+};
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+unsigned int _propMask_NextHopIPRoute(const char **properties)
+{
+    unsigned int props = NH_P_NONE; // Requested properties.
+    int          i     = 0;         // Property index.
+    unsigned int j     = 0;         // Name index.
+
+    // No property list means every property.
+    if(properties == NULL) {
+        return NH_P_ALL;
+    }
+
+    for(i=0 ; properties[i]!=NULL ; i++) {
+        for(j=0 ; j<ARRAY_SIZE(_propNames) ; j++) {
+            if(strcasecmp(properties[i], _propNames[j].name) == 0) {
+                props |= _propNames[j].prop;
+                break;
+            }
+        }
+    }
+    return props;
+}
+//------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------------
 CMPIInstance* _makeInst_NextHopIPRoute(const CMPIBroker* _broker,
                                        const CMPIContext* ctx,
                                        const CMPIObjectPath* cop,
                                        const char** properties,
-                                       const struct nextHopIP* pNHop,
+                                       unsigned int props,
+                                       const struct nhConv* conv,
+                                       const struct nlRoute* route,
                                        CMPIStatus* rc)
 {
     _OSBASE_TRACE(2, ("--- _makeInst_NextHopIPRoute() called"));
 
-    CMPIObjectPath  *op       = NULL; // Instance op.
-    CMPIInstance    *ci       = NULL; // Instance to return.
-    const char     **keys     = NULL; // Keys of the instances.
-    int              keyCount = 0;    // Temporary counter.
-    unsigned short   status   = 2;    // Enabled.
+    CMPIObjectPath    *op       = NULL; // Instance op.
+    CMPIInstance      *ci       = NULL; // Instance to return.
+    const char       **keys     = NULL; // Keys of the instances.
+    int                keyCount = 0;    // Temporary counter.
+    unsigned short     status   = 2;    // Enabled.
+    struct nextHopIP   nHop;            // Route in CIM format.
 
     // The sblim-cmpi-base package offers some tool methods to get common
     // system datas
@@ -132,35 +200,84 @@ CMPIInstance* _makeInst_NextHopIPRoute(const CMPIBroker* _broker,
     }
     FREE_SAFE(keys);
 
-    CMSetProperty(ci, "AddressType", (CMPIValue*)&(pNHop->addressType),
-                  CMPI_uint16);
-    CMSetProperty(ci, "AdminDistance", (CMPIValue*)&(pNHop->adminDistance),
-                  CMPI_uint16);
-    CMSetProperty(ci, "Caption", pNHop->caption, CMPI_chars);
-    CMSetProperty(ci, "Description", pNHop->description, CMPI_chars);
-    CMSetProperty(ci, "DestinationAddress", pNHop->dstAddress, CMPI_chars);
-    CMSetProperty(ci, "DestinationMask", pNHop->dstMask, CMPI_chars);
-    CMSetProperty(ci, "ElementName", pNHop->elementName, CMPI_chars);
-    CMSetProperty(ci, "InstanceID", pNHop->instanceID, CMPI_chars);
-    CMSetProperty(ci, "IsStatic", (CMPIValue*)&(pNHop->isStatic), CMPI_boolean);
-    CMSetProperty(ci, "OtherDerivation", pNHop->otherDerivation, CMPI_chars);
-    CMSetProperty(ci, "PrefixLength", (CMPIValue*)&(pNHop->prefixLength),
-                  CMPI_uint8);
-    CMSetProperty(ci, "RouteDerivation", (CMPIValue*)&(pNHop->routeDerivation),
-                  CMPI_uint16);
-    CMSetProperty(ci, "RouteGateway", pNHop->routeGateway, CMPI_chars);
-    CMSetProperty(ci, "RouteMetric", (CMPIValue*)&(pNHop->routeMetric),
-                  CMPI_uint16);
-    CMSetProperty(ci, "RouteOutputIf", (CMPIValue*)&(pNHop->routeOutputIf),
-                  CMPI_uint16);
-    CMSetProperty(ci, "RouteScope", (CMPIValue*)&(pNHop->routeScope),
-                  CMPI_uint16);
-    CMSetProperty(ci, "RouteTable", (CMPIValue*)&(pNHop->routeTable),
-                  CMPI_uint16);
-    CMSetProperty(ci, "RouteType", (CMPIValue*)&(pNHop->routeType),
-                  CMPI_uint16);
-    CMSetProperty(ci, "TypeOfRoute", (CMPIValue*)&(pNHop->typeOfRoute),
-                  CMPI_uint16);
+    // Render the requested properties of the route.
+    if(nlRouteTOnh(conv, route, &nHop, props) != NH_OK) {
+        CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
+                             "Could not render route.");
+        _OSBASE_TRACE(2, ("--- _makeInst_NextHopIPRoute() failed: %s",
+                          CMGetCharPtr(rc->msg)));
+        ci = NULL;
+        goto out;
+    }
+
+    // Only the requested properties are set (the key always is).
+    if(props & NH_P_ADDRESS_TYPE) {
+        CMSetProperty(ci, "AddressType", (CMPIValue*)&(nHop.addressType),
+                      CMPI_uint16);
+    }
+    if(props & NH_P_ADMIN_DISTANCE) {
+        CMSetProperty(ci, "AdminDistance", (CMPIValue*)&(nHop.adminDistance),
+                      CMPI_uint16);
+    }
+    if(props & NH_P_CAPTION) {
+        CMSetProperty(ci, "Caption", nHop.caption, CMPI_chars);
+    }
+    if(props & NH_P_DESCRIPTION) {
+        CMSetProperty(ci, "Description", nHop.description, CMPI_chars);
+    }
+    if(props & NH_P_DST_ADDRESS) {
+        CMSetProperty(ci, "DestinationAddress", nHop.dstAddress, CMPI_chars);
+    }
+    if(props & NH_P_DST_MASK) {
+        CMSetProperty(ci, "DestinationMask", nHop.dstMask, CMPI_chars);
+    }
+    if(props & NH_P_ELEMENT_NAME) {
+        CMSetProperty(ci, "ElementName", nHop.elementName, CMPI_chars);
+    }
+    CMSetProperty(ci, "InstanceID", nHop.instanceID, CMPI_chars);
+    if(props & NH_P_IS_STATIC) {
+        CMSetProperty(ci, "IsStatic", (CMPIValue*)&(nHop.isStatic),
+                      CMPI_boolean);
+    }
+    if(props & NH_P_OTHER_DERIVATION) {
+        CMSetProperty(ci, "OtherDerivation", nHop.otherDerivation,
+                      CMPI_chars);
+    }
+    if(props & NH_P_PREFIX_LENGTH) {
+        CMSetProperty(ci, "PrefixLength", (CMPIValue*)&(nHop.prefixLength),
+                      CMPI_uint8);
+    }
+    if(props & NH_P_ROUTE_DERIVATION) {
+        CMSetProperty(ci, "RouteDerivation",
+                      (CMPIValue*)&(nHop.routeDerivation), CMPI_uint16);
+    }
+    if(props & NH_P_ROUTE_GATEWAY) {
+        CMSetProperty(ci, "RouteGateway", nHop.routeGateway, CMPI_chars);
+    }
+    if(props & NH_P_ROUTE_METRIC) {
+        CMSetProperty(ci, "RouteMetric", (CMPIValue*)&(nHop.routeMetric),
+                      CMPI_uint16);
+    }
+    if(props & NH_P_ROUTE_OUTPUT_IF) {
+        CMSetProperty(ci, "RouteOutputIf", (CMPIValue*)&(nHop.routeOutputIf),
+                      CMPI_uint16);
+    }
+    if(props & NH_P_ROUTE_SCOPE) {
+        CMSetProperty(ci, "RouteScope", (CMPIValue*)&(nHop.routeScope),
+                      CMPI_uint16);
+    }
+    if(props & NH_P_ROUTE_TABLE) {
+        CMSetProperty(ci, "RouteTable", (CMPIValue*)&(nHop.routeTable),
+                      CMPI_uint16);
+    }
+    if(props & NH_P_ROUTE_TYPE) {
+        CMSetProperty(ci, "RouteType", (CMPIValue*)&(nHop.routeType),
+                      CMPI_uint16);
+    }
+    if(props & NH_P_TYPE_OF_ROUTE) {
+        CMSetProperty(ci, "TypeOfRoute", (CMPIValue*)&(nHop.typeOfRoute),
+                      CMPI_uint16);
+    }
 
  out:
     _OSBASE_TRACE(2, ("--- _makeInst_NextHopIPRoute() exited"));
@@ -76,6 +76,8 @@ CMPIStatus OSBase_NextHopIPRouteProviderCleanup(CMPIInstanceMI *mi,
 {
     _OSBASE_TRACE(1, ("--- %s CMPI Cleanup() called", _ClassName));
 
+    cleanupIPRoutes();
+
     CMReturn(CMPI_RC_OK);
 
     _OSBASE_TRACE(1, ("--- %s CMPI Cleanup() exited", _ClassName));
@@ -91,14 +93,18 @@ CMPIStatus OSBase_NextHopIPRouteProviderEnumInstanceNames(CMPIInstanceMI *mi,
     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstanceNames() called", _ClassName));
 
     CMPIObjectPath       *op    = NULL;               // Object path instance.
-    struct nextHopIPList *list  = NULL;               // NextHopIP list.
-    struct nextHopIPList *lptr  = NULL;               // Current position in the
+    struct nlArena        arena;                      // Request memory.
+    struct nhConv         conv;                       // Conversion context.
+    struct nlRouteList   *list  = NULL;               // Routes list.
+    struct nlRouteList   *lptr  = NULL;               // Current position in the
                                                       // list.
     CMPIStatus            rc    = {CMPI_RC_OK, NULL}; // Return status of CIM
                                                       // operations.
 
+    nlArenaInit(&arena);
+
     // Get routes.
-    if(getAllIPRoutes(&list) != NH_OK) {
+    if(getAllIPRoutes(&arena, &list) != NH_OK) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
                              "Could not list nextHot ip routes.");
         _OSBASE_TRACE(1, ("--- %s CMPI EnumInstanceNames() failed: %s",
@@ -106,13 +112,23 @@ CMPIStatus OSBase_NextHopIPRouteProviderEnumInstanceNames(CMPIInstanceMI *mi,
         goto out;
     }
 
+    // What every route needs to be rendered is resolved once.
+    if(nhConvInit(&conv, &arena, NH_P_NONE) != NH_OK) {
+        CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
+                             "Could not create conversion context.");
+        _OSBASE_TRACE(1, ("--- %s CMPI EnumInstanceNames() failed: %s",
+                          _ClassName, CMGetCharPtr(rc.msg)));
+        goto out;
+    }
+
     // Put pointer to the begining of the list.
     lptr = list;
 
     // Iterate routes list.
     while(lptr != NULL && rc.rc == CMPI_RC_OK) {
         if(lptr->sptr != NULL) {
-            op = _makePath_NextHopIPRoute(_broker, ctx, ref, lptr->sptr, &rc);
+            op = _makePath_NextHopIPRoute(_broker, ctx, ref, &conv,
+                                          lptr->sptr, &rc);
             if((op == NULL) || (rc.rc != CMPI_RC_OK)) {
                 if(rc.msg != NULL) {
                     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstanceNames() " \
@@ -133,8 +149,7 @@ CMPIStatus OSBase_NextHopIPRouteProviderEnumInstanceNames(CMPIInstanceMI *mi,
     }
 
  out:
-    freeNextHopIPList(lptr);
-    freeNextHopIPList(list);
+    nlArenaRelease(&arena);
     CMReturnDone(rslt);
 
     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstanceNames() exited", _ClassName));
@@ -152,14 +167,21 @@ CMPIStatus OSBase_NextHopIPRouteProviderEnumInstances(CMPIInstanceMI *mi,
     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() called", _ClassName));
 
     CMPIInstance         *ci    = NULL;               // Class instance.
-    struct nextHopIPList *list  = NULL;               // NextHopIP list.
-    struct nextHopIPList *lptr  = NULL;               // Current position
+    struct nlArena        arena;                      // Request memory.
+    struct nhConv         conv;                       // Conversion context.
+    unsigned int          props = NH_P_ALL;           // Requested
+                                                      // properties.
+    struct nlRouteList   *list  = NULL;               // Routes list.
+    struct nlRouteList   *lptr  = NULL;               // Current position
                                                       // in the list.
     CMPIStatus            rc    = {CMPI_RC_OK, NULL}; // Return status of CIM
                                                       // operations.
 
+    nlArenaInit(&arena);
+    props = _propMask_NextHopIPRoute(properties);
+
     // Get routes.
-    if(getAllIPRoutes(&list) != NH_OK) {
+    if(getAllIPRoutes(&arena, &list) != NH_OK) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
                              "Could not list nextHot ip routes.");
         _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() failed: %s",
@@ -167,6 +189,15 @@ CMPIStatus OSBase_NextHopIPRouteProviderEnumInstances(CMPIInstanceMI *mi,
         goto out;
     }
 
+    // What every route needs to be rendered is resolved once.
+    if(nhConvInit(&conv, &arena, props) != NH_OK) {
+        CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
+                             "Could not create conversion context.");
+        _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() failed: %s",
+                          _ClassName, CMGetCharPtr(rc.msg)));
+        goto out;
+    }
+
     // Put pointer to the begining of the list.
     lptr = list;
 
@@ -174,7 +205,7 @@ CMPIStatus OSBase_NextHopIPRouteProviderEnumInstances(CMPIInstanceMI *mi,
     while(lptr != NULL && rc.rc == CMPI_RC_OK) {
         if(lptr->sptr != NULL) {
             ci = _makeInst_NextHopIPRoute(_broker, ctx, ref, properties,
-                                          lptr->sptr, &rc);
+                                          props, &conv, lptr->sptr, &rc);
             if((ci == NULL) || (rc.rc != CMPI_RC_OK)) {
                 if(rc.msg != NULL) {
                     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() failed: %s",
@@ -194,8 +225,7 @@ CMPIStatus OSBase_NextHopIPRouteProviderEnumInstances(CMPIInstanceMI *mi,
     }
 
  out:
-    freeNextHopIPList(lptr);
-    freeNextHopIPList(list);
+    nlArenaRelease(&arena);
     CMReturnDone(rslt);
 
     _OSBASE_TRACE(1, ("--- %s CMPI EnumInstances() exited", _ClassName));
@@ -215,10 +245,17 @@ CMPIStatus OSBase_NextHopIPRouteProviderGetInstance(CMPIInstanceMI *mi,
     CMPIInstance         *ci    = NULL;               // Class instance.
     CMPIData              data;                       // CIM datum to extract
                                                       // property values.
-    struct nextHopIPList *list  = NULL;               // NextHopIP list.
+    struct nlArena        arena;                      // Request memory.
+    struct nhConv         conv;                       // Conversion context.
+    unsigned int          props = NH_P_ALL;           // Requested
+                                                      // properties.
+    struct nlRouteList   *list  = NULL;               // Routes list.
     CMPIStatus            rc    = {CMPI_RC_OK, NULL}; // Return status of
                                                       // CIM operations.
 
+    nlArenaInit(&arena);
+    props = _propMask_NextHopIPRoute(properties);
+
     // Get instanceId.
     data = CMGetKey(cop, "InstanceId", &rc);
     if((rc.rc != CMPI_RC_OK) || (CMIsNullValue(data)) ||
@@ -231,7 +268,8 @@ CMPIStatus OSBase_NextHopIPRouteProviderGetInstance(CMPIInstanceMI *mi,
     }
 
     // Get route info.
-    if((getIPRouteIId(&list, CMGetCharPtr(data.value.string)) != NH_OK) ||
+    if((getIPRouteIId(&arena, &list,
+                      CMGetCharPtr(data.value.string)) != NH_OK) ||
        (list == NULL)) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_NOT_FOUND,
                              "NextHopIP does not exist.");
@@ -240,9 +278,20 @@ CMPIStatus OSBase_NextHopIPRouteProviderGetInstance(CMPIInstanceMI *mi,
         goto out;
     }
 
+    // What every route needs to be rendered is resolved once. The
+    // InstanceID is answered in the format the client sent.
+    if((nhConvInit(&conv, &arena, props) != NH_OK) ||
+       (nhConvIIdFormat(&conv, CMGetCharPtr(data.value.string)) != NH_OK)) {
+        CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
+                             "Could not create conversion context.");
+        _OSBASE_TRACE(1, ("--- %s CMPI GetInstance() failed: %s",
+                          _ClassName, CMGetCharPtr(rc.msg)));
+        goto out;
+    }
+
     // Create new instance.
-    ci = _makeInst_NextHopIPRoute(_broker, ctx, cop, properties,
-                                  list->sptr, &rc);
+    ci = _makeInst_NextHopIPRoute(_broker, ctx, cop, properties, props,
+                                  &conv, list->sptr, &rc);
     if(ci == NULL) {
         if(rc.msg != NULL) {
             _OSBASE_TRACE(1, ("--- %s CMPI GetInstance() failed: %s",
@@ -256,7 +305,7 @@ CMPIStatus OSBase_NextHopIPRouteProviderGetInstance(CMPIInstanceMI *mi,
     CMReturnInstance(rslt, ci);
 
  out:
-    freeNextHopIPList(list);
+    nlArenaRelease(&arena);
     CMReturnDone(rslt);
 
     _OSBASE_TRACE(1, ("--- %s CMPI GetInstance() exited", _ClassName));
@@ -326,23 +375,29 @@ CMPIStatus OSBase_NextHopIPRouteProviderSetInstance(CMPIInstanceMI *mi,
 
     _OSBASE_TRACE(1, ("--- %s CMPI SetInstance() called", _ClassName));
 
+    struct nlArena        arena;                        // Request memory.
+    struct nhConv         conv;                         // Conversion
+                                                        // context.
     struct nextHopIP     *nHopIP = NULL;                // Route to be set.
-    struct nextHopIPList *list   = NULL;                // NextHopIP list.
+    struct nextHopIP     *prev   = NULL;                // Current route.
+    struct nlRouteList   *list   = NULL;                // Routes list.
     CMPIData              data;                         // CIM datum to extract
     CMPIStatus            rc     = {CMPI_RC_OK, NULL};  // Return status of
                                                         // CIM operations.
                                                         // property values.
 
-    // Alloc struct.
-    nHopIP = malloc(sizeof(*nHopIP));
-    if(nHopIP == NULL) {
+    nlArenaInit(&arena);
+
+    // Alloc structs.
+    nHopIP = nlArenaAlloc(&arena, sizeof(*nHopIP));
+    prev   = nlArenaAlloc(&arena, sizeof(*prev));
+    if((nHopIP == NULL) || (prev == NULL)) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_NOT_FOUND,
                              "Cannot alloc memory for \'nHopIP\'.");
         _OSBASE_TRACE(1, ("--- %s CMPI SetInstance() failed: %s",
                           _ClassName, CMGetCharPtr(rc.msg)));
         goto out;
     }
-    memset(nHopIP, 0, sizeof(*nHopIP));
 
     // Get instanceId.
     data = CMGetKey(cop, "InstanceId", &rc);
@@ -356,7 +411,8 @@ CMPIStatus OSBase_NextHopIPRouteProviderSetInstance(CMPIInstanceMI *mi,
     }
 
     // Get route info.
-    if((getIPRouteIId(&list, CMGetCharPtr(data.value.string)) != NH_OK) ||
+    if((getIPRouteIId(&arena, &list,
+                      CMGetCharPtr(data.value.string)) != NH_OK) ||
        (list == NULL)) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_NOT_FOUND,
                              "NextHopIP does not exist.");
@@ -365,8 +421,18 @@ CMPIStatus OSBase_NextHopIPRouteProviderSetInstance(CMPIInstanceMI *mi,
         goto out;
     }
 
+    // The current values are the default of the new ones.
+    if((nhConvInit(&conv, &arena, NH_P_ALL) != NH_OK) ||
+       (nlRouteTOnh(&conv, list->sptr, prev, NH_P_ALL) != NH_OK)) {
+        CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
+                             "Could not render NextHopIP.");
+        _OSBASE_TRACE(1, ("--- %s CMPI SetInstance() failed: %s",
+                          _ClassName, CMGetCharPtr(rc.msg)));
+        goto out;
+    }
+
     // Delete route.
-    if(delIPRoute(list->sptr) != NH_OK) {
+    if(delIPRoute(prev) != NH_OK) {
         CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_FAILED,
                              "Could not delete NextHopIP.");
         _OSBASE_TRACE(1, ("--- %s CMPI SetInstance() failed: %s",
@@ -375,7 +441,7 @@ CMPIStatus OSBase_NextHopIPRouteProviderSetInstance(CMPIInstanceMI *mi,
     }
 
     // Get nextHopIP info.
-    rc = getNextHopIPParams(ci, nHopIP, list->sptr);
+    rc = getNextHopIPParams(ci, nHopIP, prev);
     if(rc.rc != CMPI_RC_OK) {
         _OSBASE_TRACE(1, ("--- %s CMPI SetInstance() failed: %s",
                           _ClassName, CMGetCharPtr(rc.msg)));
@@ -392,8 +458,7 @@ CMPIStatus OSBase_NextHopIPRouteProviderSetInstance(CMPIInstanceMI *mi,
     }
 
  out:
-    freeNextHopIPList(list);
-    FREE_SAFE(nHopIP);
+    nlArenaRelease(&arena);
     CMReturnDone(rslt);
 
     _OSBASE_TRACE(1, ("--- %s CMPI SetInstance() exited", _ClassName));
@@ -436,7 +501,8 @@ CMPIStatus OSBase_NextHopIPRouteProviderDeleteInstance(CMPIInstanceMI *mi,
                           _ClassName, CMGetCharPtr(rc.msg)));
         goto out;
     }
-    snprintf(nHopIP->instanceID, 64, "%s", CMGetCharPtr(data.value.string));
+    snprintf(nHopIP->instanceID, sizeof(nHopIP->instanceID), "%s",
+             CMGetCharPtr(data.value.string));
 
     // Delete route.
     if(delIPRoute(nHopIP) != NH_OK) {
@@ -491,6 +557,8 @@ CMPIStatus OSBase_NextHopIPRouteProviderMethodCleanup(CMPIMethodMI *mi,
 {
     _OSBASE_TRACE(1, ("--- %s CMPI MethodCleanup() called", _ClassName));
 
+    cleanupIPRoutes();
+
     CMReturn(CMPI_RC_OK);
 
     _OSBASE_TRACE(1, ("--- %s CMPI MethodCleanup() exited", _ClassName));
@@ -565,14 +633,14 @@ CMPIStatus getNextHopIPParams(const CMPIInstance *ci, struct nextHopIP *nHopIP,
 {
     _OSBASE_TRACE(3, ("--- getNextHopIPParams() called"));
 
-    CMPIData   data;                              // CIM datum to extract
-                                                  // property values.
-    char       addrTypeStr[ADDR_TYPE_STR_MAXLEN]; // Address type (string)
-    char       tmpStr[256];                       // Used to store strings
-                                                  // temporarily.
-    char       ifName[16];                        // Interface name as string.
-    CMPIStatus rc = {CMPI_RC_OK, NULL};           // Return status of CIM
-                                                  // operations.
+    CMPIData      data;                              // CIM datum to extract
+                                                     // property values.
+    char          addrTypeStr[ADDR_TYPE_STR_MAXLEN]; // Address type (string)
+    unsigned char key[NH_IID_KEY_LEN];               // Route key.
+    char          ifName[16];                        // Interface name as
+                                                     // string.
+    CMPIStatus    rc = {CMPI_RC_OK, NULL};           // Return status of CIM
+                                                     // operations.
 
     // dstAddress.
     data = CMGetProperty(ci, "DestinationAddress", &rc);
@@ -902,18 +970,12 @@ CMPIStatus getNextHopIPParams(const CMPIInstance *ci, struct nextHopIP *nHopIP,
 
     // instanceID.
     // This parameter must be autogenerated.
-    gethostname(tmpStr, MAXHOSTNAMELEN);
-    if(nHopIP->addressType == NH_AT_IPV6) {
-        snprintf(nHopIP->instanceID, 64, INSTANCEID_FORMAT,
-                 tmpStr, nHopIP->dstAddress, nHopIP->prefixLength,
-                 nHopIP->routeTable, nHopIP->routeOutputIf,
-                 nHopIP->routeScope, nHopIP->routeGateway);
-    } else {
-        snprintf(nHopIP->instanceID, 64, INSTANCEID_FORMAT,
-                 tmpStr, nHopIP->dstAddress, nHopIP->dstMask,
-                 nHopIP->routeTable, nHopIP->routeOutputIf,
-                 nHopIP->routeScope, nHopIP->routeGateway);
+    if(nhNextHopKey(nHopIP, key) != NH_OK) {
+        CMSetStatusWithChars(_broker, &rc, CMPI_RC_ERR_INVALID_PARAMETER,
+                             "Invalid RouteGateway");
+        goto out;
     }
+    nhEncodeInstanceId(key, nHopIP->instanceID);
 
  out:
     _OSBASE_TRACE(3, ("--- getNextHopIPParams() exited"));
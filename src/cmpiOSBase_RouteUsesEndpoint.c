@@ -23,12 +23,16 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include <net/if.h>
 
 #include "cmpidt.h"
 #include "cmpimacs.h"
 #include "cmpiOSBase_Common.h"
 #include "OSBase_Common.h"
 #include "OSBase_Netlink.h"
+#include "OSBase_Parse.h"
 #include "cmpiOSBase_RouteUsesEndpoint.h"
 
 
@@ -157,7 +161,12 @@ CMPIStatus* _assoc_get_NextHopRoute_insts(const CMPIBroker *_broker,
     }
 
     // Get interface index.
-    sscanf(CMGetCharPtr(data.value.string), "%*[^_]_%d", &ifindex);
+    if(!nlParseIfIndex(CMGetCharPtr(data.value.string), &ifindex)) {
+        _OSBASE_TRACE(2, ("--- _assoc_get_NextHopRoute_insts() " \
+                          "no interface index in ElementName %s",
+                          CMGetCharPtr(data.value.string)));
+        goto out;
+    }
 
     // Create ObjectPath of result class.
     opt = CMNewObjectPath(_broker, CMGetCharPtr(CMGetNameSpace(ref, rc)),
@@ -254,24 +263,14 @@ CMPIStatus* _assoc_get_ProtocolEndpoint_insts(const CMPIBroker *_broker,
 {
     _OSBASE_TRACE(2, ("--- _assoc_get_ProtocolEndpoint_insts() called"));
 
-    CMPIEnumeration *cet          = NULL; // Target class enumeration.
-    CMPIObjectPath  *opt          = NULL; // Target objectPath.
-    CMPIObjectPath  *opit         = NULL; // Target instance objectPath.
-    CMPIData         instData;            // Target instance data.
-    CMPIData         data;                // CIM datum to extract property
-                                          // values.
-    CMPIInstance    *rcit         = NULL; // Result reference instance.
-    CMPIObjectPath  *ropt         = NULL; // Result reference objectPath.
-    int              ifindex;             // Interface index.
-    int              tmpIndex;            // Temp store ifindex of an instance.
-    char             resultClass[256];    // @todo remove.
-
-    // @todo remove this, we should found a better way to handle this.
-    if(strcasecmp(targetClass, _ClassName) == 0) {
-        snprintf(resultClass, 256, "%s", _RefLeftClasses[0]);
-    } else {
-        snprintf(resultClass, 256, "%s", targetClass);
-    }
+    CMPIObjectPath  *opt  = NULL;              // Target objectPath.
+    CMPIInstance    *cit  = NULL;              // Target instance.
+    CMPIData         data;                     // CIM datum to extract
+                                               // property values.
+    CMPIInstance    *rcit = NULL;              // Result reference instance.
+    CMPIObjectPath  *ropt = NULL;              // Result reference objectPath.
+    char             ifName[IF_NAMESIZE];      // Interface name.
+    char             hostName[MAXHOSTNAMELEN]; // HostName of the system.
 
     // Get RouteOutputIf.
     data = CMGetProperty(sourceInst, "RouteOutputIf", rc);
@@ -284,12 +283,20 @@ CMPIStatus* _assoc_get_ProtocolEndpoint_insts(const CMPIBroker *_broker,
         goto out;
     }
 
-    // Get interface index.
-    ifindex = (int)(data.value.uint16);
+    // The route names a single interface: build the key of its LANEndpoint
+    // and get that instance instead of enumerating every LANEndpoint.
+    if(if_indextoname((unsigned int)(data.value.uint16), ifName) == NULL) {
+        _OSBASE_TRACE(2, ("--- _assoc_get_ProtocolEndpoint_insts() " \
+                          "interface %d does not exist",
+                          (int)(data.value.uint16)));
+        goto out;
+    }
+    memset(hostName, 0, sizeof(hostName));
+    gethostname(hostName, MAXHOSTNAMELEN);
 
-    // Create ObjectPath of result class.
+    // Create ObjectPath of result instance.
     opt = CMNewObjectPath(_broker, CMGetCharPtr(CMGetNameSpace(ref,rc)),
-                          resultClass, rc);
+                          _RefLeftClasses[0], rc);
     if(CMIsNullObject(opt)) {
         CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
                              "Create CMPIObjectPath failed.");
@@ -297,74 +304,43 @@ CMPIStatus* _assoc_get_ProtocolEndpoint_insts(const CMPIBroker *_broker,
                           CMGetCharPtr(rc->msg)));
         goto out;
     }
-
-    // Enumerate result instances.
-    cet = CBEnumInstances(_broker, ctx, opt, NULL, rc);
-    if(CMIsNullObject(cet)) {
+    CMAddKey(opt, "Name", ifName, CMPI_chars);
+    CMAddKey(opt, "CreationClassName", _RefLeftClasses[0], CMPI_chars);
+    CMAddKey(opt, "SystemCreationClassName", CSCreationClassName,
+             CMPI_chars);
+    CMAddKey(opt, "SystemName", hostName, CMPI_chars);
+
+    // Get result instance.
+    cit = CBGetInstance(_broker, ctx, opt, NULL, rc);
+    if(CMIsNullObject(cit)) {
+        if(rc->rc == CMPI_RC_ERR_NOT_FOUND) {
+            CMSetStatus(rc, CMPI_RC_OK);
+            goto out;
+        }
         CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
-                             "Could not enumerate result instances.");
+                             "Could not get result instance.");
         _OSBASE_TRACE(2, ("--- _assoc_get_ProtocolEndpoint_insts() failed: %s",
                           CMGetCharPtr(rc->msg)));
         goto out;
     }
 
-    // Retrieve instances.
-    while(CMHasNext(cet, rc)) {
-        instData = CMGetNext(cet, rc);
-        if(CMIsNullObject(instData.value.inst)) {
-            CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
-                                 "Could not retrieve instance from "    \
-                                 "enumeration.");
-            _OSBASE_TRACE(2, ("--- _assoc_get_ProtocolEndpoint_insts() " \
-                              "failed: %s", CMGetCharPtr(rc->msg)));
-            goto out;
-        }
-
-        // Get ElementName.
-        data = CMGetProperty(instData.value.inst, "ElementName", rc);
-        if((rc->rc != CMPI_RC_OK) || (CMIsNullValue(data)) ||
-           (data.type != CMPI_string)) {
-            CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_NO_SUCH_PROPERTY,
-                                 "Cannot determine ElementName");
-            _OSBASE_TRACE(2, ("--- _assoc_get_ProtocolEndpoint_insts() " \
-                              "failed: %s", CMGetCharPtr(rc->msg)));
-            goto out;
-        }
-
-        // Get interface index.
-        sscanf(CMGetCharPtr(data.value.string), "%*[^_]_%d", &tmpIndex);
-
-        if(tmpIndex == ifindex) {
-            // Get objectPath.
-            opit = CMGetObjectPath(instData.value.inst, rc);
-            if(CMIsNullObject(opit)) {
-                CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_FAILED,
-                                     "Could not get objectPath.");
-                _OSBASE_TRACE(2, ("--- _assoc_get_ProtocolEndpoint_insts() " \
-                                  "failed: %s", CMGetCharPtr(rc->msg)));
-                goto out;
-            }
-            CMSetNameSpace(opit, CMGetCharPtr(CMGetNameSpace(ref, rc)));
-
-            if(assocType == ATYPE_ASSOC) { // Associators.
-                CMReturnInstance(rslt, instData.value.inst);
-            } else if(assocType ==  ATYPE_ASSOCN) { // AssociatorNames.
-                CMReturnObjectPath(rslt, opit);
-            } else if(assocType == ATYPE_REFER) { // References.
-                rcit = _makeInst_RouteUsesEndpoint(_broker, ref, opit, rc);
-                CMReturnInstance(rslt, rcit);
-            } else if(assocType == ATYPE_REFERN) { // ReferenceNames.
-                ropt = _makePath_RouteUsesEndpoint(_broker, ref, opit, rc);
-                CMReturnObjectPath(rslt, ropt);
-            } else {
-                CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_NOT_SUPPORTED,
-                                     "Wrong association type or not "   \
-                                     "supported.");
-                _OSBASE_TRACE(2, ("--- _assoc_get_ProtocolEndpoint_insts() "\
-                                  "failed: %s", CMGetCharPtr(rc->msg)));
-                goto out;
-            }
-        }
+    if(assocType == ATYPE_ASSOC) { // Associators.
+        CMReturnInstance(rslt, cit);
+    } else if(assocType ==  ATYPE_ASSOCN) { // AssociatorNames.
+        CMReturnObjectPath(rslt, opt);
+    } else if(assocType == ATYPE_REFER) { // References.
+        rcit = _makeInst_RouteUsesEndpoint(_broker, ref, opt, rc);
+        CMReturnInstance(rslt, rcit);
+    } else if(assocType == ATYPE_REFERN) { // ReferenceNames.
+        ropt = _makePath_RouteUsesEndpoint(_broker, ref, opt, rc);
+        CMReturnObjectPath(rslt, ropt);
+    } else {
+        CMSetStatusWithChars(_broker, rc, CMPI_RC_ERR_NOT_SUPPORTED,
+                             "Wrong association type or not "   \
+                             "supported.");
+        _OSBASE_TRACE(2, ("--- _assoc_get_ProtocolEndpoint_insts() "\
+                          "failed: %s", CMGetCharPtr(rc->msg)));
+        goto out;
     }
 
  out:
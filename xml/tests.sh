@@ -20,6 +20,7 @@ TEST_ORDER=(
     NextHopIPRoute_enumerateInstanceNames
     NextHopIPRoute_enumerateInstances
     NextHopIPRoute_getInstance
+    NextHopIPRoute_getInstance_compact
     NextHopIPRoute_setInstance
     NextHopIPRoute_createInstance
     NextHopIPRoute_deleteInstance